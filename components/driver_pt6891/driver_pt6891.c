@@ -2,14 +2,21 @@
 
 #include <stdio.h>
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
 #include "esp_lcd_panel_interface.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_dev.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_check.h"
+#include "esp_heap_caps.h"
 
 #include "oled_panel_cmds.h"
+#include "pt6891_glass.h"
 
 #define PANEL_WIDTH 95
 #define PANEL_HEIGHT 28
@@ -20,13 +27,51 @@
 #define RAM_END_Y 32
 #define RAM_ROW_LEN (RAM_END_X - RAM_START_X)
 
+#define CLEAR_CHUNK_ROWS 8  // Rows per RAMWR when clearing, 2 KB in RGB565 fits the default SPI max transfer size
+
+#define REG_VAL_UNKNOWN -1
+
+#define SWAP_TILE_SIZE 8
+#define BOUNCE_NUM 2
+
+#define DELTA_WINDOW_COST 16 // Bytes a window costs beyond its pixels: 3 addressed commands, RAMWR and their transaction setup
+
+#define FLUSH_RING_SIZE 4    // Flushes tracked until their last transfer is done
+
+#define FRAME_US_DIV_1 12000  // Frame period at CLK_DIV_1 with the default init when INT is not measured (84 COM lines of ~400 PWMCLK at 3 MHz)
+#define WAKEUP_OSC_US 50      // Oscillator settling after WAKEUP, before any other command
+
+#define GAMMA_LEVELS 64
+
+// Segment currents at full brightness, the white balance of this panel
+#define BRIGHT_WHITE_R 43
+#define BRIGHT_WHITE_G 14
+#define BRIGHT_WHITE_B 26
+
+#define MONO2_PIXEL_BIT(i) (1 << (i)) // 2-Gray byte, P0 is the pixel at the column address
+
 static const char* TAG = "driver_pt6891";
 
+/**
+ * @brief Flush in Flight
+ * 
+ * Transfers of one draw_bitmap, it is done once sealed and no transfer is pending
+ * 
+ */
+typedef struct {
+    int pending;    // Transfers queued and not done yet
+    bool sealed;    // draw_bitmap has queued all its transfers
+} pt6891_flush_t;
+
 typedef struct {
     esp_lcd_panel_t base;
     esp_lcd_panel_io_handle_t panel_io_handle;
     int reset_gpio_num;
     bool reset_level;
+    int int_gpio_num;                   // INT (Frame Sync) GPIO, -1 if not connected
+    TaskHandle_t vsync_task;            // Task blocked in pt6891_wait_vsync, NULL if none
+    volatile int64_t vsync_last_us;     // Time of the last INT edge
+    volatile uint32_t vsync_period_us;  // Filtered frame period, 0 until 2 edges are seen
     int x_gap;
     int y_gap;
     uint8_t fb_bits_per_pixel;
@@ -34,10 +79,77 @@ typedef struct {
     uint8_t colswap_val;// Scan Direction
     uint8_t mirror_val; // Mirror
     uint8_t colmod_val; // Color Mode
+    int row_len_val;    // Last Row Length Written, REG_VAL_UNKNOWN after Reset/Init
+    int com_per_row;    // RAM Rows per Panel Row, MONO_COM_PER_ROW in mono mode
+    uint8_t* bounce[BOUNCE_NUM];  // DMA Buffers holding transposed or expanded pixels, used in turn
+    uint8_t bounce_idx;           // Next bounce buffer to use
+    uint8_t* shadow;                    // Copy of the RAM in panel pixels, NULL if delta flush is off
+    uint32_t shadow_rows_valid;         // Rows of the shadow known to match the RAM
+    bool scrolling;                     // Hardware scroll running, the RAM moves under the shadow
+    uint8_t* delta_bounce[BOUNCE_NUM];  // DMA Buffers holding the changed rectangles, used in turn
+    uint8_t delta_bounce_idx;           // Next delta bounce buffer to use
+    uint64_t delta_bytes_in;            // Pixel bytes given to draw_bitmap with delta flush on
+    uint64_t delta_bytes_sent;          // Pixel bytes actually sent
+    pt6891_flush_done_cb_t flush_done_cb;   // Called once per draw_bitmap, NULL to leave on_color_trans_done to the application
+    void* flush_done_ctx;                   // User context of flush_done_cb
+    pt6891_flush_t flush_ring[FLUSH_RING_SIZE]; // Flushes in flight, oldest at flush_head
+    uint8_t flush_head;                     // Oldest flush not done, written by the transfer done callback
+    uint8_t flush_tail;                     // Flush being queued, written by draw_bitmap
+    portMUX_TYPE flush_lock;                // Guards flush_ring between draw_bitmap and the transfer done callback
+    int clk_div_val;                    // Last Clock Divider Written (1, 2, 4 or 8), REG_VAL_UNKNOWN after Reset/Init
+    bool standby;                       // In standby, the controller only accepts WAKEUP
+    bool disp_on;                       // Display on, standby switches it off and wake-up restores it
+    int brightness_val;                 // Last Brightness Written, REG_VAL_UNKNOWN after Reset/Init
+    int gamma_val;                      // Last Gamma Profile Written, REG_VAL_UNKNOWN after Reset/Init
     const pt6891_oled_init_cmd_t* init_cmds;
     uint16_t init_cmds_size;
 } pt6891_panel_t;
 
+/**
+ * @brief RAM Window
+ * 
+ * One addressed RAMWR burst, a flush is split into at most 2 windows by the gate
+ * 
+ */
+typedef struct {
+    int row;                // RAM Row Address
+    int col;                // RAM Column Address
+    int row_len;            // Row Length (width - 1, width - 8 in 2-Gray mode)
+    const uint8_t* data;    // Pixel data of this window
+    size_t data_bytes;      // The number of bytes in data
+} pt6891_window_t;
+
+/**
+ * @brief Gamma Tables
+ * 
+ * PWM width in PWMCLK of each gray level, peak 250 for all so only the curve changes.
+ * The controller discards a table that does not increase monotonically.
+ * 
+ */
+static const uint8_t gamma_table_1_8[GAMMA_LEVELS] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0D, 0x0F, 0x11, 0x13, 0x16, 0x18, 0x1B, 0x1D, 0x20, 0x23, 0x26, 0x29, 0x2C, 0x30, 0x33, 0x37, 0x3A, 0x3E, 0x42, 0x46, 0x4A, 0x4E, 0x53, 0x57, 0x5C, 0x60, 0x65, 0x6A, 0x6F, 0x74, 0x79, 0x7E, 0x83, 0x89, 0x8E, 0x94, 0x9A, 0x9F, 0xA5, 0xAB, 0xB1, 0xB7, 0xBE, 0xC4, 0xCA, 0xD1, 0xD8, 0xDE, 0xE5, 0xEC, 0xF3, 0xFA
+};
+
+static const uint8_t gamma_table_linear[GAMMA_LEVELS] = {
+    0x00, 0x04, 0x08, 0x0C, 0x10, 0x14, 0x18, 0x1C, 0x20, 0x24, 0x28, 0x2C, 0x30, 0x34, 0x38, 0x3C, 0x3F, 0x43, 0x47, 0x4B, 0x4F, 0x53, 0x57, 0x5B, 0x5F, 0x63, 0x67, 0x6B, 0x6F, 0x73, 0x77, 0x7B, 0x7F, 0x83, 0x87, 0x8B, 0x8F, 0x93, 0x97, 0x9B, 0x9F, 0xA3, 0xA7, 0xAB, 0xAF, 0xB3, 0xB7, 0xBB, 0xBE, 0xC2, 0xC6, 0xCA, 0xCE, 0xD2, 0xD6, 0xDA, 0xDE, 0xE2, 0xE6, 0xEA, 0xEE, 0xF2, 0xF6, 0xFA
+};
+
+static const uint8_t gamma_table_2_2[GAMMA_LEVELS] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x16, 0x19, 0x1B, 0x1E, 0x21, 0x24, 0x27, 0x2A, 0x2D, 0x31, 0x35, 0x38, 0x3C, 0x40, 0x45, 0x49, 0x4E, 0x52, 0x57, 0x5C, 0x61, 0x66, 0x6C, 0x71, 0x77, 0x7D, 0x83, 0x89, 0x90, 0x96, 0x9D, 0xA4, 0xAB, 0xB2, 0xB9, 0xC1, 0xC9, 0xD0, 0xD8, 0xE1, 0xE9, 0xF1, 0xFA
+};
+
+/**
+ * @brief Gamma Profiles
+ * 
+ * [PROFILE][R, G, B]
+ * 
+ */
+static const uint8_t* const gamma_profiles[PT6891_GAMMA_MAX][3] = {
+    [PT6891_GAMMA_DEFAULT] = {gamma_table_1_8, gamma_table_1_8, gamma_table_1_8},
+    [PT6891_GAMMA_LINEAR] = {gamma_table_linear, gamma_table_linear, gamma_table_linear},
+    [PT6891_GAMMA_2_2] = {gamma_table_2_2, gamma_table_2_2, gamma_table_2_2},
+};
+
 static const pt6891_oled_init_cmd_t vendor_init_cmds_default[] = {
     // Software Reset
     {OLED_CMD_SWRST, (uint8_t []) {0x00}, 0, 0},
@@ -48,15 +160,15 @@ static const pt6891_oled_init_cmd_t vendor_init_cmds_default[] = {
     // Color Mode (RGB565)
     {OLED_CMD_COLOR_RGB565, (uint8_t []) {0x00}, 0, 0},
     // Red Gamma Table
-    {OLED_CMD_GAM_RED, (uint8_t []) {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0D, 0x0F, 0x11, 0x13, 0x16, 0x18, 0x1B, 0x1D, 0x20, 0x23, 0x26, 0x29, 0x2C, 0x30, 0x33, 0x37, 0x3A, 0x3E, 0x42, 0x46, 0x4A, 0x4E, 0x53, 0x57, 0x5C, 0x60, 0x65, 0x6A, 0x6F, 0x74, 0x79, 0x7E, 0x83, 0x89, 0x8E, 0x94, 0x9A, 0x9F, 0xA5, 0xAB, 0xB1, 0xB7, 0xBE, 0xC4, 0xCA, 0xD1, 0xD8, 0xDE, 0xE5, 0xEC, 0xF3, 0xFA}, 64, 0},
+    {OLED_CMD_GAM_RED, gamma_table_1_8, GAMMA_LEVELS, 0},
     // Gamma Table Update
     {OLED_CMD_GAM_UPDATE, (uint8_t []) {0x00}, 0, 0},
     // Green Gamma Table
-    {OLED_CMD_GAM_GREEN, (uint8_t []) {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0D, 0x0F, 0x11, 0x13, 0x16, 0x18, 0x1B, 0x1D, 0x20, 0x23, 0x26, 0x29, 0x2C, 0x30, 0x33, 0x37, 0x3A, 0x3E, 0x42, 0x46, 0x4A, 0x4E, 0x53, 0x57, 0x5C, 0x60, 0x65, 0x6A, 0x6F, 0x74, 0x79, 0x7E, 0x83, 0x89, 0x8E, 0x94, 0x9A, 0x9F, 0xA5, 0xAB, 0xB1, 0xB7, 0xBE, 0xC4, 0xCA, 0xD1, 0xD8, 0xDE, 0xE5, 0xEC, 0xF3, 0xFA}, 64, 0},
+    {OLED_CMD_GAM_GREEN, gamma_table_1_8, GAMMA_LEVELS, 0},
     // Gamma Table Update
     {OLED_CMD_GAM_UPDATE, (uint8_t []) {0x00}, 0, 0},
     // Blue Gamma Table
-    {OLED_CMD_GAM_BLUE, (uint8_t []) {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0D, 0x0F, 0x11, 0x13, 0x16, 0x18, 0x1B, 0x1D, 0x20, 0x23, 0x26, 0x29, 0x2C, 0x30, 0x33, 0x37, 0x3A, 0x3E, 0x42, 0x46, 0x4A, 0x4E, 0x53, 0x57, 0x5C, 0x60, 0x65, 0x6A, 0x6F, 0x74, 0x79, 0x7E, 0x83, 0x89, 0x8E, 0x94, 0x9A, 0x9F, 0xA5, 0xAB, 0xB1, 0xB7, 0xBE, 0xC4, 0xCA, 0xD1, 0xD8, 0xDE, 0xE5, 0xEC, 0xF3, 0xFA}, 64, 0},
+    {OLED_CMD_GAM_BLUE, gamma_table_1_8, GAMMA_LEVELS, 0},
     // Gamma Table Update
     {OLED_CMD_GAM_UPDATE, (uint8_t []) {0x00}, 0, 0},
     // COM Number
@@ -86,7 +198,7 @@ static const pt6891_oled_init_cmd_t vendor_init_cmds_default[] = {
     // Anode Trimming
     {OLED_CMD_ANODE_TRIM, (uint8_t []) {OLED_SET_ANODE_TRIM(8)}, 1, 0},
     // Brightness
-    {OLED_CMD_BRIGHT, (uint8_t []) {OLED_SET_BRIGHT_R(43), OLED_SET_BRIGHT_G(14), OLED_SET_BRIGHT_B(26)}, 3, 0},
+    {OLED_CMD_BRIGHT, (uint8_t []) {OLED_SET_BRIGHT_R(BRIGHT_WHITE_R), OLED_SET_BRIGHT_G(BRIGHT_WHITE_G), OLED_SET_BRIGHT_B(BRIGHT_WHITE_B)}, 3, 0},
     // Precharge Period
     {OLED_CMD_PRECHG_PRD, (uint8_t []) {OLED_SET_PRECHG_PRD(10)}, 1, 0},
     // Precharge Current
@@ -97,22 +209,6 @@ static const pt6891_oled_init_cmd_t vendor_init_cmds_default[] = {
     {OLED_CMD_DISP_NORMAL, (uint8_t []) {0x00}, 0, 0},
 };
 
-/**
- * @brief Screen Pixel Offsets
- * 
- * [H_MIRROR][V_MIRROR][X_START, Y_START, Y_GATE]
- * 
- */
-static const int offsets[2][2][3] = {
-    {
-        {33, 0, 4},
-        {33, 4, 24},
-    }, {
-        {0, 0, 4},
-        {0, 4, 24},
-    },
-};
-
 static esp_err_t panel_pt6891_reset(esp_lcd_panel_t* panel) {
     pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
 
@@ -125,13 +221,64 @@ static esp_err_t panel_pt6891_reset(esp_lcd_panel_t* panel) {
         gpio_set_level(pt6891_panel -> reset_gpio_num, !pt6891_panel -> reset_level);
         vTaskDelay(10 / portTICK_PERIOD_MS);
     } else {
+        // SWRST is ignored in standby like any command but WAKEUP
+        if (pt6891_panel -> standby) {
+            ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_WAKEUP, NULL, 0), TAG, "Failed to send command");
+            esp_rom_delay_us(WAKEUP_OSC_US);
+        }
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_SWRST, NULL, 0), TAG, "Reset failed");
         vTaskDelay(10 / portTICK_PERIOD_MS);
     }
 
+    // The controller is awake with the display off, scroll stopped and the registers at their defaults
+    pt6891_panel -> standby = false;
+    pt6891_panel -> disp_on = false;
+    pt6891_panel -> scrolling = false;
+    pt6891_panel -> vsync_last_us = 0;
+    pt6891_panel -> row_len_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> clk_div_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> brightness_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> gamma_val = REG_VAL_UNKNOWN;
+    // Reset does not clear the RAM
+    pt6891_panel -> shadow_rows_valid = 0;
+
     return ESP_OK;
 }
 
+/**
+ * @brief Clear the whole frame buffer
+ * 
+ * One full width window, RAMWR wraps to the next row by itself so only the row address changes between chunks.
+ * Sent in the RGB565 mode set by the init table, the RAM is all zero in every mode afterwards.
+ * 
+ * @param pt6891_panel Panel
+ * @return esp_err_t 
+ */
+static esp_err_t panel_pt6891_clear_ram(pt6891_panel_t* pt6891_panel) {
+    esp_lcd_panel_io_handle_t panel_io_handle = pt6891_panel -> panel_io_handle;
+    size_t row_size = (RAM_ROW_LEN + 1) * sizeof(uint16_t);
+    size_t chunk_size = row_size * CLEAR_CHUNK_ROWS;
+    esp_err_t ret = ESP_OK;
+
+    uint8_t* blank_frame_buffer = heap_caps_calloc(1, chunk_size, MALLOC_CAP_DMA);
+    ESP_RETURN_ON_FALSE(blank_frame_buffer, ESP_ERR_NO_MEM, TAG, "No MEM for blank frame buffer");
+
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_COLADDR, (uint8_t []) {OLED_SET_COLADDR(RAM_START_X)}, 1), clear, TAG, "Failed to send command");
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_ROWLEN, (uint8_t []) {OLED_SET_ROWLEN(RAM_ROW_LEN)}, 1), clear, TAG, "Failed to send command");
+    // RAM_END_Y is the last row, the 33 rows end with a chunk of a single row
+    for (int j = RAM_START_Y; j <= RAM_END_Y; j += CLEAR_CHUNK_ROWS) {
+        int rows = RAM_END_Y + 1 - j < CLEAR_CHUNK_ROWS ? RAM_END_Y + 1 - j : CLEAR_CHUNK_ROWS;
+        ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_ROWADDR, (uint8_t []) {OLED_SET_ROWADDR(j)}, 1), clear, TAG, "Failed to send command");
+        // Polling transfer, the buffer is free again once it returns
+        ESP_GOTO_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_RAMWR, blank_frame_buffer, row_size * rows), clear, TAG, "Failed to send command");
+    }
+
+clear:
+    heap_caps_free(blank_frame_buffer);
+
+    return ret;
+}
+
 static esp_err_t panel_pt6891_init(esp_lcd_panel_t* panel) {
     pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
 
@@ -147,15 +294,17 @@ static esp_err_t panel_pt6891_init(esp_lcd_panel_t* panel) {
     for (int i = 0; i < init_cmds_size; i++) {
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes), TAG, "Failed to send init command");
 
+        if (init_cmds[i].cmd == OLED_CMD_DISP_NORMAL) {
+            pt6891_panel -> disp_on = true;
+        } else if (init_cmds[i].cmd == OLED_CMD_DISP_T1_OFF || init_cmds[i].cmd == OLED_CMD_DISP_T2_OFF) {
+            pt6891_panel -> disp_on = false;
+        }
+
         if (init_cmds[i].cmd == OLED_CMD_PRECHG_CUR) {
-            // Clear frame buffer
-            uint16_t blank_frame_buffer[RAM_ROW_LEN + 1] = {0x0000};
-
-            for (int j = RAM_START_Y; j < RAM_END_Y ; j++) {
-                ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWADDR, (uint8_t []) {OLED_SET_ROWADDR(j)}, 1), TAG, "Failed to send init command");
-                ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_COLADDR, (uint8_t []) {OLED_SET_COLADDR(0)}, 1), TAG, "Failed to send init command");
-                ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWLEN, (uint8_t []) {OLED_SET_ROWLEN(RAM_ROW_LEN)}, 1), TAG, "Failed to send init command");
-                ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_RAMWR, blank_frame_buffer, RAM_ROW_LEN * pt6891_panel -> fb_bits_per_pixel / 8), TAG, "Failed to send init command");
+            ESP_RETURN_ON_ERROR(panel_pt6891_clear_ram(pt6891_panel), TAG, "Failed to clear frame buffer");
+            if (pt6891_panel -> shadow) {
+                memset(pt6891_panel -> shadow, 0, PANEL_WIDTH * PANEL_HEIGHT * pt6891_panel -> fb_bits_per_pixel / 8);
+                pt6891_panel -> shadow_rows_valid = (1UL << PANEL_HEIGHT) - 1;
             }
 
             vTaskDelay(10 / portTICK_PERIOD_MS);
@@ -164,6 +313,20 @@ static esp_err_t panel_pt6891_init(esp_lcd_panel_t* panel) {
         vTaskDelay(init_cmds[i].delay_ms / portTICK_PERIOD_MS);
     }
 
+    // Color mode of the panel config, the RAM is all zero in every mode after the clear above
+    if (pt6891_panel -> colmod_val != OLED_CMD_COLOR_RGB565) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, pt6891_panel -> colmod_val, NULL, 0), TAG, "Failed to send command");
+    }
+    if (pt6891_panel -> com_per_row > 1) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_COM_NUM, (uint8_t []) {OLED_SET_COM_NUM(PANEL_HEIGHT * pt6891_panel -> com_per_row - 1)}, 1), TAG, "Failed to send command");
+    }
+
+    // Init commands may have touched the window registers, the gamma and the brightness
+    pt6891_panel -> row_len_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> clk_div_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> brightness_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> gamma_val = REG_VAL_UNKNOWN;
+
     ESP_LOGD(TAG, "Init PT6891 panel: %p", pt6891_panel);
 
     return ESP_OK;
@@ -176,51 +339,272 @@ static esp_err_t panel_pt6891_del(esp_lcd_panel_t* panel) {
         gpio_set_level(pt6891_panel -> reset_gpio_num, pt6891_panel -> reset_level);
     }
 
+    if (pt6891_panel -> int_gpio_num > -1) {
+        gpio_isr_handler_remove(pt6891_panel -> int_gpio_num);
+    }
+
+    if (pt6891_panel -> flush_done_cb) {
+        // The panel IO outlives the panel, don't leave it calling into freed memory
+        esp_lcd_panel_io_register_event_callbacks(pt6891_panel -> panel_io_handle, &(esp_lcd_panel_io_callbacks_t) {0}, NULL);
+    }
+
+    for (int i = 0; i < BOUNCE_NUM; i++) {
+        free(pt6891_panel -> bounce[i]);
+        free(pt6891_panel -> delta_bounce[i]);
+    }
+    free(pt6891_panel -> shadow);
+
     ESP_LOGD(TAG, "Del PT6891 panel: %p", pt6891_panel);
     free(pt6891_panel);
     return ESP_OK;
 }
 
-static esp_err_t panel_pt6891_draw_bitmap(esp_lcd_panel_t* panel, int x_start, int y_start, int x_end, int y_end, const void* color_data) {
-    pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
+/**
+ * @brief Transpose a bitmap, tile by tile so both source rows and destination rows stay in cache
+ * 
+ * @param dst Destination, src_h pixels per row
+ * @param src Source, src_w pixels per row
+ * @param src_w Source width
+ * @param src_h Source height
+ * @param pixel_bytes Bytes per pixel, 2 (RGB565) or 3 (RGB666)
+ */
+static void panel_pt6891_transpose(uint8_t* dst, const uint8_t* src, int src_w, int src_h, int pixel_bytes) {
+    for (int ty = 0; ty < src_h; ty += SWAP_TILE_SIZE) {
+        int ty_end = ty + SWAP_TILE_SIZE < src_h ? ty + SWAP_TILE_SIZE : src_h;
+        for (int tx = 0; tx < src_w; tx += SWAP_TILE_SIZE) {
+            int tx_end = tx + SWAP_TILE_SIZE < src_w ? tx + SWAP_TILE_SIZE : src_w;
+            if (pixel_bytes == 2) {
+                const uint16_t* src16 = (const uint16_t*) src;
+                uint16_t* dst16 = (uint16_t*) dst;
+                for (int x = tx; x < tx_end; x++) {
+                    for (int y = ty; y < ty_end; y++) {
+                        dst16[x * src_h + y] = src16[y * src_w + x];
+                    }
+                }
+            } else {
+                for (int x = tx; x < tx_end; x++) {
+                    for (int y = ty; y < ty_end; y++) {
+                        memcpy(&dst[(x * src_h + y) * pixel_bytes], &src[(y * src_w + x) * pixel_bytes], pixel_bytes);
+                    }
+                }
+            }
+        }
+    }
+}
 
-    if ((x_end < x_start) || (y_end < y_start)) {
-        ESP_RETURN_ON_ERROR(ESP_ERR_INVALID_ARG, TAG, "Invalid Drawing Area: [%d, %d, %d, %d]", x_start, y_start, x_end, y_end);
+/**
+ * @brief Expand 6-bit gray rows into the 3 COM lines of each panel row
+ * 
+ * @param dst Destination, MONO_COM_PER_ROW rows of w bytes per source row
+ * @param src Source, w bytes per row
+ * @param w Width
+ * @param h Height
+ */
+static void panel_pt6891_expand_mono64(uint8_t* dst, const uint8_t* src, int w, int h) {
+    for (int y = 0; y < h; y++) {
+        for (int i = 0; i < MONO_COM_PER_ROW; i++) {
+            memcpy(dst, src, w);
+            dst += w;
+        }
+        src += w;
+    }
+}
+
+/**
+ * @brief Repack 1-bit rows at the bit position of their column and expand them into the 3 COM lines of each panel row
+ * 
+ * @param dst Destination, MONO_COM_PER_ROW rows of dst_row_bytes per source row, padding pixels are black
+ * @param src Source, (w + 7) / 8 bytes per row, MSB first
+ * @param bit_offset Position of the first pixel in the first destination byte
+ * @param w Width
+ * @param h Height
+ * @param dst_row_bytes Bytes per destination row
+ */
+static void panel_pt6891_expand_mono2(uint8_t* dst, const uint8_t* src, int bit_offset, int w, int h, size_t dst_row_bytes) {
+    int src_row_bytes = (w + 7) / 8;
+
+    for (int y = 0; y < h; y++) {
+        memset(dst, 0, dst_row_bytes);
+        for (int x = 0; x < w; x++) {
+            if (src[x / 8] & (0x80 >> (x % 8))) {
+                int c = bit_offset + x;
+                dst[c / 8] |= MONO2_PIXEL_BIT(c % 8);
+            }
+        }
+        for (int i = 1; i < MONO_COM_PER_ROW; i++) {
+            memcpy(dst + i * dst_row_bytes, dst, dst_row_bytes);
+        }
+        dst += dst_row_bytes * MONO_COM_PER_ROW;
+        src += src_row_bytes;
+    }
+}
+
+/**
+ * @brief Pop every flush at the head of the ring that is done
+ * 
+ * @return int Number of flushes done, call flush_done_cb as many times out of the lock
+ */
+static int panel_pt6891_flush_pop(pt6891_panel_t* pt6891_panel) {
+    int num_done = 0;
+
+    while (pt6891_panel -> flush_head != pt6891_panel -> flush_tail) {
+        pt6891_flush_t* flush = &pt6891_panel -> flush_ring[pt6891_panel -> flush_head];
+        if (!flush -> sealed || flush -> pending) {
+            break;
+        }
+        pt6891_panel -> flush_head = (pt6891_panel -> flush_head + 1) % FLUSH_RING_SIZE;
+        num_done++;
+    }
+
+    return num_done;
+}
+
+static bool panel_pt6891_color_trans_done(esp_lcd_panel_io_handle_t panel_io_handle, esp_lcd_panel_io_event_data_t* panel_io_event_data, void* user_ctx) {
+    pt6891_panel_t* pt6891_panel = (pt6891_panel_t*) user_ctx;
+    bool need_yield = false;
+
+    // Transfers are done in order, this one belongs to the oldest flush with transfers pending
+    portENTER_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+    pt6891_panel -> flush_ring[pt6891_panel -> flush_head].pending--;
+    int num_done = panel_pt6891_flush_pop(pt6891_panel);
+    portEXIT_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+
+    for (int i = 0; i < num_done; i++) {
+        need_yield |= pt6891_panel -> flush_done_cb(&pt6891_panel -> base, pt6891_panel -> flush_done_ctx);
+    }
+
+    return need_yield;
+}
+
+static esp_err_t panel_pt6891_flush_begin(pt6891_panel_t* pt6891_panel) {
+    if (!pt6891_panel -> flush_done_cb) {
+        return ESP_OK;
+    }
+
+    // Only reachable when transfers are not done for several flushes, tx_param waits for all of them
+    if ((pt6891_panel -> flush_tail + 1) % FLUSH_RING_SIZE == pt6891_panel -> flush_head) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_NOP, NULL, 0), TAG, "Failed to wait for transfers");
+    }
+
+    portENTER_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+    pt6891_panel -> flush_ring[pt6891_panel -> flush_tail] = (pt6891_flush_t) {0, false};
+    portEXIT_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+
+    return ESP_OK;
+}
+
+static void panel_pt6891_flush_end(pt6891_panel_t* pt6891_panel) {
+    if (!pt6891_panel -> flush_done_cb) {
+        return;
+    }
+
+    portENTER_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+    pt6891_panel -> flush_ring[pt6891_panel -> flush_tail].sealed = true;
+    pt6891_panel -> flush_tail = (pt6891_panel -> flush_tail + 1) % FLUSH_RING_SIZE;
+    // Nothing was sent or it is already on the panel
+    int num_done = panel_pt6891_flush_pop(pt6891_panel);
+    portEXIT_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+
+    for (int i = 0; i < num_done; i++) {
+        pt6891_panel -> flush_done_cb(&pt6891_panel -> base, pt6891_panel -> flush_done_ctx);
+    }
+}
+
+static void panel_pt6891_flush_pending(pt6891_panel_t* pt6891_panel, int delta) {
+    if (!pt6891_panel -> flush_done_cb) {
+        return;
     }
 
+    portENTER_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+    pt6891_panel -> flush_ring[pt6891_panel -> flush_tail].pending += delta;
+    portEXIT_CRITICAL_SAFE(&pt6891_panel -> flush_lock);
+}
+
+static esp_err_t panel_pt6891_write_window(pt6891_panel_t* pt6891_panel, const pt6891_window_t* window) {
+    esp_lcd_panel_io_handle_t panel_io_handle = pt6891_panel -> panel_io_handle;
+
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_ROWADDR, (uint8_t []) {OLED_SET_ROWADDR(window -> row)}, 1), TAG, "Failed to send command");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_COLADDR, (uint8_t []) {OLED_SET_COLADDR(window -> col)}, 1), TAG, "Failed to send command");
+    // Row length is latched by the controller, only resend it when the window width changes
+    if (pt6891_panel -> row_len_val != window -> row_len) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_ROWLEN, (uint8_t []) {OLED_SET_ROWLEN(window -> row_len)}, 1), TAG, "Failed to send command");
+        pt6891_panel -> row_len_val = window -> row_len;
+    }
+    // Counted before queueing, the transfer may be done before tx_color returns
+    panel_pt6891_flush_pending(pt6891_panel, 1);
+    esp_err_t ret = esp_lcd_panel_io_tx_color(panel_io_handle, OLED_CMD_RAMWR, window -> data, window -> data_bytes);
+    if (ret != ESP_OK) {
+        panel_pt6891_flush_pending(pt6891_panel, -1);
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "Failed to send color data");
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Write a rectangle of panel pixels, after swap
+ * 
+ * @param pt6891_panel Panel
+ * @param data Pixels of the rectangle, rows back to back
+ * @return esp_err_t 
+ */
+static esp_err_t panel_pt6891_write_rect(pt6891_panel_t* pt6891_panel, int x_start, int y_start, int x_end, int y_end, const uint8_t* data) {
+    int pixel_bytes = pt6891_panel -> fb_bits_per_pixel / 8;
+
     int x_mirror = !!(pt6891_panel -> mirror_val & 0x02);
     int y_mirror = pt6891_panel -> mirror_val & 0x01;
-    int x_offset = offsets[x_mirror][y_mirror][0];
-    int y_offset = offsets[x_mirror][y_mirror][1];
-    int y_gate = offsets[x_mirror][y_mirror][2];
+    int x_offset = pt6891_glass_offsets[x_mirror][y_mirror][0];
+    int y_offset = pt6891_glass_offsets[x_mirror][y_mirror][1];
+    int y_gate = pt6891_glass_offsets[x_mirror][y_mirror][2];
     int y_gate_offset = PANEL_HEIGHT - y_gate;
 
     x_start += pt6891_panel -> x_gap + x_offset;
     x_end += pt6891_panel -> x_gap + x_offset;
     y_start += pt6891_panel -> y_gap;
     y_end += pt6891_panel -> y_gap;
-    
+
+    size_t row_bytes = (x_end - x_start + 1) * pixel_bytes;
+    int row_len = x_end - x_start;
+    int com_per_row = pt6891_panel -> com_per_row;
+
+    if (com_per_row > 1) {
+        // Mono: every panel row is written to its R, G and B COM lines with the same gray
+        uint8_t* bounce = pt6891_panel -> bounce[pt6891_panel -> bounce_idx];
+        pt6891_panel -> bounce_idx = (pt6891_panel -> bounce_idx + 1) % BOUNCE_NUM;
+
+        if (pt6891_panel -> colmod_val == OLED_CMD_COLOR_MONO_2) {
+            // Column address and row length step by 8 pixels, see pt6891_align_columns
+            int col_start = x_start & ~0x07;
+            int col_end = x_end | 0x07;
+            size_t mono2_row_bytes = (col_end - col_start + 1) / 8;
+            panel_pt6891_expand_mono2(bounce, data, x_start - col_start, x_end - x_start + 1, y_end - y_start + 1, mono2_row_bytes);
+            x_start = col_start;
+            row_len = col_end - col_start - 7;
+            row_bytes = mono2_row_bytes * com_per_row;
+        } else {
+            panel_pt6891_expand_mono64(bounce, data, x_end - x_start + 1, y_end - y_start + 1);
+            row_bytes *= com_per_row;
+        }
+        data = bounce;
+    }
+
+    // Plan all RAM windows of this flush first, then send them back to back
+    pt6891_window_t windows[2];
+    int num_windows = 0;
+
     if (y_end < y_gate) {
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWADDR, (uint8_t []) {OLED_SET_ROWADDR(y_start + y_gate_offset + y_offset)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_COLADDR, (uint8_t []) {OLED_SET_COLADDR(x_start)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWLEN, (uint8_t []) {OLED_SET_ROWLEN(x_end - x_start)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(pt6891_panel -> panel_io_handle, OLED_CMD_RAMWR, color_data, (x_end - x_start + 1) * (y_end - y_start + 1) * pt6891_panel -> fb_bits_per_pixel / 8), TAG, "Failed to send color data");
+        windows[num_windows++] = (pt6891_window_t) {(y_start + y_gate_offset + y_offset) * com_per_row, x_start, row_len, data, row_bytes * (y_end - y_start + 1)};
     } else if (y_start > y_gate - 1) {
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWADDR, (uint8_t []) {OLED_SET_ROWADDR(y_start - y_gate + y_offset)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_COLADDR, (uint8_t []) {OLED_SET_COLADDR(x_start)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWLEN, (uint8_t []) {OLED_SET_ROWLEN(x_end - x_start + 1 - 1)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(pt6891_panel -> panel_io_handle, OLED_CMD_RAMWR, color_data, (x_end - x_start + 1) * (y_end - y_start + 1) * pt6891_panel -> fb_bits_per_pixel / 8), TAG, "Failed to send color data");
+        windows[num_windows++] = (pt6891_window_t) {(y_start - y_gate + y_offset) * com_per_row, x_start, row_len, data, row_bytes * (y_end - y_start + 1)};
     } else {
-        uint16_t stage_size = (x_end - x_start + 1) * (y_gate - 1 - y_start + 1)  * pt6891_panel -> fb_bits_per_pixel / 8;
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWADDR, (uint8_t []) {OLED_SET_ROWADDR(y_start + y_gate_offset + y_offset)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_COLADDR, (uint8_t []) {OLED_SET_COLADDR(x_start)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWLEN, (uint8_t []) {OLED_SET_ROWLEN(x_end - x_start)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(pt6891_panel -> panel_io_handle, OLED_CMD_RAMWR, color_data, stage_size), TAG, "Failed to send color data");
+        // Area straddles the gate, rows above it and rows below it are not adjacent in RAM
+        size_t stage_size = row_bytes * (y_gate - y_start);
+        windows[num_windows++] = (pt6891_window_t) {(y_start + y_gate_offset + y_offset) * com_per_row, x_start, row_len, data, stage_size};
+        windows[num_windows++] = (pt6891_window_t) {y_offset * com_per_row, x_start, row_len, data + stage_size, row_bytes * (y_end - y_gate + 1)};
+    }
 
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWADDR, (uint8_t []) {OLED_SET_ROWADDR(y_offset)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_COLADDR, (uint8_t []) {OLED_SET_COLADDR(x_start)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_ROWLEN, (uint8_t []) {OLED_SET_ROWLEN(x_end - x_start)}, 1), TAG, "Failed to send command");
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_color(pt6891_panel -> panel_io_handle, OLED_CMD_RAMWR, color_data + stage_size, (x_end - x_start + 1) * (y_end - y_gate + 1) * pt6891_panel -> fb_bits_per_pixel / 8), TAG, "Failed to send color data");
+    for (int i = 0; i < num_windows; i++) {
+        ESP_RETURN_ON_ERROR(panel_pt6891_write_window(pt6891_panel, &windows[i]), TAG, "Failed to write window");
     }
 
     // For debug
@@ -232,10 +616,210 @@ static esp_err_t panel_pt6891_draw_bitmap(esp_lcd_panel_t* panel, int x_start, i
     return ESP_OK;
 }
 
+/**
+ * @brief Find the changed pixels of a row, a word at a time from both ends
+ * 
+ * @param row New pixels
+ * @param shadow Pixels currently in RAM
+ * @param row_bytes Bytes in the row
+ * @param pixel_bytes Bytes per pixel
+ * @param first Returned first changed pixel
+ * @param last Returned last changed pixel
+ * @return bool false if nothing changed
+ */
+static bool panel_pt6891_row_diff(const uint8_t* row, const uint8_t* shadow, size_t row_bytes, int pixel_bytes, int* first, int* last) {
+    size_t head = 0;
+    size_t tail = row_bytes;
+    uint32_t row_word, shadow_word;
+
+    while (head + sizeof(uint32_t) <= tail) {
+        memcpy(&row_word, row + head, sizeof(uint32_t));
+        memcpy(&shadow_word, shadow + head, sizeof(uint32_t));
+        if (row_word != shadow_word) {
+            break;
+        }
+        head += sizeof(uint32_t);
+    }
+    while (head < tail && row[head] == shadow[head]) {
+        head++;
+    }
+    if (head == tail) {
+        return false;
+    }
+
+    // row[head] differs, it stops the scan from the right
+    while (tail >= head + 1 + sizeof(uint32_t)) {
+        memcpy(&row_word, row + tail - sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&shadow_word, shadow + tail - sizeof(uint32_t), sizeof(uint32_t));
+        if (row_word != shadow_word) {
+            break;
+        }
+        tail -= sizeof(uint32_t);
+    }
+    while (row[tail - 1] == shadow[tail - 1]) {
+        tail--;
+    }
+
+    *first = head / pixel_bytes;
+    *last = (tail - 1) / pixel_bytes;
+
+    return true;
+}
+
+/**
+ * @brief Send the pixels of a flush that differ from the shadow frame buffer
+ * 
+ * Changed spans of adjacent rows are merged into one rectangle while resending the unchanged pixels
+ * between them is cheaper than opening a new window. Rectangles are packed into a bounce buffer.
+ * 
+ * @param pt6891_panel Panel
+ * @param data Pixels of the flush, rows back to back
+ * @return esp_err_t 
+ */
+static esp_err_t panel_pt6891_write_delta(pt6891_panel_t* pt6891_panel, int x_start, int y_start, int x_end, int y_end, const uint8_t* data) {
+    esp_err_t ret = ESP_OK;
+    int pixel_bytes = pt6891_panel -> fb_bits_per_pixel / 8;
+    size_t src_row_bytes = (x_end - x_start + 1) * pixel_bytes;
+    size_t shadow_row_bytes = PANEL_WIDTH * pixel_bytes;
+
+    pt6891_panel -> delta_bytes_in += src_row_bytes * (y_end - y_start + 1);
+
+    if ((x_start < 0) || (y_start < 0) || (x_end > PANEL_WIDTH - 1) || (y_end > PANEL_HEIGHT - 1)) {
+        // Out of the shadow, e.g. a gap is set
+        pt6891_panel -> delta_bytes_sent += src_row_bytes * (y_end - y_start + 1);
+        return panel_pt6891_write_rect(pt6891_panel, x_start, y_start, x_end, y_end, data);
+    }
+
+    int x_mirror = !!(pt6891_panel -> mirror_val & 0x02);
+    int y_mirror = pt6891_panel -> mirror_val & 0x01;
+    int gate_row = pt6891_glass_offsets[x_mirror][y_mirror][2] - pt6891_panel -> y_gap;
+
+    uint8_t* bounce = pt6891_panel -> delta_bounce[pt6891_panel -> delta_bounce_idx];
+    pt6891_panel -> delta_bounce_idx = (pt6891_panel -> delta_bounce_idx + 1) % BOUNCE_NUM;
+    size_t packed = 0;
+
+    // Rectangle being merged, rect_y_start = -1 if none
+    int rect_x_start = 0, rect_x_end = 0, rect_y_start = -1, rect_y_end = 0;
+
+    for (int y = y_start; y <= y_end + 1; y++) {
+        int first = 0, last = 0;
+        bool changed = false;
+
+        if (y <= y_end) {
+            const uint8_t* row = data + (y - y_start) * src_row_bytes;
+            uint8_t* shadow = pt6891_panel -> shadow + y * shadow_row_bytes + x_start * pixel_bytes;
+
+            if (pt6891_panel -> shadow_rows_valid & (1UL << y)) {
+                changed = panel_pt6891_row_diff(row, shadow, src_row_bytes, pixel_bytes, &first, &last);
+                first += x_start;
+                last += x_start;
+            } else {
+                // RAM content unknown, send the whole span
+                changed = true;
+                first = x_start;
+                last = x_end;
+                if ((x_start == 0) && (x_end == PANEL_WIDTH - 1) && !pt6891_panel -> scrolling) {
+                    pt6891_panel -> shadow_rows_valid |= 1UL << y;
+                }
+            }
+            memcpy(shadow, row, src_row_bytes);
+        }
+
+        if (rect_y_start > -1 && changed && y != gate_row) {
+            int merged_x_start = first < rect_x_start ? first : rect_x_start;
+            int merged_x_end = last > rect_x_end ? last : rect_x_end;
+            size_t merged_bytes = (merged_x_end - merged_x_start + 1) * (y - rect_y_start + 1) * pixel_bytes;
+            size_t split_bytes = ((rect_x_end - rect_x_start + 1) * (y - rect_y_start) + (last - first + 1)) * pixel_bytes + DELTA_WINDOW_COST;
+            if (merged_bytes <= split_bytes) {
+                rect_x_start = merged_x_start;
+                rect_x_end = merged_x_end;
+                rect_y_end = y;
+                continue;
+            }
+        }
+
+        if (rect_y_start > -1) {
+            // Pack the rectangle from the new pixels, rows not changed in it are equal to RAM anyway
+            uint8_t* rect_data = bounce + packed;
+            size_t rect_row_bytes = (rect_x_end - rect_x_start + 1) * pixel_bytes;
+            for (int ry = rect_y_start; ry <= rect_y_end; ry++) {
+                memcpy(bounce + packed, data + (ry - y_start) * src_row_bytes + (rect_x_start - x_start) * pixel_bytes, rect_row_bytes);
+                packed += rect_row_bytes;
+            }
+            ESP_GOTO_ON_ERROR(panel_pt6891_write_rect(pt6891_panel, rect_x_start, rect_y_start, rect_x_end, rect_y_end, rect_data), err, TAG, "Failed to write rect");
+            rect_y_start = -1;
+        }
+
+        if (changed) {
+            rect_x_start = first;
+            rect_x_end = last;
+            rect_y_start = y;
+            rect_y_end = y;
+        }
+    }
+
+    pt6891_panel -> delta_bytes_sent += packed;
+
+    return ESP_OK;
+
+err:
+    // The shadow already holds the new rows, what reached the RAM is unknown
+    pt6891_panel -> shadow_rows_valid &= ~(((1UL << (y_end + 1)) - 1) & ~((1UL << y_start) - 1));
+    return ret;
+}
+
+static esp_err_t panel_pt6891_draw_bitmap(esp_lcd_panel_t* panel, int x_start, int y_start, int x_end, int y_end, const void* color_data) {
+    pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
+
+    if ((x_end < x_start) || (y_end < y_start)) {
+        ESP_RETURN_ON_ERROR(ESP_ERR_INVALID_ARG, TAG, "Invalid Drawing Area: [%d, %d, %d, %d]", x_start, y_start, x_end, y_end);
+    }
+    ESP_RETURN_ON_FALSE(!pt6891_panel -> standby, ESP_ERR_INVALID_STATE, TAG, "Panel in standby");
+
+    const uint8_t* data = (const uint8_t*) color_data;
+    int pixel_bytes = pt6891_panel -> fb_bits_per_pixel / 8;
+
+    if (pt6891_panel -> colswap_val) {
+        // Controller has no swap, transpose into a bounce buffer and swap the area
+        int src_w = x_end - x_start + 1;
+        int src_h = y_end - y_start + 1;
+        ESP_RETURN_ON_FALSE(src_w * src_h <= PANEL_WIDTH * PANEL_HEIGHT, ESP_ERR_INVALID_SIZE, TAG, "Swapped Drawing Area too large: [%d, %d, %d, %d]", x_start, y_start, x_end, y_end);
+
+        // The last bounce buffer may still be on the wire, the one before it has been waited by the ROWADDR of the last flush
+        uint8_t* bounce = pt6891_panel -> bounce[pt6891_panel -> bounce_idx];
+        pt6891_panel -> bounce_idx = (pt6891_panel -> bounce_idx + 1) % BOUNCE_NUM;
+        panel_pt6891_transpose(bounce, data, src_w, src_h, pixel_bytes);
+        data = bounce;
+
+        int swap_start = x_start;
+        int swap_end = x_end;
+        x_start = y_start;
+        x_end = y_end;
+        y_start = swap_start;
+        y_end = swap_end;
+    }
+
+    ESP_RETURN_ON_ERROR(panel_pt6891_flush_begin(pt6891_panel), TAG, "Failed to begin flush");
+
+    esp_err_t ret;
+    if (pt6891_panel -> shadow) {
+        ret = panel_pt6891_write_delta(pt6891_panel, x_start, y_start, x_end, y_end, data);
+    } else {
+        ret = panel_pt6891_write_rect(pt6891_panel, x_start, y_start, x_end, y_end, data);
+    }
+
+    // Sealed even on error, the transfers already queued still complete
+    panel_pt6891_flush_end(pt6891_panel);
+
+    return ret;
+}
+
 static esp_err_t panel_pt6891_mirror(esp_lcd_panel_t* panel, bool mirror_x, bool mirror_y) {
     pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
     
     pt6891_panel -> mirror_val = OLED_CMD_MIRROR(mirror_x, mirror_y);
+    // Panel pixels map to other RAM cells now
+    pt6891_panel -> shadow_rows_valid = 0;
 
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, pt6891_panel -> mirror_val, NULL, 0), TAG, "Failed to send command");
 
@@ -245,9 +829,19 @@ static esp_err_t panel_pt6891_mirror(esp_lcd_panel_t* panel, bool mirror_x, bool
 static esp_err_t panel_pt6891_swap_xy(esp_lcd_panel_t* panel, bool swap_axes) {
     pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
 
-    //TODO: Add software swap, transpose data
+    // Transposing packed gray pixels is not supported
+    ESP_RETURN_ON_FALSE(!swap_axes || pt6891_panel -> com_per_row == 1, ESP_ERR_NOT_SUPPORTED, TAG, "Swap is not supported in mono mode");
+
+    // Swap is done in software, bounce buffers are only allocated once it is used
+    if (swap_axes && !pt6891_panel -> bounce[0]) {
+        size_t bounce_size = PANEL_WIDTH * PANEL_HEIGHT * pt6891_panel -> fb_bits_per_pixel / 8;
+        for (int i = 0; i < BOUNCE_NUM; i++) {
+            pt6891_panel -> bounce[i] = heap_caps_malloc(bounce_size, MALLOC_CAP_DMA);
+            ESP_RETURN_ON_FALSE(pt6891_panel -> bounce[i], ESP_ERR_NO_MEM, TAG, "No MEM for swap bounce buffer");
+        }
+    }
+
     pt6891_panel -> colswap_val = swap_axes;
-    ESP_LOGE(TAG, "TODO: Add software swap");
 
     return ESP_OK;
 }
@@ -257,6 +851,7 @@ static esp_err_t panel_pt6891_set_gap(esp_lcd_panel_t* panel, int x_gap, int y_g
 
     pt6891_panel -> x_gap = x_gap;
     pt6891_panel -> y_gap = y_gap;
+    pt6891_panel -> shadow_rows_valid = 0;
 
     return ESP_OK;
 }
@@ -276,31 +871,290 @@ static esp_err_t panel_pt6891_invert_color(esp_lcd_panel_t* panel, bool invert_c
 
 static esp_err_t panel_pt6891_disp_on_off(esp_lcd_panel_t* panel, bool on_off) {
     pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(!pt6891_panel -> standby, ESP_ERR_INVALID_STATE, TAG, "Panel in standby");
 
     if (on_off) {
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_DISP_NORMAL, NULL, 0), TAG, "Failed to send command");
     } else {
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_DISP_T1_OFF, NULL, 0), TAG, "Failed to send command");
     }
+    pt6891_panel -> disp_on = on_off;
 
     return ESP_OK;
 }
 
+/**
+ * @brief Wait for one frame, measured on INT or estimated from the clock divider
+ * 
+ */
+static void panel_pt6891_wait_frame(pt6891_panel_t* pt6891_panel) {
+    uint32_t frame_us = pt6891_panel -> vsync_period_us;
+
+    if (!frame_us) {
+        // Unknown divider, assume the slowest
+        frame_us = FRAME_US_DIV_1 * (pt6891_panel -> clk_div_val > 0 ? pt6891_panel -> clk_div_val : 8);
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(frame_us / 1000) + 1);
+}
+
 static esp_err_t panel_pt6891_disp_sleep(esp_lcd_panel_t* panel, bool sleep) {
     pt6891_panel_t* pt6891_panel = __containerof(panel, pt6891_panel_t, base);
 
+    if (sleep == pt6891_panel -> standby) {
+        return ESP_OK;
+    }
+
     if (sleep) {
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_STANDBY, NULL, 0), TAG, "Failed to send command");
+        // Standby starts with the next frame, until then no command is accepted, not even WAKEUP
+        panel_pt6891_wait_frame(pt6891_panel);
+        pt6891_panel -> standby = true;
     } else {
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_WAKEUP, NULL, 0), TAG, "Failed to send command");
+        esp_rom_delay_us(WAKEUP_OSC_US);
+        pt6891_panel -> standby = false;
+        // INT stopped with the oscillator, the next edge starts a new measurement
+        pt6891_panel -> vsync_last_us = 0;
+        // Standby switched the display off (Type 1)
+        if (pt6891_panel -> disp_on) {
+            ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_DISP_NORMAL, NULL, 0), TAG, "Failed to send command");
+        }
     }
 
     return ESP_OK;
 }
 
+esp_err_t pt6891_align_columns(esp_lcd_panel_handle_t panel_handle, int* x_start, int* x_end) {
+    ESP_RETURN_ON_FALSE(panel_handle && x_start && x_end, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+
+    if (pt6891_panel -> colmod_val != OLED_CMD_COLOR_MONO_2) {
+        return ESP_OK;
+    }
+
+    int x_mirror = !!(pt6891_panel -> mirror_val & 0x02);
+    int y_mirror = pt6891_panel -> mirror_val & 0x01;
+    int x_offset = pt6891_glass_offsets[x_mirror][y_mirror][0] + pt6891_panel -> x_gap;
+
+    // Widen to whole bytes of RAM, the part out of the panel lands in columns that are not displayed
+    int aligned_start = ((*x_start + x_offset) & ~0x07) - x_offset;
+    int aligned_end = ((*x_end + x_offset) | 0x07) - x_offset;
+    *x_start = aligned_start > 0 ? aligned_start : 0;
+    *x_end = aligned_end < PANEL_WIDTH - 1 ? aligned_end : PANEL_WIDTH - 1;
+
+    return ESP_OK;
+}
+
+esp_err_t pt6891_register_flush_done_cb(esp_lcd_panel_handle_t panel_handle, pt6891_flush_done_cb_t flush_done_cb, void* user_ctx) {
+    ESP_RETURN_ON_FALSE(panel_handle && flush_done_cb, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+
+    esp_lcd_panel_io_callbacks_t panel_io_callbacks = {
+        .on_color_trans_done = panel_pt6891_color_trans_done,
+    };
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(pt6891_panel -> panel_io_handle, &panel_io_callbacks, pt6891_panel), TAG, "Failed to register panel IO callbacks");
+
+    pt6891_panel -> flush_done_ctx = user_ctx;
+    pt6891_panel -> flush_done_cb = flush_done_cb;
+
+    return ESP_OK;
+}
+
+esp_err_t pt6891_get_delta_stats(esp_lcd_panel_handle_t panel_handle, pt6891_delta_stats_t* delta_stats) {
+    ESP_RETURN_ON_FALSE(panel_handle && delta_stats, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(pt6891_panel -> shadow, ESP_ERR_NOT_SUPPORTED, TAG, "Delta flush is off");
+
+    delta_stats -> bytes_in = pt6891_panel -> delta_bytes_in;
+    delta_stats -> bytes_sent = pt6891_panel -> delta_bytes_sent;
+
+    return ESP_OK;
+}
+
+esp_err_t pt6891_set_clock_div(esp_lcd_panel_handle_t panel_handle, uint8_t clk_div) {
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+    ESP_RETURN_ON_FALSE(clk_div == 1 || clk_div == 2 || clk_div == 4 || clk_div == 8, ESP_ERR_INVALID_ARG, TAG, "Invalid clock divider: %d", clk_div);
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(!pt6891_panel -> standby, ESP_ERR_INVALID_STATE, TAG, "Panel in standby");
+
+    if (pt6891_panel -> clk_div_val == clk_div) {
+        return ESP_OK;
+    }
+
+    // CLK_DIV_1, 2, 4 and 8 are consecutive
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_CLK_DIV_1 + __builtin_ctz(clk_div), NULL, 0), TAG, "Failed to send command");
+    pt6891_panel -> clk_div_val = clk_div;
+    // The frame period scales with the divider, measure it again
+    pt6891_panel -> vsync_last_us = 0;
+    pt6891_panel -> vsync_period_us = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t pt6891_set_brightness(esp_lcd_panel_handle_t panel_handle, uint8_t brightness) {
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(!pt6891_panel -> standby, ESP_ERR_INVALID_STATE, TAG, "Panel in standby");
+
+    // Fade steps often land on the same level, nothing to send then
+    if (pt6891_panel -> brightness_val == brightness) {
+        return ESP_OK;
+    }
+
+    // Scale the white balance as a whole, rounded
+    uint8_t bright_vals[3] = {
+        OLED_SET_BRIGHT_R((BRIGHT_WHITE_R * brightness + 127) / 255),
+        OLED_SET_BRIGHT_G((BRIGHT_WHITE_G * brightness + 127) / 255),
+        OLED_SET_BRIGHT_B((BRIGHT_WHITE_B * brightness + 127) / 255),
+    };
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_BRIGHT, bright_vals, sizeof(bright_vals)), TAG, "Failed to send command");
+    pt6891_panel -> brightness_val = brightness;
+
+    return ESP_OK;
+}
+
+esp_err_t pt6891_set_gamma_profile(esp_lcd_panel_handle_t panel_handle, pt6891_gamma_profile_t gamma_profile) {
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+    ESP_RETURN_ON_FALSE(gamma_profile >= 0 && gamma_profile < PT6891_GAMMA_MAX, ESP_ERR_INVALID_ARG, TAG, "Invalid gamma profile: %d", gamma_profile);
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(!pt6891_panel -> standby, ESP_ERR_INVALID_STATE, TAG, "Panel in standby");
+    esp_lcd_panel_io_handle_t panel_io_handle = pt6891_panel -> panel_io_handle;
+    const uint8_t* const* gamma_tables = gamma_profiles[gamma_profile];
+
+    if (pt6891_panel -> gamma_val == gamma_profile) {
+        return ESP_OK;
+    }
+
+    // All tables first and a single update, they are loaded together on the next frame
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_GAM_RED, gamma_tables[0], GAMMA_LEVELS), TAG, "Failed to send command");
+    // Mono modes only use the red table
+    if (pt6891_panel -> com_per_row == 1) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_GAM_GREEN, gamma_tables[1], GAMMA_LEVELS), TAG, "Failed to send command");
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_GAM_BLUE, gamma_tables[2], GAMMA_LEVELS), TAG, "Failed to send command");
+    }
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_GAM_UPDATE, NULL, 0), TAG, "Failed to send command");
+    pt6891_panel -> gamma_val = gamma_profile;
+
+    return ESP_OK;
+}
+
+esp_err_t pt6891_scroll_start(esp_lcd_panel_handle_t panel_handle, const pt6891_scroll_config_t* scroll_config) {
+    ESP_RETURN_ON_FALSE(panel_handle && scroll_config, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+    ESP_RETURN_ON_FALSE(scroll_config -> mode <= PT6891_SCROLL_BOTH, ESP_ERR_INVALID_ARG, TAG, "Invalid scroll mode");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(!pt6891_panel -> standby, ESP_ERR_INVALID_STATE, TAG, "Panel in standby");
+    esp_lcd_panel_io_handle_t panel_io_handle = pt6891_panel -> panel_io_handle;
+
+    int x_mirror = !!(pt6891_panel -> mirror_val & 0x02);
+    int y_mirror = pt6891_panel -> mirror_val & 0x01;
+    int y_offset = pt6891_glass_offsets[x_mirror][y_mirror][1];
+    int y_gate = pt6891_glass_offsets[x_mirror][y_mirror][2];
+    int y_gate_offset = PANEL_HEIGHT - y_gate;
+
+    int row_start = scroll_config -> row_start + pt6891_panel -> y_gap;
+    int row_end = scroll_config -> row_end + pt6891_panel -> y_gap;
+
+    ESP_RETURN_ON_FALSE((row_start <= row_end) && (row_start >= 0) && (row_end < PANEL_HEIGHT), ESP_ERR_INVALID_ARG, TAG, "Invalid scroll rows: [%d, %d]", row_start, row_end);
+    // Rows above and below the gate are not adjacent in RAM, one window can not hold both
+    ESP_RETURN_ON_FALSE((row_end < y_gate) || (row_start > y_gate - 1), ESP_ERR_INVALID_ARG, TAG, "Scroll rows cross the gate: [%d, %d]", row_start, row_end);
+
+    if (row_end < y_gate) {
+        row_start += y_gate_offset + y_offset;
+        row_end += y_gate_offset + y_offset;
+    } else {
+        row_start += y_offset - y_gate;
+        row_end += y_offset - y_gate;
+    }
+    row_start *= pt6891_panel -> com_per_row;
+    row_end = (row_end + 1) * pt6891_panel -> com_per_row - 1;
+
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_GPH_ACC_DIS, NULL, 0), TAG, "Failed to send command");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_GPH_ACC, (uint8_t []) {OLED_SET_GPH_ACC(scroll_config -> left_to_right, scroll_config -> top_to_bottom, scroll_config -> mode)}, 1), TAG, "Failed to send command");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_ACC_FRAME, (uint8_t []) {OLED_SET_ACC_FRAME(scroll_config -> frame_interval)}, 1), TAG, "Failed to send command");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_ACC_ROW, (uint8_t []) {OLED_SET_ACC_ROWSTART(row_start), OLED_SET_ACC_ROWEND(row_end)}, 2), TAG, "Failed to send command");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(panel_io_handle, OLED_CMD_GPH_ACC_EN, NULL, 0), TAG, "Failed to send command");
+    // The scroll rotates the RAM rows, the shadow no longer matches until the scroll stops and rows are sent again
+    pt6891_panel -> shadow_rows_valid = 0;
+    pt6891_panel -> scrolling = true;
+
+    return ESP_OK;
+}
+
+esp_err_t pt6891_scroll_stop(esp_lcd_panel_handle_t panel_handle) {
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(!pt6891_panel -> standby, ESP_ERR_INVALID_STATE, TAG, "Panel in standby");
+
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(pt6891_panel -> panel_io_handle, OLED_CMD_GPH_ACC_DIS, NULL, 0), TAG, "Failed to send command");
+    // The RAM stays where the scroll left it
+    pt6891_panel -> shadow_rows_valid = 0;
+    pt6891_panel -> scrolling = false;
+
+    return ESP_OK;
+}
+
+static void IRAM_ATTR panel_pt6891_int_isr(void* arg) {
+    pt6891_panel_t* pt6891_panel = (pt6891_panel_t*) arg;
+    BaseType_t need_yield = pdFALSE;
+
+    int64_t now_us = esp_timer_get_time();
+    if (pt6891_panel -> vsync_last_us) {
+        uint32_t period_us = (uint32_t) (now_us - pt6891_panel -> vsync_last_us);
+        // Light filter, a single late edge (flash write, higher priority ISR) should not move the period
+        pt6891_panel -> vsync_period_us = pt6891_panel -> vsync_period_us ? (pt6891_panel -> vsync_period_us * 7 + period_us) / 8 : period_us;
+    }
+    pt6891_panel -> vsync_last_us = now_us;
+
+    TaskHandle_t vsync_task = pt6891_panel -> vsync_task;
+    if (vsync_task) {
+        vTaskNotifyGiveFromISR(vsync_task, &need_yield);
+    }
+
+    if (need_yield) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+esp_err_t pt6891_wait_vsync(esp_lcd_panel_handle_t panel_handle, int timeout_ms) {
+    ESP_RETURN_ON_FALSE(panel_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(pt6891_panel -> int_gpio_num > -1, ESP_ERR_NOT_SUPPORTED, TAG, "INT GPIO not configured");
+
+    // Drop an edge notified before this call, only a fresh frame start counts
+    ulTaskNotifyTake(pdTRUE, 0);
+    pt6891_panel -> vsync_task = xTaskGetCurrentTaskHandle();
+    uint32_t notified = ulTaskNotifyTake(pdTRUE, (timeout_ms == -1) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+    pt6891_panel -> vsync_task = NULL;
+
+    return notified ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t pt6891_get_frame_period(esp_lcd_panel_handle_t panel_handle, uint32_t* period_us) {
+    ESP_RETURN_ON_FALSE(panel_handle && period_us, ESP_ERR_INVALID_ARG, TAG, "Invalid argument");
+
+    pt6891_panel_t* pt6891_panel = __containerof(panel_handle, pt6891_panel_t, base);
+    ESP_RETURN_ON_FALSE(pt6891_panel -> int_gpio_num > -1, ESP_ERR_NOT_SUPPORTED, TAG, "INT GPIO not configured");
+    ESP_RETURN_ON_FALSE(pt6891_panel -> vsync_period_us, ESP_ERR_INVALID_STATE, TAG, "Frame period not measured yet");
+
+    *period_us = pt6891_panel -> vsync_period_us;
+
+    return ESP_OK;
+}
+
 esp_err_t esp_lcd_new_panel_pt6891(const esp_lcd_panel_io_handle_t panel_io_handle, const esp_lcd_panel_dev_config_t* panel_dev_config, esp_lcd_panel_handle_t* panel_handle) {
     esp_err_t ret = ESP_OK;
     pt6891_panel_t* pt6891_panel = NULL;
+    bool delta_flush = false;
 
     ESP_GOTO_ON_FALSE(panel_io_handle && panel_dev_config && panel_handle, ESP_ERR_INVALID_ARG, clear, TAG, "Invalid argument");
 
@@ -340,6 +1194,16 @@ esp_err_t esp_lcd_new_panel_pt6891(const esp_lcd_panel_io_handle_t panel_io_hand
             pt6891_panel -> fb_bits_per_pixel = 24;
             break;
         }
+        case 6: {   // Mono, 64 Gray
+            pt6891_panel -> colmod_val = OLED_CMD_COLOR_MONO_64;
+            pt6891_panel -> fb_bits_per_pixel = 8;
+            break;
+        }
+        case 1: {   // Mono, 2 Gray
+            pt6891_panel -> colmod_val = OLED_CMD_COLOR_MONO_2;
+            pt6891_panel -> fb_bits_per_pixel = 1;
+            break;
+        }
         default: {
             ESP_GOTO_ON_FALSE(false, ESP_ERR_NOT_SUPPORTED, clear, TAG, "Unsupported pixel width");
         }
@@ -358,9 +1222,55 @@ esp_err_t esp_lcd_new_panel_pt6891(const esp_lcd_panel_io_handle_t panel_io_hand
     pt6891_panel -> panel_io_handle = panel_io_handle;
     pt6891_panel -> reset_gpio_num = panel_dev_config -> reset_gpio_num;
     pt6891_panel -> reset_level = panel_dev_config -> flags.reset_active_high;
+    pt6891_panel -> row_len_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> com_per_row = 1;
+    pt6891_panel -> clk_div_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> brightness_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> gamma_val = REG_VAL_UNKNOWN;
+    pt6891_panel -> flush_lock = (portMUX_TYPE) portMUX_INITIALIZER_UNLOCKED;
+    pt6891_panel -> int_gpio_num = -1;
     if (panel_dev_config -> vendor_config) {
         pt6891_panel -> init_cmds = ((pt6891_oled_vendor_init_t*) (panel_dev_config -> vendor_config)) -> init_cmds;
         pt6891_panel -> init_cmds_size = ((pt6891_oled_vendor_init_t*) (panel_dev_config -> vendor_config)) -> num_init_cmds;
+        if (((pt6891_oled_vendor_init_t*) (panel_dev_config -> vendor_config)) -> flags.use_int) {
+            // Opt-in, a zero-initialized config would otherwise take GPIO0, a strapping pin
+            pt6891_panel -> int_gpio_num = ((pt6891_oled_vendor_init_t*) (panel_dev_config -> vendor_config)) -> int_gpio_num;
+        }
+        delta_flush = ((pt6891_oled_vendor_init_t*) (panel_dev_config -> vendor_config)) -> flags.delta_flush;
+    }
+
+    if (delta_flush) {
+        ESP_GOTO_ON_FALSE(pt6891_panel -> fb_bits_per_pixel >= 16, ESP_ERR_NOT_SUPPORTED, clear, TAG, "Delta flush needs a color mode");
+        size_t frame_size = PANEL_WIDTH * PANEL_HEIGHT * pt6891_panel -> fb_bits_per_pixel / 8;
+        pt6891_panel -> shadow = calloc(1, frame_size);
+        ESP_GOTO_ON_FALSE(pt6891_panel -> shadow, ESP_ERR_NO_MEM, clear, TAG, "No MEM for shadow frame buffer");
+        for (int i = 0; i < BOUNCE_NUM; i++) {
+            pt6891_panel -> delta_bounce[i] = heap_caps_malloc(frame_size, MALLOC_CAP_DMA);
+            ESP_GOTO_ON_FALSE(pt6891_panel -> delta_bounce[i], ESP_ERR_NO_MEM, clear, TAG, "No MEM for delta bounce buffer");
+        }
+    }
+
+    if (pt6891_panel -> colmod_val == OLED_CMD_COLOR_MONO_64 || pt6891_panel -> colmod_val == OLED_CMD_COLOR_MONO_2) {
+        // Every flush is expanded into a bounce buffer, sized for a full 64-Gray frame
+        pt6891_panel -> com_per_row = MONO_COM_PER_ROW;
+        for (int i = 0; i < BOUNCE_NUM; i++) {
+            pt6891_panel -> bounce[i] = heap_caps_malloc(PANEL_WIDTH * PANEL_HEIGHT * MONO_COM_PER_ROW, MALLOC_CAP_DMA);
+            ESP_GOTO_ON_FALSE(pt6891_panel -> bounce[i], ESP_ERR_NO_MEM, clear, TAG, "No MEM for mono bounce buffer");
+        }
+    }
+
+    if (pt6891_panel -> int_gpio_num > -1) {
+        gpio_config_t panel_int_gpio_config = {
+            .pin_bit_mask = 1ULL << pt6891_panel -> int_gpio_num,
+            .mode = GPIO_MODE_INPUT,
+            .intr_type = GPIO_INTR_POSEDGE,
+        };
+        ESP_GOTO_ON_ERROR(gpio_config(&panel_int_gpio_config), clear, TAG, "Configure GPIO for INT failed");
+        // The ISR service may already be installed by the application
+        ret = gpio_install_isr_service(0);
+        ESP_GOTO_ON_FALSE(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE, ret, clear, TAG, "Install GPIO ISR service failed");
+        ESP_GOTO_ON_ERROR(gpio_isr_handler_add(pt6891_panel -> int_gpio_num, panel_pt6891_int_isr, pt6891_panel), clear, TAG, "Add INT ISR failed");
+        ret = ESP_OK;
     }
 
     *panel_handle = &(pt6891_panel -> base);
@@ -375,6 +1285,12 @@ clear:
         if (panel_dev_config -> reset_gpio_num > -1) {
             gpio_set_level(panel_dev_config -> reset_gpio_num, panel_dev_config -> flags.reset_active_high);
         }
+        for (int i = 0; i < BOUNCE_NUM; i++) {
+            free(pt6891_panel -> bounce[i]);
+            free(pt6891_panel -> delta_bounce[i]);
+        }
+        free(pt6891_panel -> shadow);
+        free(pt6891_panel);
     }
     
     return ret;
@@ -0,0 +1,434 @@
+/**
+ * Flush throughput benchmark: lv_demo_benchmark is rendered on the host, flushed
+ * through the real driver into the fake panel IO, and decoded by the PT6891
+ * emulator. Every frame on the emulated glass is compared with what LVGL
+ * rendered, the wire traffic is reported per scene.
+ * 
+ *   bench_flush [--delta] [--stripe-rows N] [--flush-cost N] [--band] [--cull] [--threads] [--telemetry] [--max-us-per-frame N]
+ * 
+ * LVGL gets two draw buffers of --stripe-rows rows, half the screen by default
+ * as in main/service_display.c: the next stripe is rendered while the previous
+ * one is on the wire, and the fake ends its DMA only when LVGL waits for it,
+ * so a buffer reused too early shows up on the glass.
+ * 
+ * --flush-cost sets the flush_cost of the display driver in pixels, 0 joins
+ * invalidated areas as stock LVGL.
+ * 
+ * --band sets band_refresh: the rows of the invalidated areas are rendered
+ * once, band by band. The host CPU time spent in lv_timer_handler is reported
+ * per frame to compare the renderers.
+ * 
+ * --cull sets cull_occluded: the parts of objects hidden by opaque objects
+ * drawn later are not drawn. The overdraw (pixels written per pixel flushed)
+ * is reported.
+ * 
+ * --threads runs the pipeline of LVGL_SPLIT_CORES: LVGL renders on the main
+ * thread and pushes stripes into a flush_queue, a flush thread sends them.
+ * 
+ * --telemetry records the refresh phases into a frame_telemetry as
+ * LVGL_TELEMETRY does, and reports the host time of each phase per frame.
+ * 
+ * Exits with 1 if a frame on the glass differs from LVGL, or if the average
+ * simulated SPI time per frame is above the given budget.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "lvgl.h"
+#include "lv_demos.h"
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+
+#include "fake_panel_io.h"
+#include "pt6891_emu.h"
+#include "test_check.h"
+#include "flush_queue.h"
+#include "frame_telemetry.h"
+
+#define BENCH_WIDTH 95
+#define BENCH_HEIGHT 28
+#define BENCH_STRIPE_ROWS (BENCH_HEIGHT / 2)    // LVGL_STRIPE_ROWS of main/service_display.c
+#define BENCH_FLUSH_COST 64                     // LVGL_FLUSH_COST of main/service_display.c
+
+#define BENCH_SPI_CLOCK_HZ (27 * 1000 * 1000)  // OLED_CLOCK_HZ of main/service_display.c
+#define BENCH_TRANS_OVERHEAD_US 8               // Estimated cost of one SPI master transaction beyond its bits: queueing, CS, DC and DMA setup
+#define BENCH_TIMEOUT_MS (10 * 60 * 1000)       // Simulated time, the demo needs about 2 s per scene
+#define BENCH_MAX_SCENES 128    // The demo has 49 scenes, each run plain and with opacity
+
+/**
+ * @brief Wire Traffic of One Scene
+ * 
+ */
+typedef struct {
+    char name[48];          // Title of the demo, "N/M: name"
+    uint32_t frames;        // Refreshes that flushed something
+    uint64_t transactions;
+    uint64_t wire_bytes;
+    uint64_t ramwr_bytes;
+} bench_scene_t;
+
+static bench_scene_t scenes[BENCH_MAX_SCENES];
+static int num_scenes;
+
+static esp_lcd_panel_handle_t panel_handle;
+static lv_disp_drv_t disp_drv;
+static lv_disp_draw_buf_t disp_draw_buf;
+static lv_color_t buf1[BENCH_WIDTH * BENCH_HEIGHT];
+static lv_color_t buf2[BENCH_WIDTH * BENCH_HEIGHT];
+
+static uint16_t expected[BENCH_HEIGHT][BENCH_WIDTH]; // What LVGL flushed, as it should be on the glass
+static bool frame_done;
+static double render_us;                // Host CPU time in lv_timer_handler
+static uint64_t render_parts;           // flush_cb calls, each one a walk of the object tree
+static bool threads;                    // Flush from flush_thread, through flush_queue
+static flush_queue_t flush_queue;
+static atomic_bool flush_thread_stop;
+static bool demo_finished;
+static uint32_t mismatched_frames;
+static frame_telemetry_t telemetry;
+static uint32_t telemetry_seq;                          // Next frame to read from telemetry
+static uint32_t telemetry_frames;
+static uint64_t telemetry_phase_us[FRAME_PHASE_NUM];    // Sum of the frames read
+static uint32_t telemetry_render_max_us;
+
+static int64_t bench_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Same mapping as lvgl_refr_phase of main/service_display.c, without the memory stats
+static void bench_refr_phase(lv_disp_drv_t* drv, lv_disp_refr_phase_t phase, bool end, const lv_area_t* area) {
+    int64_t now_us = bench_now_us();
+    if (phase == LV_DISP_REFR_PHASE_REFR) {
+        if (end) {
+            frame_telemetry_end(&telemetry, now_us);
+        } else {
+            frame_telemetry_begin(&telemetry, now_us);
+        }
+    } else if (end) {
+        frame_telemetry_phase_end(&telemetry, phase - LV_DISP_REFR_PHASE_LAYOUT, now_us, area ? lv_area_get_size(area) : 0);
+    } else {
+        frame_telemetry_phase_begin(&telemetry, phase - LV_DISP_REFR_PHASE_LAYOUT, now_us);
+    }
+}
+
+static void bench_telemetry_read(void) {
+    frame_record_t records[8];
+    size_t count;
+    while ((count = frame_telemetry_read(&telemetry, &telemetry_seq, records, 8)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            telemetry_frames++;
+            for (int phase = 0; phase < FRAME_PHASE_NUM; phase++) {
+                telemetry_phase_us[phase] += records[i].phase_us[phase];
+            }
+            telemetry_render_max_us = LV_MAX(telemetry_render_max_us, records[i].render_max_us);
+        }
+    }
+}
+
+static bool bench_flush_done(esp_lcd_panel_handle_t panel, void* user_ctx) {
+    (void) panel;
+    lv_disp_flush_ready((lv_disp_drv_t*) user_ctx);
+
+    return false;
+}
+
+static void bench_flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p) {
+    int w = lv_area_get_width(area);
+
+    render_parts++;
+    for (int y = area -> y1; y <= area -> y2; y++) {
+        for (int x = area -> x1; x <= area -> x2; x++) {
+            expected[y][x] = color_p[(y - area -> y1) * w + x - area -> x1].full;
+        }
+    }
+    if (lv_disp_flush_is_last(drv)) {
+        frame_done = true;
+    }
+
+    if (threads) {
+        flush_stripe_t stripe = {area -> x1, area -> y1, area -> x2, area -> y2, color_p, lv_disp_flush_is_last(drv)};
+        while (!flush_queue_push(&flush_queue, &stripe)) {
+            sched_yield();
+        }
+        return;
+    }
+    esp_lcd_panel_draw_bitmap(panel_handle, area -> x1, area -> y1, area -> x2, area -> y2, color_p);
+}
+
+static void* flush_thread(void* arg) {
+    // The only user of the panel, the fake panel IO and the emulator while threads run
+    while (!atomic_load(&flush_thread_stop)) {
+        const flush_stripe_t* stripe = flush_queue_front(&flush_queue);
+        if (stripe == NULL) {
+            sched_yield();
+            continue;
+        }
+        esp_lcd_panel_draw_bitmap(panel_handle, stripe -> x_start, stripe -> y_start, stripe -> x_end, stripe -> y_end, stripe -> data);
+        // Let LVGL render a while before the DMA ends
+        sched_yield();
+        fake_panel_io_complete_color(fake_panel_io_color_inflight());
+        flush_queue_pop(&flush_queue);
+    }
+
+    return NULL;
+}
+
+static void bench_wait(lv_disp_drv_t* drv) {
+    if (threads) {
+        sched_yield();
+        return;
+    }
+    // LVGL waits for the previous area before reusing its buffer, the DMA of the fake ends on demand
+    if (fake_panel_io_complete_color(1) == 0 && drv -> draw_buf -> flushing) {
+        fprintf(stderr, "bench_flush: flush never reported done\n");
+        exit(1);
+    }
+}
+
+static void bench_finished(void) {
+    demo_finished = true;
+}
+
+static bench_scene_t* bench_scene(void) {
+    lv_obj_t* title = lv_obj_get_child(lv_scr_act(), 0);
+    const char* name = title ? lv_label_get_text(title) : "";
+
+    for (int i = 0; i < num_scenes; i++) {
+        if (strncmp(scenes[i].name, name, sizeof(scenes[i].name) - 1) == 0) {
+            return &scenes[i];
+        }
+    }
+    TEST_CHECK(num_scenes < BENCH_MAX_SCENES);
+    bench_scene_t* scene = &scenes[num_scenes++];
+    strncpy(scene -> name, name, sizeof(scene -> name) - 1);
+
+    return scene;
+}
+
+static bool bench_check_frame(void) {
+    for (int y = 0; y < BENCH_HEIGHT; y++) {
+        for (int x = 0; x < BENCH_WIDTH; x++) {
+            // The low byte of the frame buffer goes first on the wire
+            uint32_t wire = ((expected[y][x] & 0xFF) << 8) | (expected[y][x] >> 8);
+            if (pt6891_emu_pixel(x, y) != wire) {
+                fprintf(stderr, "bench_flush: pixel (%d, %d) is 0x%04"PRIX32" on the glass, 0x%04"PRIX32" expected\n", x, y, pt6891_emu_pixel(x, y), wire);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static double bench_spi_us(uint64_t transactions, uint64_t wire_bytes) {
+    return wire_bytes * 8 * 1e6 / BENCH_SPI_CLOCK_HZ + transactions * BENCH_TRANS_OVERHEAD_US;
+}
+
+static void bench_total(bench_scene_t* total) {
+    memset(total, 0, sizeof(bench_scene_t));
+    strcpy(total -> name, "Total");
+    for (int i = 0; i < num_scenes; i++) {
+        total -> frames += scenes[i].frames;
+        total -> transactions += scenes[i].transactions;
+        total -> wire_bytes += scenes[i].wire_bytes;
+        total -> ramwr_bytes += scenes[i].ramwr_bytes;
+    }
+}
+
+static void bench_print(const bench_scene_t* scene) {
+    if (scene -> frames == 0) {
+        return;
+    }
+    printf("%-40s %7"PRIu32" %12.1f %12.1f %12.1f\n", scene -> name, scene -> frames,
+        (double) scene -> transactions / scene -> frames,
+        (double) scene -> wire_bytes / scene -> frames,
+        bench_spi_us(scene -> transactions, scene -> wire_bytes) / scene -> frames);
+}
+
+static void bench_report(bool delta_flush, bool band, bool cull, int stripe_rows, int flush_cost, const bench_scene_t* total) {
+    printf("Flush mode: %s, %s refresh%s, draw buffers of %d rows, flush cost of %d pixels, SPI at %d MHz, %d us per transaction\n\n", delta_flush ? "delta" : "full", band ? "band" : "area", cull ? " with occlusion culling" : "", stripe_rows, flush_cost, BENCH_SPI_CLOCK_HZ / 1000000, BENCH_TRANS_OVERHEAD_US);
+    printf("%-40s %7s %12s %12s %12s\n", "Scene", "Frames", "Trans/frame", "Bytes/frame", "SPI us/frame");
+    for (int i = 0; i < num_scenes; i++) {
+        bench_print(&scenes[i]);
+    }
+    printf("\n");
+    bench_print(total);
+    if (total->frames) {
+        printf("\nRendered parts: %.2f per frame, host render time: %.1f us per frame\n", (double) render_parts / total->frames, render_us / total->frames);
+    }
+    uint32_t drawn_px;
+    uint32_t flushed_px;
+    lv_refr_get_overdraw(&drawn_px, &flushed_px);
+    if (flushed_px) {
+        printf("Overdraw: %.1f%% (%"PRIu32" pixels written, %"PRIu32" flushed)\n", (drawn_px - (double) flushed_px) * 100 / flushed_px, drawn_px, flushed_px);
+    }
+    if (telemetry_frames) {
+        printf("Telemetry: %"PRIu32" frames, host us per frame:", telemetry_frames);
+        for (int phase = 0; phase < FRAME_PHASE_NUM; phase++) {
+            printf(" %s %.1f", frame_telemetry_phase_name(phase), (double) telemetry_phase_us[phase] / telemetry_frames);
+        }
+        printf(", longest area render %"PRIu32" us\n", telemetry_render_max_us);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool delta_flush = false;
+    bool band = false;
+    bool cull = false;
+    bool telemetry_on = false;
+    int stripe_rows = BENCH_STRIPE_ROWS;
+    int flush_cost = BENCH_FLUSH_COST;
+    double max_us_per_frame = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--delta") == 0) {
+            delta_flush = true;
+        } else if (strcmp(argv[i], "--band") == 0) {
+            band = true;
+        } else if (strcmp(argv[i], "--cull") == 0) {
+            cull = true;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threads = true;
+        } else if (strcmp(argv[i], "--telemetry") == 0) {
+            telemetry_on = true;
+        } else if (strcmp(argv[i], "--stripe-rows") == 0 && i + 1 < argc) {
+            stripe_rows = atoi(argv[++i]);
+            stripe_rows = LV_CLAMP(1, stripe_rows, BENCH_HEIGHT);
+        } else if (strcmp(argv[i], "--flush-cost") == 0 && i + 1 < argc) {
+            flush_cost = atoi(argv[++i]);
+            flush_cost = LV_MAX(flush_cost, 0);
+        } else if (strcmp(argv[i], "--max-us-per-frame") == 0 && i + 1 < argc) {
+            max_us_per_frame = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--delta] [--stripe-rows N] [--flush-cost N] [--band] [--cull] [--threads] [--telemetry] [--max-us-per-frame N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Same panel setup as main/service_display.c
+    pt6891_emu_reset();
+    pt6891_oled_vendor_init_t vendor_config = {
+        .int_gpio_num = -1,
+        .flags.delta_flush = delta_flush,
+    };
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+        .vendor_config = &vendor_config,
+    };
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(pt6891_register_flush_done_cb(panel_handle, bench_flush_done, &disp_drv) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_reset(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, false, true) == ESP_OK);
+
+    lv_init();
+    lv_disp_draw_buf_init(&disp_draw_buf, buf1, buf2, BENCH_WIDTH * stripe_rows);
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = BENCH_WIDTH;
+    disp_drv.ver_res = BENCH_HEIGHT;
+    disp_drv.draw_buf = &disp_draw_buf;
+    disp_drv.flush_cb = bench_flush;
+    disp_drv.wait_cb = bench_wait;
+    disp_drv.flush_cost = flush_cost;
+    disp_drv.band_refresh = band;
+    disp_drv.cull_occluded = cull;
+    if (telemetry_on) {
+        frame_telemetry_init(&telemetry);
+        disp_drv.refr_phase_cb = bench_refr_phase;
+    }
+    lv_disp_drv_register(&disp_drv);
+
+    lv_demo_benchmark_set_finished_cb(bench_finished);
+    lv_demo_benchmark();
+
+    // Init traffic is not part of any scene
+    fake_panel_io_clear();
+    pt6891_emu_clear_stats();
+    render_parts = 0;
+    lv_refr_reset_overdraw_counter();
+    telemetry_seq = telemetry.next_seq;
+
+    pthread_t flush_thread_handle;
+    if (threads) {
+        flush_queue_init(&flush_queue);
+        TEST_CHECK(pthread_create(&flush_thread_handle, NULL, flush_thread, NULL) == 0);
+    }
+
+    uint32_t time_ms;
+    for (time_ms = 0; !demo_finished && time_ms < BENCH_TIMEOUT_MS; time_ms++) {
+        lv_tick_inc(1);
+        clock_t render_start = clock();
+        lv_timer_handler();
+        render_us += (double)(clock() - render_start) * 1e6 / CLOCKS_PER_SEC;
+        if (telemetry_on) {
+            bench_telemetry_read();
+        }
+
+        if (!frame_done) {
+            continue;
+        }
+        // The last area is on the wire until its DMA ends
+        frame_done = false;
+        if (threads) {
+            while (!flush_queue_empty(&flush_queue)) {
+                sched_yield();
+            }
+        } else {
+            fake_panel_io_complete_color(fake_panel_io_color_inflight());
+        }
+        fake_panel_io_clear();
+
+        pt6891_emu_stats_t stats;
+        pt6891_emu_get_stats(&stats);
+        pt6891_emu_clear_stats();
+        bench_scene_t* scene = bench_scene();
+        scene -> frames++;
+        scene -> transactions += stats.transactions;
+        scene -> wire_bytes += stats.wire_bytes;
+        scene -> ramwr_bytes += stats.ramwr_bytes;
+
+        if (!bench_check_frame()) {
+            fprintf(stderr, "bench_flush: frame %"PRIu32" of \"%s\" differs on the glass\n", scene -> frames, scene -> name);
+            mismatched_frames++;
+        }
+    }
+
+    if (threads) {
+        atomic_store(&flush_thread_stop, true);
+        TEST_CHECK(pthread_join(flush_thread_handle, NULL) == 0);
+    }
+
+    bench_scene_t total;
+    bench_total(&total);
+    bench_report(delta_flush, band, cull, stripe_rows, flush_cost, &total);
+
+    if (!demo_finished) {
+        fprintf(stderr, "bench_flush: the demo did not finish in %d ms\n", BENCH_TIMEOUT_MS);
+        return 1;
+    }
+    if (mismatched_frames) {
+        fprintf(stderr, "bench_flush: %"PRIu32" frames differ on the glass\n", mismatched_frames);
+        return 1;
+    }
+
+    double us_per_frame = total.frames ? bench_spi_us(total.transactions, total.wire_bytes) / total.frames : 0;
+    if (max_us_per_frame > 0 && us_per_frame > max_us_per_frame) {
+        fprintf(stderr, "bench_flush: %.1f us per frame, over the budget of %.1f us\n", us_per_frame, max_us_per_frame);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,45 @@
+/**
+ * LVGL configuration of the host flush benchmark, the values that matter for
+ * rendering follow sdkconfig of the firmware, everything else is the default
+ * of lv_conf_internal.h
+ */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#include <stdint.h>
+
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_16_SWAP 0
+
+#define LV_MEM_SIZE (32U * 1024U)
+
+#define LV_DISP_DEF_REFR_PERIOD 30
+#define LV_INDEV_DEF_READ_PERIOD 30
+#define LV_DPI_DEF 130
+
+#define LV_DRAW_COMPLEX 1
+#define LV_SHADOW_CACHE_DEF_SIZE 8192
+#define LV_CIRCLE_CACHE_DEF_SIZE 4096
+#define LV_LAYER_SIMPLE_BUF_SIZE (24 * 1024)
+#define LV_IMG_CACHE_DEF_SIZE 0
+#define LV_GRADIENT_MAX_STOPS 2
+#define LV_GRAD_CACHE_DEF_SIZE 0
+#define LV_DISP_ROT_MAX_BUF (10 * 1024)
+
+// A failed assert ends the benchmark instead of spinning forever
+#define LV_USE_ASSERT_NULL 1
+#define LV_USE_ASSERT_MALLOC 1
+#define LV_ASSERT_HANDLER_INCLUDE <stdlib.h>
+#define LV_ASSERT_HANDLER abort();
+
+// The monitor label would count as flushed content of every frame
+#define LV_USE_PERF_MONITOR 0
+
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_14
+
+#define LV_USE_DEMO_BENCHMARK 1
+#define LV_DEMO_BENCHMARK_RGB565A8 1
+
+#endif // LV_CONF_H
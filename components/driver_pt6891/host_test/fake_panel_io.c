@@ -0,0 +1,260 @@
+#include "fake_panel_io.h"
+#include "pt6891_emu.h"
+
+#include <string.h>
+
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_interface.h"
+
+struct esp_lcd_panel_io_t {
+    fake_panel_io_trans_t log[FAKE_PANEL_IO_MAX_TRANS];
+    size_t num_trans;
+    bool fail;                  // Fail transactions once num_trans reaches fail_at
+    size_t fail_at;
+    fake_panel_io_trans_t inflight[FAKE_PANEL_IO_MAX_INFLIGHT]; // Queued tx_color, decoded by the emulator when done
+    size_t inflight_head;
+    size_t color_inflight;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void* user_ctx;
+};
+
+static struct esp_lcd_panel_io_t fake_io;
+
+static esp_err_t fake_panel_io_record(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void* data, size_t data_bytes, bool color) {
+    if (io != &fake_io) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (io -> num_trans >= FAKE_PANEL_IO_MAX_TRANS) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (io -> fail && io -> num_trans >= io -> fail_at) {
+        return ESP_FAIL;
+    }
+
+    fake_panel_io_trans_t* trans = &io -> log[io -> num_trans++];
+    memset(trans, 0, sizeof(fake_panel_io_trans_t));
+    trans -> cmd = lcd_cmd;
+    trans -> color = color;
+    trans -> data_bytes = data_bytes;
+    trans -> data = data;
+    if (data) {
+        memcpy(trans -> param, data, data_bytes < FAKE_PANEL_IO_MAX_PARAM ? data_bytes : FAKE_PANEL_IO_MAX_PARAM);
+    }
+
+    return ESP_OK;
+}
+
+esp_lcd_panel_io_handle_t fake_panel_io_get(void) {
+    return &fake_io;
+}
+
+void fake_panel_io_clear(void) {
+    fake_io.num_trans = 0;
+    fake_io.fail = false;
+}
+
+void fake_panel_io_fail_after(size_t num) {
+    fake_io.fail = true;
+    fake_io.fail_at = fake_io.num_trans + num;
+}
+
+size_t fake_panel_io_num_trans(void) {
+    return fake_io.num_trans;
+}
+
+const fake_panel_io_trans_t* fake_panel_io_trans(size_t index) {
+    if (index >= fake_io.num_trans) {
+        return NULL;
+    }
+
+    return &fake_io.log[index];
+}
+
+size_t fake_panel_io_color_inflight(void) {
+    return fake_io.color_inflight;
+}
+
+size_t fake_panel_io_complete_color(size_t num) {
+    size_t num_done = 0;
+
+    while (num_done < num && fake_io.color_inflight) {
+        const fake_panel_io_trans_t* trans = &fake_io.inflight[fake_io.inflight_head];
+        pt6891_emu_feed(trans -> cmd, trans -> data, trans -> data_bytes);
+        fake_io.inflight_head = (fake_io.inflight_head + 1) % FAKE_PANEL_IO_MAX_INFLIGHT;
+        fake_io.color_inflight--;
+        num_done++;
+        if (fake_io.on_color_trans_done) {
+            fake_io.on_color_trans_done(&fake_io, NULL, fake_io.user_ctx);
+        }
+    }
+
+    return num_done;
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void* param, size_t param_size) {
+    // Polling transactions wait for the queued ones first
+    fake_panel_io_complete_color(fake_io.color_inflight);
+    // Nothing goes on the bus without command nor parameters
+    if (lcd_cmd < 0 && param_size == 0) {
+        return io == &fake_io ? ESP_OK : ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = fake_panel_io_record(io, lcd_cmd, param, param_size, false);
+    if (ret == ESP_OK) {
+        pt6891_emu_feed(lcd_cmd, param, param_size);
+    }
+
+    return ret;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void* color, size_t color_size) {
+    // A full queue blocks until the oldest transaction is done
+    if (fake_io.color_inflight == FAKE_PANEL_IO_MAX_INFLIGHT) {
+        fake_panel_io_complete_color(1);
+    }
+    esp_err_t ret = fake_panel_io_record(io, lcd_cmd, color, color_size, true);
+    if (ret == ESP_OK) {
+        io -> inflight[(io -> inflight_head + io -> color_inflight) % FAKE_PANEL_IO_MAX_INFLIGHT] = io -> log[io -> num_trans - 1];
+        io -> color_inflight++;
+    }
+
+    return ret;
+}
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_io_callbacks_t* cbs, void* user_ctx) {
+    if (io != &fake_io || cbs == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    io -> on_color_trans_done = cbs -> on_color_trans_done;
+    io -> user_ctx = user_ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel) {
+    return panel -> reset(panel);
+}
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel) {
+    return panel -> init(panel);
+}
+
+esp_err_t esp_lcd_panel_del(esp_lcd_panel_handle_t panel) {
+    return panel -> del(panel);
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void* color_data) {
+    return panel -> draw_bitmap(panel, x_start, y_start, x_end, y_end, color_data);
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x, bool mirror_y) {
+    return panel -> mirror(panel, mirror_x, mirror_y);
+}
+
+esp_err_t esp_lcd_panel_swap_xy(esp_lcd_panel_handle_t panel, bool swap_axes) {
+    return panel -> swap_xy(panel, swap_axes);
+}
+
+esp_err_t esp_lcd_panel_set_gap(esp_lcd_panel_handle_t panel, int x_gap, int y_gap) {
+    return panel -> set_gap(panel, x_gap, y_gap);
+}
+
+esp_err_t esp_lcd_panel_invert_color(esp_lcd_panel_handle_t panel, bool invert_color_data) {
+    return panel -> invert_color(panel, invert_color_data);
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel, bool on_off) {
+    return panel -> disp_on_off(panel, on_off);
+}
+
+esp_err_t esp_lcd_panel_disp_sleep(esp_lcd_panel_handle_t panel, bool sleep) {
+    return panel -> disp_sleep(panel, sleep);
+}
+
+esp_err_t gpio_config(const gpio_config_t* config) {
+    (void) config;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(int gpio_num, uint32_t level) {
+    (void) gpio_num;
+    (void) level;
+    return ESP_OK;
+}
+
+void vTaskDelay(const TickType_t ticks) {
+    (void) ticks;
+}
+
+void esp_rom_delay_us(uint32_t us) {
+    (void) us;
+}
+
+// INT line: one ISR, one fake task, notifications are counted and never block
+
+static gpio_isr_t fake_isr = NULL;
+static void* fake_isr_arg = NULL;
+static int64_t fake_time_us = 0;
+static uint32_t fake_notify_count = 0;
+static int fake_task;
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags) {
+    (void) intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(int gpio_num, gpio_isr_t isr_handler, void* args) {
+    (void) gpio_num;
+    fake_isr = isr_handler;
+    fake_isr_arg = args;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(int gpio_num) {
+    (void) gpio_num;
+    fake_isr = NULL;
+    fake_isr_arg = NULL;
+    return ESP_OK;
+}
+
+bool fake_panel_io_int_edge(int64_t time_us) {
+    if (fake_isr == NULL) {
+        return false;
+    }
+    fake_time_us = time_us;
+    fake_isr(fake_isr_arg);
+    return true;
+}
+
+int64_t esp_timer_get_time(void) {
+    return fake_time_us;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return &fake_task;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait) {
+    (void) ticks_to_wait;
+    uint32_t count = fake_notify_count;
+    if (clear_count_on_exit) {
+        fake_notify_count = 0;
+    } else if (count) {
+        fake_notify_count--;
+    }
+    return count;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_task_woken) {
+    (void) task;
+    fake_notify_count++;
+    if (higher_priority_task_woken) {
+        *higher_priority_task_woken = pdTRUE;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef __FAKE_PANEL_IO_H__
+#define __FAKE_PANEL_IO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "esp_lcd_types.h"
+
+#define FAKE_PANEL_IO_MAX_TRANS 1024
+#define FAKE_PANEL_IO_MAX_PARAM 4
+#define FAKE_PANEL_IO_MAX_INFLIGHT 16
+
+/**
+ * @brief One Recorded Panel IO Transaction
+ * 
+ */
+typedef struct {
+    int cmd;                                // The Command Sent
+    bool color;                             // Sent by tx_color (true) or tx_param (false)
+    size_t data_bytes;                      // The number of bytes following the command
+    uint8_t param[FAKE_PANEL_IO_MAX_PARAM]; // First bytes of the parameters
+    const void* data;                       // Caller buffer, only valid while the caller keeps it
+} fake_panel_io_trans_t;
+
+/**
+ * @brief Get the fake Panel IO handle, the fake records every transaction into a log
+ * 
+ * Every transaction is also fed to the PT6891 emulator once done, see pt6891_emu.h
+ * 
+ * @return esp_lcd_panel_io_handle_t 
+ */
+esp_lcd_panel_io_handle_t fake_panel_io_get(void);
+
+/**
+ * @brief Clear the transaction log
+ * 
+ */
+void fake_panel_io_clear(void);
+
+/**
+ * @brief Let the next num transactions succeed, fail the following ones with ESP_FAIL until the next clear
+ * 
+ * @param num Number of transactions still accepted
+ */
+void fake_panel_io_fail_after(size_t num);
+
+/**
+ * @brief Number of transactions recorded since the last clear
+ * 
+ * @return size_t 
+ */
+size_t fake_panel_io_num_trans(void);
+
+/**
+ * @brief Get a recorded transaction
+ * 
+ * @param index Index in the log
+ * @return const fake_panel_io_trans_t* NULL if out of range
+ */
+const fake_panel_io_trans_t* fake_panel_io_trans(size_t index);
+
+/**
+ * @brief Number of tx_color transactions queued and not done yet
+ * 
+ * Queued transactions are done by fake_panel_io_complete_color, or all at once by the next tx_param as in ESP-IDF,
+ * a tx_color on a full queue finishes the oldest one first
+ * 
+ * @return size_t 
+ */
+size_t fake_panel_io_color_inflight(void);
+
+/**
+ * @brief Finish the oldest queued tx_color transactions, runs on_color_trans_done for each
+ * 
+ * @param num Number of transactions to finish
+ * @return size_t Number actually finished
+ */
+size_t fake_panel_io_complete_color(size_t num);
+
+/**
+ * @brief Raise an edge on the fake INT GPIO, runs the registered ISR as if called at time_us
+ * 
+ * @param time_us Value returned by esp_timer_get_time during the ISR
+ * @return bool false if no ISR is registered
+ */
+bool fake_panel_io_int_edge(int64_t time_us);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __FAKE_PANEL_IO_H__
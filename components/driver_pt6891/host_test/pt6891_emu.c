@@ -0,0 +1,213 @@
+#include "pt6891_emu.h"
+
+#include <string.h>
+
+#include "oled_panel_cmds.h"
+#include "pt6891_glass.h"
+
+/**
+ * @brief Emulated PT6891 Controller
+ * 
+ * Only what the driver drives is emulated: the RAM window, the color mode and the mirror
+ * 
+ */
+typedef struct {
+    uint32_t ram[PT6891_EMU_RAM_ROWS][PT6891_EMU_RAM_COLS];
+    int row_addr;           // ROWADDR
+    int col_addr;           // COLADDR
+    int row_len;            // ROWLEN
+    int colmod;             // Last color mode command
+    bool mirror_x;
+    bool mirror_y;
+    bool ram_writing;       // Data without command continues the last RAMWR
+    int row;                // Write pointer
+    int col;
+    int pending_bytes;      // Bytes of a pixel split across transactions
+    uint8_t pending[3];
+    pt6891_emu_stats_t stats;
+} pt6891_emu_t;
+
+static pt6891_emu_t emu;
+
+static int pt6891_emu_bytes_per_pixel(void) {
+    switch (emu.colmod) {
+        case OLED_CMD_COLOR_RGB666: return 3;
+        case OLED_CMD_COLOR_RGB565: return 2;
+        default: return 1;
+    }
+}
+
+static void pt6891_emu_put(uint32_t value) {
+    if (emu.row >= PT6891_EMU_RAM_ROWS) {
+        emu.row = 0;
+        emu.stats.ram_overruns++;
+    }
+    if (emu.col < PT6891_EMU_RAM_COLS) {
+        emu.ram[emu.row][emu.col] = value;
+    }
+    emu.col++;
+}
+
+static void pt6891_emu_wrap_row(void) {
+    // 2-Gray steps 8 columns per byte, the row length is then a multiple of 8 too
+    if (emu.col > emu.col_addr + emu.row_len) {
+        emu.col = emu.col_addr;
+        emu.row++;
+    }
+}
+
+static void pt6891_emu_write_byte(uint8_t byte) {
+    emu.pending[emu.pending_bytes++] = byte;
+    if (emu.pending_bytes < pt6891_emu_bytes_per_pixel()) {
+        return;
+    }
+    emu.pending_bytes = 0;
+
+    switch (emu.colmod) {
+        case OLED_CMD_COLOR_RGB666: {
+            pt6891_emu_put(((emu.pending[0] & 0x3F) << 16) | ((emu.pending[1] & 0x3F) << 8) | (emu.pending[2] & 0x3F));
+            break;
+        }
+        case OLED_CMD_COLOR_RGB565: {
+            pt6891_emu_put((emu.pending[0] << 8) | emu.pending[1]);
+            break;
+        }
+        case OLED_CMD_COLOR_MONO_64: {
+            pt6891_emu_put(emu.pending[0] & 0x3F);
+            break;
+        }
+        case OLED_CMD_COLOR_MONO_2: {
+            // P0 is the pixel at the column address
+            for (int i = 0; i < 8; i++) {
+                pt6891_emu_put((emu.pending[0] >> i) & 0x01);
+            }
+            break;
+        }
+    }
+    pt6891_emu_wrap_row();
+}
+
+static void pt6891_emu_command(int cmd, const uint8_t* param, size_t param_bytes) {
+    emu.ram_writing = false;
+    emu.pending_bytes = 0;
+
+    switch (cmd) {
+        case OLED_CMD_SWRST: {
+            // Registers only, the frame buffer is not cleared
+            emu.row_addr = 0;
+            emu.col_addr = 0;
+            emu.row_len = PT6891_EMU_RAM_COLS - 1;
+            emu.colmod = OLED_CMD_COLOR_RGB666;
+            emu.mirror_x = false;
+            emu.mirror_y = false;
+            break;
+        }
+        case OLED_CMD_ROWADDR: {
+            if (param_bytes) {
+                emu.row_addr = OLED_SET_ROWADDR(param[0]);
+            }
+            break;
+        }
+        case OLED_CMD_COLADDR: {
+            if (param_bytes) {
+                emu.col_addr = OLED_SET_COLADDR(param[0]);
+            }
+            break;
+        }
+        case OLED_CMD_ROWLEN: {
+            if (param_bytes) {
+                emu.row_len = OLED_SET_ROWLEN(param[0]);
+            }
+            break;
+        }
+        case OLED_CMD_COLOR_RGB666:
+        case OLED_CMD_COLOR_RGB565:
+        case OLED_CMD_COLOR_MONO_64:
+        case OLED_CMD_COLOR_MONO_2: {
+            emu.colmod = cmd;
+            break;
+        }
+        case OLED_CMD_MIRROR(0, 0):
+        case OLED_CMD_MIRROR(0, 1):
+        case OLED_CMD_MIRROR(1, 0):
+        case OLED_CMD_MIRROR(1, 1): {
+            emu.mirror_x = cmd & 0x02;
+            emu.mirror_y = cmd & 0x01;
+            break;
+        }
+        case OLED_CMD_RAMWR: {
+            emu.ram_writing = true;
+            emu.row = emu.row_addr;
+            emu.col = emu.col_addr;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+void pt6891_emu_reset(void) {
+    memset(&emu, 0, sizeof(emu));
+    for (int row = 0; row < PT6891_EMU_RAM_ROWS; row++) {
+        for (int col = 0; col < PT6891_EMU_RAM_COLS; col++) {
+            emu.ram[row][col] = PT6891_EMU_UNWRITTEN;
+        }
+    }
+    pt6891_emu_command(OLED_CMD_SWRST, NULL, 0);
+}
+
+void pt6891_emu_feed(int cmd, const void* data, size_t data_bytes) {
+    const uint8_t* bytes = data;
+
+    emu.stats.transactions++;
+    emu.stats.wire_bytes += (cmd >= 0 ? 1 : 0) + data_bytes;
+
+    if (cmd >= 0) {
+        pt6891_emu_command(cmd, bytes, data_bytes);
+    }
+    if (!emu.ram_writing || bytes == NULL) {
+        return;
+    }
+
+    emu.stats.ramwr_bytes += data_bytes;
+    for (size_t i = 0; i < data_bytes; i++) {
+        pt6891_emu_write_byte(bytes[i]);
+    }
+}
+
+uint32_t pt6891_emu_ram(int col, int row) {
+    if (col < 0 || col >= PT6891_EMU_RAM_COLS || row < 0 || row >= PT6891_EMU_RAM_ROWS) {
+        return PT6891_EMU_UNWRITTEN;
+    }
+
+    return emu.ram[row][col];
+}
+
+uint32_t pt6891_emu_pixel(int x, int y) {
+    if (x < 0 || x >= PT6891_EMU_GLASS_WIDTH || y < 0 || y >= PT6891_EMU_GLASS_HEIGHT) {
+        return PT6891_EMU_UNWRITTEN;
+    }
+
+    const int* offsets = pt6891_glass_offsets[emu.mirror_x][emu.mirror_y];
+    int gate = offsets[2];
+    int row = y < gate ? y + PT6891_EMU_GLASS_HEIGHT - gate + offsets[1] : y - gate + offsets[1];
+    int com_per_row = (emu.colmod == OLED_CMD_COLOR_MONO_64 || emu.colmod == OLED_CMD_COLOR_MONO_2) ? MONO_COM_PER_ROW : 1;
+
+    uint32_t value = pt6891_emu_ram(x + offsets[0], row * com_per_row);
+    for (int i = 1; i < com_per_row; i++) {
+        if (pt6891_emu_ram(x + offsets[0], row * com_per_row + i) != value) {
+            return PT6891_EMU_COM_MISMATCH;
+        }
+    }
+
+    return value;
+}
+
+void pt6891_emu_get_stats(pt6891_emu_stats_t* stats) {
+    *stats = emu.stats;
+}
+
+void pt6891_emu_clear_stats(void) {
+    memset(&emu.stats, 0, sizeof(emu.stats));
+}
@@ -0,0 +1,87 @@
+#ifndef __PT6891_EMU_H__
+#define __PT6891_EMU_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define PT6891_EMU_RAM_COLS 128
+#define PT6891_EMU_RAM_ROWS 96 // 32 RGB rows, or 3 COM lines per row in mono mode
+
+#define PT6891_EMU_GLASS_WIDTH 95
+#define PT6891_EMU_GLASS_HEIGHT 28
+
+#define PT6891_EMU_UNWRITTEN 0xFFFFFFFF // Pixel value of RAM never written since pt6891_emu_reset
+#define PT6891_EMU_COM_MISMATCH 0xFFFFFFFE // Pixel value of a row whose COM lines differ in mono mode
+
+/**
+ * @brief Bus Statistics of the Emulated Controller
+ * 
+ */
+typedef struct {
+    uint64_t transactions;  // Transactions on the bus, one per command
+    uint64_t wire_bytes;    // Command bytes and their parameters or pixel data
+    uint64_t ramwr_bytes;   // Pixel data bytes following RAMWR
+    uint64_t ram_overruns;  // Pixels written past the last RAM row, wrapped to row 0
+} pt6891_emu_stats_t;
+
+/**
+ * @brief Power on the emulated controller, the RAM is filled with PT6891_EMU_UNWRITTEN and the statistics are cleared
+ * 
+ */
+void pt6891_emu_reset(void);
+
+/**
+ * @brief Decode one transaction as the controller sees it on the bus
+ * 
+ * The fake panel IO feeds every transaction once it is done, tx_color data is decoded when its transfer finishes
+ * 
+ * @param cmd The command, negative if only data is sent
+ * @param data Parameters or pixel data
+ * @param data_bytes Number of bytes in data
+ */
+void pt6891_emu_feed(int cmd, const void* data, size_t data_bytes);
+
+/**
+ * @brief Read one RAM cell
+ * 
+ * @param col RAM column
+ * @param row RAM row
+ * @return uint32_t RGB565 as sent (first byte high), RGB666 as 0x3F3F3F, mono gray, or PT6891_EMU_UNWRITTEN
+ */
+uint32_t pt6891_emu_ram(int col, int row);
+
+/**
+ * @brief Read the pixel shown on the glass
+ * 
+ * The glass sees a 95x28 part of the RAM depending on the mirror. In mono mode the 3 COM lines of the row
+ * must hold the same value, PT6891_EMU_COM_MISMATCH is returned otherwise.
+ * 
+ * @param x Glass column
+ * @param y Glass row
+ * @return uint32_t Same encoding as pt6891_emu_ram
+ */
+uint32_t pt6891_emu_pixel(int x, int y);
+
+/**
+ * @brief Get the bus statistics since the last pt6891_emu_reset or pt6891_emu_clear_stats
+ * 
+ * @param stats Output
+ */
+void pt6891_emu_get_stats(pt6891_emu_stats_t* stats);
+
+/**
+ * @brief Clear the bus statistics, the RAM and the registers are kept
+ * 
+ */
+void pt6891_emu_clear_stats(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PT6891_EMU_H__
@@ -0,0 +1,8 @@
+#ifndef __ESP_ATTR_H__
+#define __ESP_ATTR_H__
+
+// Host stub of esp_attr.h
+
+#define IRAM_ATTR
+
+#endif // __ESP_ATTR_H__
@@ -0,0 +1,16 @@
+#ifndef __ESP_HEAP_CAPS_H__
+#define __ESP_HEAP_CAPS_H__
+
+// Host stub of esp_heap_caps.h, every capability maps to the system heap
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_DMA          (1 << 3)
+#define MALLOC_CAP_INTERNAL     (1 << 11)
+#define MALLOC_CAP_DEFAULT      (1 << 12)
+
+#define heap_caps_malloc(size, caps)        malloc(size)
+#define heap_caps_calloc(n, size, caps)     calloc(n, size)
+#define heap_caps_free(ptr)                 free(ptr)
+
+#endif // __ESP_HEAP_CAPS_H__
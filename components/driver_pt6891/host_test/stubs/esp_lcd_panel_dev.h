@@ -0,0 +1,18 @@
+#ifndef __ESP_LCD_PANEL_DEV_H__
+#define __ESP_LCD_PANEL_DEV_H__
+
+// Host stub of esp_lcd_panel_dev.h (ESP-IDF v5.3)
+
+#include "esp_lcd_types.h"
+
+typedef struct {
+    int reset_gpio_num;
+    lcd_rgb_element_order_t rgb_ele_order;
+    uint32_t bits_per_pixel;
+    struct {
+        uint32_t reset_active_high: 1;
+    } flags;
+    void* vendor_config;
+} esp_lcd_panel_dev_config_t;
+
+#endif // __ESP_LCD_PANEL_DEV_H__
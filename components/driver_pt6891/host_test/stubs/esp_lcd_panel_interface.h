@@ -0,0 +1,30 @@
+#ifndef __ESP_LCD_PANEL_INTERFACE_H__
+#define __ESP_LCD_PANEL_INTERFACE_H__
+
+// Host stub of esp_lcd_panel_interface.h (ESP-IDF v5.3)
+
+#include <stddef.h>
+
+#include "esp_lcd_types.h"
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type*) ((char*) (ptr) - offsetof(type, member)))
+#endif
+
+typedef struct esp_lcd_panel_t esp_lcd_panel_t;
+
+struct esp_lcd_panel_t {
+    esp_err_t (*reset)(esp_lcd_panel_t* panel);
+    esp_err_t (*init)(esp_lcd_panel_t* panel);
+    esp_err_t (*del)(esp_lcd_panel_t* panel);
+    esp_err_t (*draw_bitmap)(esp_lcd_panel_t* panel, int x_start, int y_start, int x_end, int y_end, const void* color_data);
+    esp_err_t (*mirror)(esp_lcd_panel_t* panel, bool x_axis, bool y_axis);
+    esp_err_t (*swap_xy)(esp_lcd_panel_t* panel, bool swap_axes);
+    esp_err_t (*set_gap)(esp_lcd_panel_t* panel, int x_gap, int y_gap);
+    esp_err_t (*invert_color)(esp_lcd_panel_t* panel, bool invert_color_data);
+    esp_err_t (*disp_on_off)(esp_lcd_panel_t* panel, bool on_off);
+    esp_err_t (*disp_sleep)(esp_lcd_panel_t* panel, bool sleep);
+    void* user_data;
+};
+
+#endif // __ESP_LCD_PANEL_INTERFACE_H__
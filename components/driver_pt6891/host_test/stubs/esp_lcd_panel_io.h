@@ -0,0 +1,16 @@
+#ifndef __ESP_LCD_PANEL_IO_H__
+#define __ESP_LCD_PANEL_IO_H__
+
+// Host stub of esp_lcd_panel_io.h (ESP-IDF v5.3), implemented by fake_panel_io.c
+
+#include "esp_lcd_types.h"
+
+typedef struct {
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+} esp_lcd_panel_io_callbacks_t;
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void* param, size_t param_size);
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void* color, size_t color_size);
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io, const esp_lcd_panel_io_callbacks_t* cbs, void* user_ctx);
+
+#endif // __ESP_LCD_PANEL_IO_H__
@@ -0,0 +1,28 @@
+#ifndef __ESP_LCD_TYPES_H__
+#define __ESP_LCD_TYPES_H__
+
+// Host stub of esp_lcd_types.h (ESP-IDF v5.3)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+typedef struct esp_lcd_panel_io_t* esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t* esp_lcd_panel_handle_t;
+
+typedef enum {
+    COLOR_RGB_ELEMENT_ORDER_RGB,
+    COLOR_RGB_ELEMENT_ORDER_BGR,
+} lcd_rgb_element_order_t;
+
+#define LCD_RGB_ELEMENT_ORDER_RGB COLOR_RGB_ELEMENT_ORDER_RGB
+#define LCD_RGB_ELEMENT_ORDER_BGR COLOR_RGB_ELEMENT_ORDER_BGR
+
+typedef struct {
+} esp_lcd_panel_io_event_data_t;
+
+typedef bool (*esp_lcd_panel_io_color_trans_done_cb_t)(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t* edata, void* user_ctx);
+
+#endif // __ESP_LCD_TYPES_H__
@@ -0,0 +1,13 @@
+#ifndef __ESP_LOG_H__
+#define __ESP_LOG_H__
+
+// Host stub of esp_log.h, debug and info logs are dropped
+
+#include <stdio.h>
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W (%s) " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) do { (void) (tag); } while (0)
+#define ESP_LOGD(tag, fmt, ...) do { (void) (tag); } while (0)
+
+#endif // __ESP_LOG_H__
@@ -0,0 +1,10 @@
+#ifndef __ESP_ROM_SYS_H__
+#define __ESP_ROM_SYS_H__
+
+// Host stub of esp_rom_sys.h (ESP-IDF v5.3), delays are not spent
+
+#include <stdint.h>
+
+void esp_rom_delay_us(uint32_t us);
+
+#endif // __ESP_ROM_SYS_H__
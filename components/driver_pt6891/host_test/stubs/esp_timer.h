@@ -0,0 +1,10 @@
+#ifndef __ESP_TIMER_H__
+#define __ESP_TIMER_H__
+
+// Host stub of esp_timer.h, time is driven by the test through fake_panel_io_int_edge
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif // __ESP_TIMER_H__
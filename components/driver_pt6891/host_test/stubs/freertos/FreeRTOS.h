@@ -0,0 +1,28 @@
+#ifndef __FREERTOS_H__
+#define __FREERTOS_H__
+
+// Host stub of FreeRTOS.h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define portMAX_DELAY       ((TickType_t) 0xFFFFFFFF)
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   ((TickType_t) (ms))
+
+// Single threaded host, critical sections only have to compile
+typedef struct {
+    uint32_t owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    {0}
+#define portENTER_CRITICAL_SAFE(mux)    ((void) (mux))
+#define portEXIT_CRITICAL_SAFE(mux)     ((void) (mux))
+
+#endif // __FREERTOS_H__
@@ -0,0 +1,17 @@
+#ifndef __FREERTOS_TASK_H__
+#define __FREERTOS_TASK_H__
+
+// Host stub of task.h, delays are not slept and notifications never block
+
+#include "freertos/FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+
+#define portYIELD_FROM_ISR()
+
+void vTaskDelay(const TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higher_priority_task_woken);
+
+#endif // __FREERTOS_TASK_H__
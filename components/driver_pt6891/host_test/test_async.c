@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static uint16_t frame[28][95];
+static int num_flush_done;
+
+static bool flush_done(esp_lcd_panel_handle_t panel_handle, void* user_ctx) {
+    (void) panel_handle;
+    (*(int*) user_ctx)++;
+    return false;
+}
+
+static size_t count_ramwr(void) {
+    size_t count = 0;
+    for (size_t i = 0; i < fake_panel_io_num_trans(); i++) {
+        if (fake_panel_io_trans(i) -> cmd == OLED_CMD_RAMWR) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static esp_lcd_panel_handle_t new_panel(bool delta_flush) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    pt6891_oled_vendor_init_t vendor_config = {
+        .int_gpio_num = -1,
+        .flags.delta_flush = delta_flush,
+    };
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+        .vendor_config = &vendor_config,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    // Same orientation as service_display.c
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1) == ESP_OK);
+    TEST_CHECK(pt6891_register_flush_done_cb(panel_handle, flush_done, &num_flush_done) == ESP_OK);
+    num_flush_done = 0;
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static void test_straddle(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(false);
+
+    // Rows 20..27 straddle the gate row (24), two RAM windows and so two transfers
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 20, 94, 27, frame) == ESP_OK);
+    TEST_CHECK(count_ramwr() == 2);
+    // The window commands of the second transfer waited for the first one, the buffer is still being read
+    printf("straddle: %zu transfers in flight\n", fake_panel_io_color_inflight());
+    TEST_CHECK(fake_panel_io_color_inflight() == 1);
+    TEST_CHECK(num_flush_done == 0);
+
+    TEST_CHECK(fake_panel_io_complete_color(1) == 1);
+    TEST_CHECK(num_flush_done == 1);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+static void test_queued(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(false);
+
+    // Second flush is queued before the first one is done, done in order
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 10, 94, 13, frame) == ESP_OK);
+    TEST_CHECK(fake_panel_io_color_inflight() == 1);
+    // Its window commands are polling transfers, they wait for the first flush
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 14, 94, 17, frame) == ESP_OK);
+    TEST_CHECK(num_flush_done == 1);
+    TEST_CHECK(fake_panel_io_complete_color(1) == 1);
+    TEST_CHECK(num_flush_done == 2);
+
+    // Enough flushes to fill the ring without any transfer done in between
+    for (int i = 0; i < 8; i++) {
+        fake_panel_io_clear();
+        TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 10, 94, 13, frame) == ESP_OK);
+    }
+    fake_panel_io_complete_color(fake_panel_io_color_inflight());
+    printf("queued: %d flushes done\n", num_flush_done);
+    TEST_CHECK(num_flush_done == 10);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+static void test_delta_unchanged(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(true);
+
+    memset(frame, 0x5A, sizeof(frame));
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 94, 27, frame) == ESP_OK);
+    fake_panel_io_complete_color(fake_panel_io_color_inflight());
+    TEST_CHECK(num_flush_done == 1);
+
+    // Nothing to send, done before draw_bitmap returns
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 94, 27, frame) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+    TEST_CHECK(num_flush_done == 2);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+int main(void) {
+    test_straddle();
+    test_queued();
+    test_delta_unchanged();
+
+    printf("test_async passed\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static esp_lcd_panel_handle_t new_panel(int bits_per_pixel) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = bits_per_pixel,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static size_t count_cmd(int cmd) {
+    size_t count = 0;
+    for (size_t i = 0; i < fake_panel_io_num_trans(); i++) {
+        if (fake_panel_io_trans(i) -> cmd == cmd) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static void test_brightness_fade(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(16);
+
+    // Full brightness is the white balance of the init commands
+    TEST_CHECK(pt6891_set_brightness(panel_handle, 255) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 1);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_BRIGHT);
+    TEST_CHECK(fake_panel_io_trans(0) -> data_bytes == 3);
+    TEST_CHECK(fake_panel_io_trans(0) -> param[0] == 43);
+    TEST_CHECK(fake_panel_io_trans(0) -> param[1] == 14);
+    TEST_CHECK(fake_panel_io_trans(0) -> param[2] == 26);
+
+    // A 32 step fade out, as an animation would drive it, one transaction per step and never a pixel
+    fake_panel_io_clear();
+    uint8_t last_r = 43;
+    for (int step = 32; step >= 0; step--) {
+        size_t num_trans = fake_panel_io_num_trans();
+        TEST_CHECK(pt6891_set_brightness(panel_handle, step * 255 / 32) == ESP_OK);
+        if (fake_panel_io_num_trans() > num_trans) {
+            TEST_CHECK(fake_panel_io_trans(num_trans) -> param[0] <= last_r);
+            last_r = fake_panel_io_trans(num_trans) -> param[0];
+        }
+    }
+    printf("fade: %zu transactions for 33 steps\n", fake_panel_io_num_trans());
+    // Step 32 is the level already set
+    TEST_CHECK(fake_panel_io_num_trans() == 32);
+    TEST_CHECK(count_cmd(OLED_CMD_BRIGHT) == 32);
+    TEST_CHECK(last_r == 0);
+
+    // Same level again sends nothing
+    fake_panel_io_clear();
+    TEST_CHECK(pt6891_set_brightness(panel_handle, 0) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+
+    // Init sets its own brightness, the next level is sent whatever it is
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    fake_panel_io_clear();
+    TEST_CHECK(pt6891_set_brightness(panel_handle, 0) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 1);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+static void test_gamma_profile(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(16);
+
+    // Three tables, one update
+    TEST_CHECK(pt6891_set_gamma_profile(panel_handle, PT6891_GAMMA_2_2) == ESP_OK);
+    printf("gamma, color: %zu transactions\n", fake_panel_io_num_trans());
+    TEST_CHECK(fake_panel_io_num_trans() == 4);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_GAM_RED);
+    TEST_CHECK(fake_panel_io_trans(1) -> cmd == OLED_CMD_GAM_GREEN);
+    TEST_CHECK(fake_panel_io_trans(2) -> cmd == OLED_CMD_GAM_BLUE);
+    TEST_CHECK(fake_panel_io_trans(3) -> cmd == OLED_CMD_GAM_UPDATE);
+    for (size_t i = 0; i < 3; i++) {
+        const uint8_t* table = fake_panel_io_trans(i) -> data;
+        TEST_CHECK(fake_panel_io_trans(i) -> data_bytes == 64);
+        for (int level = 1; level < 64; level++) {
+            TEST_CHECK(table[level] > table[level - 1]);
+        }
+    }
+
+    fake_panel_io_clear();
+    TEST_CHECK(pt6891_set_gamma_profile(panel_handle, PT6891_GAMMA_2_2) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+    TEST_CHECK(pt6891_set_gamma_profile(panel_handle, PT6891_GAMMA_MAX) == ESP_ERR_INVALID_ARG);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+
+    // Mono modes only use the red table
+    panel_handle = new_panel(6);
+    TEST_CHECK(pt6891_set_gamma_profile(panel_handle, PT6891_GAMMA_LINEAR) == ESP_OK);
+    printf("gamma, mono: %zu transactions\n", fake_panel_io_num_trans());
+    TEST_CHECK(fake_panel_io_num_trans() == 2);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_GAM_RED);
+    TEST_CHECK(fake_panel_io_trans(1) -> cmd == OLED_CMD_GAM_UPDATE);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+int main(void) {
+    test_brightness_fade();
+    test_gamma_profile();
+
+    printf("test_brightness passed\n");
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef __TEST_CHECK_H__
+#define __TEST_CHECK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Check a condition of a host test, abort with its location if it is false
+ * 
+ * Unlike assert, it is never compiled out: the tests call the driver inside it, NDEBUG must not skip those calls
+ * 
+ */
+#define TEST_CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            abort(); \
+        } \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __TEST_CHECK_H__
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static uint16_t frame[28][95];
+
+static esp_lcd_panel_handle_t new_panel(void) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    pt6891_oled_vendor_init_t vendor_config = {
+        .int_gpio_num = -1,
+        .flags.delta_flush = true,
+    };
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+        .vendor_config = &vendor_config,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    // Same orientation as service_display.c, the RAM is addressed differently so the shadow is dropped
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static size_t ramwr_bytes(void) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < fake_panel_io_num_trans(); i++) {
+        if (fake_panel_io_trans(i) -> cmd == OLED_CMD_RAMWR) {
+            bytes += fake_panel_io_trans(i) -> data_bytes;
+        }
+    }
+
+    return bytes;
+}
+
+static size_t num_ramwr(void) {
+    size_t count = 0;
+    for (size_t i = 0; i < fake_panel_io_num_trans(); i++) {
+        if (fake_panel_io_trans(i) -> cmd == OLED_CMD_RAMWR) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static void flush_frame(esp_lcd_panel_handle_t panel_handle) {
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 94, 27, frame) == ESP_OK);
+}
+
+static void test_delta_spans(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+    pt6891_delta_stats_t delta_stats;
+    memset(frame, 0, sizeof(frame));
+
+    // RAM content unknown after mirror, everything is sent
+    flush_frame(panel_handle);
+    TEST_CHECK(ramwr_bytes() == 95 * 28 * 2);
+
+    // Nothing changed, nothing sent
+    flush_frame(panel_handle);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+
+    // One pixel
+    frame[5][10] = 0xFFFF;
+    flush_frame(panel_handle);
+    TEST_CHECK(num_ramwr() == 1);
+    TEST_CHECK(ramwr_bytes() == 2);
+    TEST_CHECK(fake_panel_io_trans(1) -> param[0] == 10 + 33);
+    TEST_CHECK(fake_panel_io_trans(2) -> cmd == OLED_CMD_ROWLEN);
+    TEST_CHECK(fake_panel_io_trans(2) -> param[0] == 0);
+
+    // Close pixels in adjacent rows are merged into one rectangle
+    frame[6][10] = 0x1234;
+    frame[7][12] = 0x5678;
+    flush_frame(panel_handle);
+    TEST_CHECK(num_ramwr() == 1);
+    TEST_CHECK(ramwr_bytes() == 3 * 2 * 2);
+    const uint16_t* data = fake_panel_io_trans(fake_panel_io_num_trans() - 1) -> data;
+    TEST_CHECK(data[0] == 0x1234 && data[5] == 0x5678);
+
+    // Far apart rows are not
+    frame[10][0] = 0x1111;
+    frame[12][94] = 0x2222;
+    flush_frame(panel_handle);
+    TEST_CHECK(num_ramwr() == 2);
+    TEST_CHECK(ramwr_bytes() == 2 * 2);
+
+    // Rows on both sides of the gate are never merged
+    frame[23][50] = 0x3333;
+    frame[24][50] = 0x4444;
+    flush_frame(panel_handle);
+    TEST_CHECK(num_ramwr() == 2);
+
+    TEST_CHECK(pt6891_get_delta_stats(panel_handle, &delta_stats) == ESP_OK);
+    printf("delta: %llu bytes in, %llu bytes sent\n", (unsigned long long) delta_stats.bytes_in, (unsigned long long) delta_stats.bytes_sent);
+    TEST_CHECK(delta_stats.bytes_in == 6 * 95 * 28 * 2);
+    TEST_CHECK(delta_stats.bytes_sent == 95 * 28 * 2 + 2 + 12 + 4 + 4);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_delta_partial_unknown(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+    uint16_t pixels[4] = {0};
+
+    // Partial flush on unknown rows is sent whole and leaves them unknown
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 10, 3, 13, 3, pixels) == ESP_OK);
+    TEST_CHECK(ramwr_bytes() == 4 * 2);
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 10, 3, 13, 3, pixels) == ESP_OK);
+    TEST_CHECK(ramwr_bytes() == 4 * 2);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_delta_scroll(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+    memset(frame, 0, sizeof(frame));
+    flush_frame(panel_handle);
+
+    // The scroll moves the RAM, every row is unknown while it runs
+    pt6891_scroll_config_t scroll_config = {
+        .mode = PT6891_SCROLL_HORIZONTAL,
+        .row_start = 8,
+        .row_end = 15,
+    };
+    TEST_CHECK(pt6891_scroll_start(panel_handle, &scroll_config) == ESP_OK);
+    flush_frame(panel_handle);
+    TEST_CHECK(ramwr_bytes() == 95 * 28 * 2);
+    flush_frame(panel_handle);
+    TEST_CHECK(ramwr_bytes() == 95 * 28 * 2);
+
+    // And once more after it stopped, then known again
+    TEST_CHECK(pt6891_scroll_stop(panel_handle) == ESP_OK);
+    flush_frame(panel_handle);
+    TEST_CHECK(ramwr_bytes() == 95 * 28 * 2);
+    flush_frame(panel_handle);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_delta_write_error(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+    memset(frame, 0, sizeof(frame));
+    flush_frame(panel_handle);
+
+    // A failed send leaves the rows unknown, they are sent again on the next flush
+    frame[5][10] = 0xFFFF;
+    fake_panel_io_clear();
+    fake_panel_io_fail_after(0);
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 94, 27, frame) != ESP_OK);
+    flush_frame(panel_handle);
+    TEST_CHECK(ramwr_bytes() == 95 * 28 * 2);
+    flush_frame(panel_handle);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+int main(void) {
+    test_delta_spans();
+    test_delta_partial_unknown();
+    test_delta_scroll();
+    test_delta_write_error();
+
+    printf("test_delta: OK\n");
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static uint16_t pixels[95 * 28];
+
+static esp_lcd_panel_handle_t new_panel(void) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_reset(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    // Same orientation as service_display.c
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static size_t count_cmd(int cmd) {
+    size_t count = 0;
+    for (size_t i = 0; i < fake_panel_io_num_trans(); i++) {
+        if (fake_panel_io_trans(i) -> cmd == cmd) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static void test_small_rect(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    // Cold window registers: ROWADDR, COLADDR, ROWLEN, RAMWR
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 10, 2, 17, 5, pixels) == ESP_OK);
+    printf("small rect, cold: %zu transactions\n", fake_panel_io_num_trans());
+    TEST_CHECK(fake_panel_io_num_trans() == 4);
+    TEST_CHECK(fake_panel_io_trans(3) -> cmd == OLED_CMD_RAMWR);
+    TEST_CHECK(fake_panel_io_trans(3) -> data_bytes == 8 * 4 * 2);
+
+    // Same width again, ROWLEN is still latched
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 40, 10, 47, 12, pixels) == ESP_OK);
+    printf("small rect, warm: %zu transactions\n", fake_panel_io_num_trans());
+    TEST_CHECK(fake_panel_io_num_trans() == 3);
+    TEST_CHECK(count_cmd(OLED_CMD_ROWLEN) == 0);
+
+    // Different width must resend ROWLEN
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 40, 10, 50, 12, pixels) == ESP_OK);
+    TEST_CHECK(count_cmd(OLED_CMD_ROWLEN) == 1);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_gate_straddle(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    // Rows 20..27 cross the gate at row 24 with mirror (0, 1)
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 20, 94, 27, pixels) == ESP_OK);
+    printf("gate straddle, cold: %zu transactions\n", fake_panel_io_num_trans());
+    TEST_CHECK(fake_panel_io_num_trans() == 7);
+    TEST_CHECK(count_cmd(OLED_CMD_RAMWR) == 2);
+    TEST_CHECK(count_cmd(OLED_CMD_ROWLEN) == 1);
+
+    // Upper part lands at the end of RAM, lower part right after the row offset
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_ROWADDR);
+    TEST_CHECK(fake_panel_io_trans(0) -> param[0] == 20 + 4 + 4);
+    TEST_CHECK(fake_panel_io_trans(3) -> data_bytes == 95 * 4 * 2);
+    TEST_CHECK(fake_panel_io_trans(4) -> cmd == OLED_CMD_ROWADDR);
+    TEST_CHECK(fake_panel_io_trans(4) -> param[0] == 4);
+    TEST_CHECK(fake_panel_io_trans(6) -> data_bytes == 95 * 4 * 2);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_reset_invalidates_window(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 7, 0, pixels) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_reset(panel_handle) == ESP_OK);
+    fake_panel_io_clear();
+
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 7, 0, pixels) == ESP_OK);
+    TEST_CHECK(count_cmd(OLED_CMD_ROWLEN) == 1);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+int main(void) {
+    test_small_rect();
+    test_gate_straddle();
+    test_reset_invalidates_window();
+
+    printf("test_draw_bitmap: OK\n");
+    return 0;
+}
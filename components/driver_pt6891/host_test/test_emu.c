@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "pt6891_emu.h"
+#include "test_check.h"
+
+static uint16_t frame[28][95];
+static uint8_t frame_mono2[28][12];
+
+static esp_lcd_panel_handle_t new_panel(int bits_per_pixel, bool mirror_x, bool mirror_y) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = bits_per_pixel,
+    };
+
+    pt6891_emu_reset();
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_reset(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, mirror_x, mirror_y) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+// RGB565 as it leaves the little endian frame buffer: the low byte goes first on the wire
+static uint32_t wire565(uint16_t pixel) {
+    return ((pixel & 0xFF) << 8) | (pixel >> 8);
+}
+
+static void fill_frame(uint16_t seed) {
+    for (int y = 0; y < 28; y++) {
+        for (int x = 0; x < 95; x++) {
+            frame[y][x] = seed ^ ((y << 8) | x);
+        }
+    }
+}
+
+static void check_glass(int x_start, int y_start, int x_end, int y_end, uint16_t seed) {
+    for (int y = y_start; y <= y_end; y++) {
+        for (int x = x_start; x <= x_end; x++) {
+            TEST_CHECK(pt6891_emu_pixel(x, y) == wire565(seed ^ ((y << 8) | x)));
+        }
+    }
+}
+
+static void test_full_frame_mirrors(void) {
+    for (int m = 0; m < 4; m++) {
+        esp_lcd_panel_handle_t panel_handle = new_panel(16, m & 0x02, m & 0x01);
+
+        // Init clears the whole RAM seen by the glass
+        for (int y = 0; y < 28; y++) {
+            for (int x = 0; x < 95; x++) {
+                TEST_CHECK(pt6891_emu_pixel(x, y) == 0);
+            }
+        }
+
+        fill_frame(0);
+        TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 94, 27, frame) == ESP_OK);
+        fake_panel_io_complete_color(fake_panel_io_color_inflight());
+        check_glass(0, 0, 94, 27, 0);
+
+        pt6891_emu_stats_t stats;
+        pt6891_emu_get_stats(&stats);
+        TEST_CHECK(stats.ram_overruns == 0);
+
+        esp_lcd_panel_del(panel_handle);
+    }
+}
+
+static void test_partial_areas(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(16, 0, 1);
+
+    fill_frame(0);
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 94, 27, frame) == ESP_OK);
+
+    // Inner rectangle, then an area straddling the gate at row 24
+    uint16_t area[8 * 95];
+    const int rects[][4] = {
+        {10, 2, 17, 5},
+        {0, 20, 94, 27},
+        {60, 22, 63, 25},
+    };
+    for (size_t r = 0; r < sizeof(rects) / sizeof(rects[0]); r++) {
+        int x_start = rects[r][0], y_start = rects[r][1], x_end = rects[r][2], y_end = rects[r][3];
+        int w = x_end - x_start + 1;
+        for (int y = y_start; y <= y_end; y++) {
+            for (int x = x_start; x <= x_end; x++) {
+                frame[y][x] = 0x5A5A ^ ((y << 8) | x);
+                area[(y - y_start) * w + x - x_start] = frame[y][x];
+            }
+        }
+        TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, area) == ESP_OK);
+        fake_panel_io_complete_color(fake_panel_io_color_inflight());
+
+        for (int y = 0; y < 28; y++) {
+            for (int x = 0; x < 95; x++) {
+                TEST_CHECK(pt6891_emu_pixel(x, y) == wire565(frame[y][x]));
+            }
+        }
+    }
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_decoded_when_done(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(16, 0, 1);
+
+    // The emulator sees pixel data when the transfer ends, not when it is queued
+    fill_frame(0x1234);
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 94, 3, frame) == ESP_OK);
+    TEST_CHECK(fake_panel_io_color_inflight() == 1);
+    TEST_CHECK(pt6891_emu_pixel(0, 0) == 0);
+    fake_panel_io_complete_color(1);
+    check_glass(0, 0, 94, 3, 0x1234);
+
+    // Wire statistics: 3 addressed commands and RAMWR, as in test_draw_bitmap
+    pt6891_emu_clear_stats();
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 10, 2, 17, 5, frame) == ESP_OK);
+    fake_panel_io_complete_color(1);
+    pt6891_emu_stats_t stats;
+    pt6891_emu_get_stats(&stats);
+    TEST_CHECK(stats.transactions == fake_panel_io_num_trans());
+    TEST_CHECK(stats.ramwr_bytes == 8 * 4 * 2);
+    TEST_CHECK(stats.wire_bytes == stats.transactions + (stats.transactions - 1) + stats.ramwr_bytes);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_mono2(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(1, 0, 1);
+
+    // Frame buffer rows are whole bytes, MSB first
+    memset(frame_mono2, 0, sizeof(frame_mono2));
+    for (int y = 0; y < 28; y++) {
+        for (int x = 0; x < 95; x++) {
+            if ((x + y) % 3 == 0) {
+                frame_mono2[y][x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+    }
+    int x_start = 0;
+    int x_end = 94;
+    TEST_CHECK(pt6891_align_columns(panel_handle, &x_start, &x_end) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, x_start, 0, x_end, 27, frame_mono2) == ESP_OK);
+    fake_panel_io_complete_color(fake_panel_io_color_inflight());
+
+    for (int y = 0; y < 28; y++) {
+        for (int x = 0; x < 95; x++) {
+            TEST_CHECK(pt6891_emu_pixel(x, y) == ((x + y) % 3 == 0));
+        }
+    }
+
+    pt6891_emu_stats_t stats;
+    pt6891_emu_get_stats(&stats);
+    TEST_CHECK(stats.ram_overruns == 0);
+
+    // A pixel is only shown if its 3 COM lines agree: set the middle line of every row
+    uint8_t ones[PT6891_EMU_RAM_COLS / 8];
+    memset(ones, 0xFF, sizeof(ones));
+    pt6891_emu_feed(OLED_CMD_COLADDR, (uint8_t []) {0}, 1);
+    pt6891_emu_feed(OLED_CMD_ROWLEN, (uint8_t []) {PT6891_EMU_RAM_COLS - 1}, 1);
+    for (int row = 1; row < PT6891_EMU_RAM_ROWS; row += 3) {
+        pt6891_emu_feed(OLED_CMD_ROWADDR, (uint8_t []) {row}, 1);
+        pt6891_emu_feed(OLED_CMD_RAMWR, ones, sizeof(ones));
+    }
+    for (int y = 0; y < 28; y++) {
+        for (int x = 0; x < 95; x++) {
+            TEST_CHECK(pt6891_emu_pixel(x, y) == ((x + y) % 3 == 0 ? 1 : PT6891_EMU_COM_MISMATCH));
+        }
+    }
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+int main(void) {
+    test_full_frame_mirrors();
+    test_partial_areas();
+    test_decoded_when_done();
+    test_mono2();
+
+    printf("test_emu: OK\n");
+    return 0;
+}
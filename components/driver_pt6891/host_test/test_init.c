@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static void test_init_clear_ram(void) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    printf("init: %zu transactions\n", fake_panel_io_num_trans());
+
+    // The clear runs between PRECHG_CUR and the next init command
+    size_t first = 0;
+    while (fake_panel_io_trans(first) -> cmd != OLED_CMD_PRECHG_CUR) {
+        first++;
+    }
+    first++;
+
+    size_t last = first;
+    size_t ramwr_bytes = 0;
+    size_t num_rowlen = 0;
+    while (fake_panel_io_trans(last) -> cmd != OLED_CMD_INT_EN) {
+        const fake_panel_io_trans_t* trans = fake_panel_io_trans(last);
+        if (trans -> cmd == OLED_CMD_RAMWR) {
+            ramwr_bytes += trans -> data_bytes;
+        } else if (trans -> cmd == OLED_CMD_ROWLEN) {
+            TEST_CHECK(trans -> param[0] == 127);
+            num_rowlen++;
+        }
+        last++;
+    }
+
+    printf("init clear: %zu transactions\n", last - first);
+    // One window, 4 chunks of 8 rows and the last row
+    TEST_CHECK(last - first == 2 + 5 * 2);
+    TEST_CHECK(num_rowlen == 1);
+    // Every pixel of the 128 x 33 RAM, RGB565
+    TEST_CHECK(ramwr_bytes == 128 * 33 * 2);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+int main(void) {
+    test_init_clear_ram();
+
+    printf("test_init: OK\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static esp_lcd_panel_handle_t new_panel(int bits_per_pixel) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = bits_per_pixel,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+
+    // Init ends by switching to the mono mode and scanning 3 COM lines per row
+    size_t n = fake_panel_io_num_trans();
+    TEST_CHECK(fake_panel_io_trans(n - 2) -> cmd == (bits_per_pixel == 1 ? OLED_CMD_COLOR_MONO_2 : OLED_CMD_COLOR_MONO_64));
+    TEST_CHECK(fake_panel_io_trans(n - 1) -> cmd == OLED_CMD_COM_NUM);
+    TEST_CHECK(fake_panel_io_trans(n - 1) -> param[0] == 28 * 3 - 1);
+
+    // Same orientation as service_display.c
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static void test_mono2_aligned(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(1);
+
+    // Columns 40..47, one RAM byte, first 2 pixels lit
+    const uint8_t pixels[] = {0xC0};
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 7, 0, 14, 0, pixels) == ESP_OK);
+
+    TEST_CHECK(fake_panel_io_num_trans() == 4);
+    TEST_CHECK(fake_panel_io_trans(0) -> param[0] == (0 + 4 + 4) * 3);
+    TEST_CHECK(fake_panel_io_trans(1) -> param[0] == 40);
+    TEST_CHECK(fake_panel_io_trans(2) -> cmd == OLED_CMD_ROWLEN);
+    TEST_CHECK(fake_panel_io_trans(2) -> param[0] == 0);
+    TEST_CHECK(fake_panel_io_trans(3) -> data_bytes == 3);
+    TEST_CHECK(memcmp(fake_panel_io_trans(3) -> data, (uint8_t []) {0x03, 0x03, 0x03}, 3) == 0);
+
+    TEST_CHECK(esp_lcd_panel_swap_xy(panel_handle, true) == ESP_ERR_NOT_SUPPORTED);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_mono2_full_row(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(1);
+
+    // Full rows start at column 33, the window is widened to column 32 which is not displayed
+    int x_start = 0;
+    int x_end = 94;
+    TEST_CHECK(pt6891_align_columns(panel_handle, &x_start, &x_end) == ESP_OK);
+    TEST_CHECK(x_start == 0 && x_end == 94);
+
+    uint8_t pixels[12];
+    memset(pixels, 0xFF, sizeof(pixels));
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, x_start, 1, x_end, 1, pixels) == ESP_OK);
+
+    TEST_CHECK(fake_panel_io_trans(1) -> param[0] == 32);
+    TEST_CHECK(fake_panel_io_trans(2) -> param[0] == 128 - 32 - 8);
+    TEST_CHECK(fake_panel_io_trans(3) -> data_bytes == 12 * 3);
+    const uint8_t* data = fake_panel_io_trans(3) -> data;
+    for (int i = 0; i < 3; i++) {
+        TEST_CHECK(data[i * 12] == 0xFE);
+        TEST_CHECK(data[i * 12 + 11] == 0xFF);
+    }
+
+    // Inner areas are widened to whole bytes
+    x_start = 10;
+    x_end = 12;
+    TEST_CHECK(pt6891_align_columns(panel_handle, &x_start, &x_end) == ESP_OK);
+    TEST_CHECK(x_start == 7 && x_end == 14);
+
+    // With H mirror the RAM starts at column 0
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 1, 1) == ESP_OK);
+    x_start = 3;
+    x_end = 10;
+    TEST_CHECK(pt6891_align_columns(panel_handle, &x_start, &x_end) == ESP_OK);
+    TEST_CHECK(x_start == 0 && x_end == 15);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_mono64_straddle(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(6);
+
+    const uint8_t pixels[] = {
+        0x01, 0x02,
+        0x3e, 0x3f,
+    };
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 23, 1, 24, pixels) == ESP_OK);
+
+    // Row 23 is the last row before the gate, row 24 the first after it
+    TEST_CHECK(fake_panel_io_num_trans() == 7);
+    TEST_CHECK(fake_panel_io_trans(0) -> param[0] == (23 + 4 + 4) * 3);
+    TEST_CHECK(fake_panel_io_trans(3) -> data_bytes == 2 * 3);
+    TEST_CHECK(memcmp(fake_panel_io_trans(3) -> data, (uint8_t []) {0x01, 0x02, 0x01, 0x02, 0x01, 0x02}, 6) == 0);
+    TEST_CHECK(fake_panel_io_trans(4) -> param[0] == 4 * 3);
+    TEST_CHECK(fake_panel_io_trans(6) -> data_bytes == 2 * 3);
+    TEST_CHECK(memcmp(fake_panel_io_trans(6) -> data, (uint8_t []) {0x3e, 0x3f, 0x3e, 0x3f, 0x3e, 0x3f}, 6) == 0);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+int main(void) {
+    test_mono2_aligned();
+    test_mono2_full_row();
+    test_mono64_straddle();
+
+    printf("test_mono: OK\n");
+    return 0;
+}
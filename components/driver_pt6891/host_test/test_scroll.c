@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static esp_lcd_panel_handle_t new_panel(void) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static void test_scroll_start_stop(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    pt6891_scroll_config_t scroll_config = {
+        .mode = PT6891_SCROLL_HORIZONTAL,
+        .left_to_right = false,
+        .row_start = 8,
+        .row_end = 15,
+        .frame_interval = 2,
+    };
+    TEST_CHECK(pt6891_scroll_start(panel_handle, &scroll_config) == ESP_OK);
+
+    TEST_CHECK(fake_panel_io_num_trans() == 5);
+    TEST_CHECK(fake_panel_io_trans(1) -> cmd == OLED_CMD_GPH_ACC);
+    TEST_CHECK(fake_panel_io_trans(1) -> param[0] == OLED_SET_GPH_ACC(0, 0, 0));
+    TEST_CHECK(fake_panel_io_trans(2) -> cmd == OLED_CMD_ACC_FRAME);
+    TEST_CHECK(fake_panel_io_trans(2) -> param[0] == 2);
+    // Rows above the gate are shifted by the gate and row offsets, like draw_bitmap
+    TEST_CHECK(fake_panel_io_trans(3) -> cmd == OLED_CMD_ACC_ROW);
+    TEST_CHECK(fake_panel_io_trans(3) -> param[0] == 8 + 4 + 4);
+    TEST_CHECK(fake_panel_io_trans(3) -> param[1] == 15 + 4 + 4);
+    TEST_CHECK(fake_panel_io_trans(4) -> cmd == OLED_CMD_GPH_ACC_EN);
+
+    fake_panel_io_clear();
+    TEST_CHECK(pt6891_scroll_stop(panel_handle) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 1);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_GPH_ACC_DIS);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_scroll_rejects_gate(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    pt6891_scroll_config_t scroll_config = {
+        .mode = PT6891_SCROLL_HORIZONTAL,
+        .row_start = 20,
+        .row_end = 27,
+    };
+    TEST_CHECK(pt6891_scroll_start(panel_handle, &scroll_config) == ESP_ERR_INVALID_ARG);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+int main(void) {
+    test_scroll_start_stop();
+    test_scroll_rejects_gate();
+
+    printf("test_scroll: OK\n");
+    return 0;
+}
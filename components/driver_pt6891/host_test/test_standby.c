@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static uint16_t pixels[95 * 28];
+
+static esp_lcd_panel_handle_t new_panel(void) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static void test_clock_div(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    // Idle stepping, one command per step
+    const int clk_divs[] = {2, 4, 8, 8, 1};
+    const int cmds[] = {OLED_CMD_CLK_DIV_2, OLED_CMD_CLK_DIV_4, OLED_CMD_CLK_DIV_8, OLED_CMD_NOP, OLED_CMD_CLK_DIV_1};
+    for (int i = 0; i < sizeof(clk_divs) / sizeof(clk_divs[0]); i++) {
+        fake_panel_io_clear();
+        TEST_CHECK(pt6891_set_clock_div(panel_handle, clk_divs[i]) == ESP_OK);
+        if (cmds[i] == OLED_CMD_NOP) {
+            TEST_CHECK(fake_panel_io_num_trans() == 0);
+        } else {
+            TEST_CHECK(fake_panel_io_num_trans() == 1);
+            TEST_CHECK(fake_panel_io_trans(0) -> cmd == cmds[i]);
+        }
+    }
+    TEST_CHECK(pt6891_set_clock_div(panel_handle, 3) == ESP_ERR_INVALID_ARG);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+static void test_standby_wakeup(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, true) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 1);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_STANDBY);
+
+    // Only WAKEUP is accepted by the controller, nothing else may be sent
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, true) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 7, 3, pixels) == ESP_ERR_INVALID_STATE);
+    TEST_CHECK(pt6891_set_clock_div(panel_handle, 1) == ESP_ERR_INVALID_STATE);
+    TEST_CHECK(pt6891_set_brightness(panel_handle, 10) == ESP_ERR_INVALID_STATE);
+    TEST_CHECK(esp_lcd_panel_disp_on_off(panel_handle, true) == ESP_ERR_INVALID_STATE);
+    pt6891_scroll_config_t scroll_config = {
+        .mode = PT6891_SCROLL_HORIZONTAL,
+        .row_start = 8,
+        .row_end = 15,
+    };
+    TEST_CHECK(pt6891_scroll_start(panel_handle, &scroll_config) == ESP_ERR_INVALID_STATE);
+    TEST_CHECK(pt6891_scroll_stop(panel_handle) == ESP_ERR_INVALID_STATE);
+    TEST_CHECK(fake_panel_io_num_trans() == 0);
+
+    // Standby switched the display off, wake-up turns it back on
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, false) == ESP_OK);
+    printf("wake-up: %zu transactions\n", fake_panel_io_num_trans());
+    TEST_CHECK(fake_panel_io_num_trans() == 2);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_WAKEUP);
+    TEST_CHECK(fake_panel_io_trans(1) -> cmd == OLED_CMD_DISP_NORMAL);
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 7, 3, pixels) == ESP_OK);
+
+    // A display switched off stays off
+    TEST_CHECK(esp_lcd_panel_disp_on_off(panel_handle, false) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, true) == ESP_OK);
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, false) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 1);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_WAKEUP);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+static void test_reset_in_standby(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel();
+
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, true) == ESP_OK);
+
+    // SWRST is only accepted after WAKEUP, the controller comes out of reset awake
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_reset(panel_handle) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 2);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_WAKEUP);
+    TEST_CHECK(fake_panel_io_trans(1) -> cmd == OLED_CMD_SWRST);
+
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, 7, 3, pixels) == ESP_OK);
+    TEST_CHECK(pt6891_set_clock_div(panel_handle, 1) == ESP_OK);
+
+    // The display is off after reset, wake-up from a later standby leaves it off
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, true) == ESP_OK);
+    fake_panel_io_clear();
+    TEST_CHECK(esp_lcd_panel_disp_sleep(panel_handle, false) == ESP_OK);
+    TEST_CHECK(fake_panel_io_num_trans() == 1);
+    TEST_CHECK(fake_panel_io_trans(0) -> cmd == OLED_CMD_WAKEUP);
+
+    TEST_CHECK(esp_lcd_panel_del(panel_handle) == ESP_OK);
+}
+
+int main(void) {
+    test_clock_div();
+    test_standby_wakeup();
+    test_reset_in_standby();
+
+    printf("test_standby passed\n");
+    return 0;
+}
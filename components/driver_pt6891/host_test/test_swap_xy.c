@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+#include "oled_panel_cmds.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static esp_lcd_panel_handle_t new_panel(uint32_t bits_per_pixel) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = bits_per_pixel,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_swap_xy(panel_handle, true) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static const fake_panel_io_trans_t* find_cmd(int cmd, size_t nth) {
+    for (size_t i = 0; i < fake_panel_io_num_trans(); i++) {
+        if (fake_panel_io_trans(i) -> cmd == cmd && nth-- == 0) {
+            return fake_panel_io_trans(i);
+        }
+    }
+
+    return NULL;
+}
+
+static void test_swap_rgb565(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(16);
+
+    // Portrait area 19 wide (larger than a tile) and 3 tall
+    enum { W = 19, H = 3 };
+    uint16_t src[W * H];
+    for (int i = 0; i < W * H; i++) {
+        src[i] = i;
+    }
+
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 2, 30, 2 + W - 1, 30 + H - 1, src) == ESP_OK);
+
+    // Swapped: panel columns 30..32, panel rows 2..20
+    const fake_panel_io_trans_t* col = find_cmd(OLED_CMD_COLADDR, 0);
+    const fake_panel_io_trans_t* len = find_cmd(OLED_CMD_ROWLEN, 0);
+    const fake_panel_io_trans_t* row = find_cmd(OLED_CMD_ROWADDR, 0);
+    const fake_panel_io_trans_t* ram = find_cmd(OLED_CMD_RAMWR, 0);
+    TEST_CHECK(col -> param[0] == 30 + 33);
+    TEST_CHECK(len -> param[0] == H - 1);
+    TEST_CHECK(row -> param[0] == 2 + 4 + 4);
+    TEST_CHECK(ram -> data_bytes == W * H * 2);
+
+    const uint16_t* dst = ram -> data;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            TEST_CHECK(dst[x * H + y] == src[y * W + x]);
+        }
+    }
+
+    // Next flush must not reuse the buffer that may still be on the wire
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 2, 30, 2 + W - 1, 30 + H - 1, src) == ESP_OK);
+    TEST_CHECK(find_cmd(OLED_CMD_RAMWR, 1) -> data != ram -> data);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_swap_rgb666_straddle(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(18);
+
+    // Full portrait screen, crosses the gate after the swap
+    enum { W = 28, H = 95 };
+    static uint8_t src[W * H * 3];
+    for (int i = 0; i < W * H * 3; i++) {
+        src[i] = i * 7;
+    }
+
+    TEST_CHECK(esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, W - 1, H - 1, src) == ESP_OK);
+    TEST_CHECK(find_cmd(OLED_CMD_RAMWR, 1) != NULL);
+
+    const fake_panel_io_trans_t* first = find_cmd(OLED_CMD_RAMWR, 0);
+    const fake_panel_io_trans_t* second = find_cmd(OLED_CMD_RAMWR, 1);
+    TEST_CHECK(first -> data_bytes + second -> data_bytes == W * H * 3);
+
+    const uint8_t* dst = first -> data;
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            TEST_CHECK(memcmp(&dst[(x * H + y) * 3], &src[(y * W + x) * 3], 3) == 0);
+        }
+    }
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+int main(void) {
+    test_swap_rgb565();
+    test_swap_rgb666_straddle();
+
+    printf("test_swap_xy: OK\n");
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_lcd_panel_ops.h"
+#include "driver_pt6891.h"
+
+#include "fake_panel_io.h"
+#include "test_check.h"
+
+static esp_lcd_panel_handle_t new_panel(const pt6891_oled_vendor_init_t* vendor_config) {
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_panel_dev_config_t panel_dev_config = {
+        .reset_gpio_num = -1,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
+        .bits_per_pixel = 16,
+        .vendor_config = (void*) vendor_config,
+    };
+
+    TEST_CHECK(esp_lcd_new_panel_pt6891(fake_panel_io_get(), &panel_dev_config, &panel_handle) == ESP_OK);
+    TEST_CHECK(esp_lcd_panel_init(panel_handle) == ESP_OK);
+    fake_panel_io_clear();
+
+    return panel_handle;
+}
+
+static void test_vsync_without_int(void) {
+    esp_lcd_panel_handle_t panel_handle = new_panel(NULL);
+    uint32_t period_us = 0;
+
+    TEST_CHECK(fake_panel_io_int_edge(0) == false);
+    TEST_CHECK(pt6891_wait_vsync(panel_handle, 10) == ESP_ERR_NOT_SUPPORTED);
+    TEST_CHECK(pt6891_get_frame_period(panel_handle, &period_us) == ESP_ERR_NOT_SUPPORTED);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_vsync_int_opt_in(void) {
+    // A zero-initialized vendor config leaves GPIO0 alone
+    pt6891_oled_vendor_init_t vendor_config = {0};
+    esp_lcd_panel_handle_t panel_handle = new_panel(&vendor_config);
+
+    TEST_CHECK(fake_panel_io_int_edge(0) == false);
+    TEST_CHECK(pt6891_wait_vsync(panel_handle, 10) == ESP_ERR_NOT_SUPPORTED);
+
+    esp_lcd_panel_del(panel_handle);
+}
+
+static void test_vsync_frame_period(void) {
+    pt6891_oled_vendor_init_t vendor_config = {
+        .int_gpio_num = 9,
+        .flags.use_int = true,
+    };
+    esp_lcd_panel_handle_t panel_handle = new_panel(&vendor_config);
+    uint32_t period_us = 0;
+
+    TEST_CHECK(fake_panel_io_int_edge(1000000));
+    TEST_CHECK(pt6891_get_frame_period(panel_handle, &period_us) == ESP_ERR_INVALID_STATE);
+
+    TEST_CHECK(fake_panel_io_int_edge(1000000 + 16000));
+    TEST_CHECK(pt6891_get_frame_period(panel_handle, &period_us) == ESP_OK);
+    TEST_CHECK(period_us == 16000);
+
+    // One late edge only nudges the filtered period
+    TEST_CHECK(fake_panel_io_int_edge(1000000 + 16000 + 24000));
+    TEST_CHECK(pt6891_get_frame_period(panel_handle, &period_us) == ESP_OK);
+    TEST_CHECK(period_us == 17000);
+
+    // Edges seen before the call are stale, nothing new arrives on host so it times out
+    TEST_CHECK(pt6891_wait_vsync(panel_handle, 10) == ESP_ERR_TIMEOUT);
+
+    // Deleting the panel releases the INT ISR
+    esp_lcd_panel_del(panel_handle);
+    TEST_CHECK(fake_panel_io_int_edge(0) == false);
+}
+
+int main(void) {
+    test_vsync_without_int();
+    test_vsync_int_opt_in();
+    test_vsync_frame_period();
+
+    printf("test_vsync: OK\n");
+    return 0;
+}
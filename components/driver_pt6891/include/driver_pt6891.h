@@ -6,6 +6,8 @@ extern "C" {
 #endif
 
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 #include "esp_lcd_types.h"
 #include "esp_lcd_panel_dev.h"
@@ -28,11 +30,199 @@ typedef struct {
 typedef struct {
     const pt6891_oled_init_cmd_t* init_cmds;    // Poniter to init commands array. Set to NULL to use default commands.
     size_t num_init_cmds;                       // Number of commands in above array
+    int int_gpio_num;                           // GPIO connected to INT (frame sync), only used with flags.use_int
+    struct {
+        unsigned int delta_flush: 1;            // Keep a shadow of the RAM and only send the pixels that changed (color modes)
+        unsigned int use_int: 1;                // INT is wired to int_gpio_num, enables pt6891_wait_vsync and pt6891_get_frame_period
+    } flags;
 } pt6891_oled_vendor_init_t;
 
+/**
+ * @brief Flush Done Callback
+ * 
+ * @param panel_handle Panel handle
+ * @param user_ctx User context passed to pt6891_register_flush_done_cb
+ * @return bool Whether a high priority task has been woken up
+ */
+typedef bool (*pt6891_flush_done_cb_t)(esp_lcd_panel_handle_t panel_handle, void* user_ctx);
+
+/**
+ * @brief Delta Flush Counters
+ * 
+ */
+typedef struct {
+    uint64_t bytes_in;      // Pixel bytes given to draw_bitmap
+    uint64_t bytes_sent;    // Pixel bytes sent to the panel, the rest was already in RAM
+} pt6891_delta_stats_t;
+
+/**
+ * @brief Gamma Profile
+ * 
+ */
+typedef enum {
+    PT6891_GAMMA_DEFAULT = 0,   // Gamma 1.8, the curve of the default init commands
+    PT6891_GAMMA_LINEAR = 1,    // PWM width proportional to the level
+    PT6891_GAMMA_2_2 = 2,       // Gamma 2.2, darker mid-tones
+    PT6891_GAMMA_MAX,
+} pt6891_gamma_profile_t;
+
+/**
+ * @brief Graphic Acceleration Scroll Mode
+ * 
+ */
+typedef enum {
+    PT6891_SCROLL_HORIZONTAL = 0,   // Rows in the window scroll horizontally
+    PT6891_SCROLL_VERTICAL = 1,     // Rows in the window scroll vertically
+    PT6891_SCROLL_BOTH = 2,         // Horizontal and vertical at the same time
+} pt6891_scroll_mode_t;
+
+/**
+ * @brief Graphic Acceleration Scroll Config
+ * 
+ * The controller rotates the content of its frame buffer by itself, nothing is sent while scrolling.
+ * Rows are panel rows (before swap_xy), the window must not cross the gate of the panel.
+ * 
+ */
+typedef struct {
+    pt6891_scroll_mode_t mode;  // Scroll Mode
+    bool left_to_right;         // Horizontal Direction, in RAM order (flipped by H mirror)
+    bool top_to_bottom;         // Vertical Direction, in RAM order (flipped by V mirror)
+    int row_start;              // First row of the scroll window
+    int row_end;                // Last row of the scroll window
+    uint8_t frame_interval;     // Frames between two scroll steps
+} pt6891_scroll_config_t;
+
+/**
+ * @brief Widen a column range to what the color mode can address
+ * 
+ * In 2-Gray mode the controller addresses 8 pixels at a time, flushes must cover whole bytes of RAM
+ * or the pixels next to them are cleared. Use it from the LVGL rounder. No-op in other modes.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param x_start First column, widened in place
+ * @param x_end Last column, widened in place
+ * @return esp_err_t 
+ */
+esp_err_t pt6891_align_columns(esp_lcd_panel_handle_t panel_handle, int* x_start, int* x_end);
+
+/**
+ * @brief Register a callback for the end of each draw_bitmap
+ * 
+ * One draw_bitmap may queue several transfers (gate split, delta rectangles). The callback is called once,
+ * after the last of them is done, from the transfer done ISR, or from draw_bitmap itself when nothing had
+ * to be sent. The color data may be reused from then on.
+ * It takes over on_color_trans_done of the panel IO.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param flush_done_cb Callback
+ * @param user_ctx User context passed to the callback
+ * @return esp_err_t 
+ */
+esp_err_t pt6891_register_flush_done_cb(esp_lcd_panel_handle_t panel_handle, pt6891_flush_done_cb_t flush_done_cb, void* user_ctx);
+
+/**
+ * @brief Get the delta flush counters
+ * 
+ * bytes_in - bytes_sent is the traffic saved.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param delta_stats Returned counters
+ * @return esp_err_t ESP_ERR_NOT_SUPPORTED if delta flush is off
+ */
+esp_err_t pt6891_get_delta_stats(esp_lcd_panel_handle_t panel_handle, pt6891_delta_stats_t* delta_stats);
+
+/**
+ * @brief Set the PWM clock divider
+ * 
+ * T_PWMCLK = clk_div * T_OSC, the frame rate and the switching losses drop with it, at the cost of flicker.
+ * Meant for an idle display, restore 1 before animating again. The frame period is measured again on INT.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param clk_div 1, 2, 4 or 8
+ * @return esp_err_t ESP_ERR_INVALID_STATE in standby
+ */
+esp_err_t pt6891_set_clock_div(esp_lcd_panel_handle_t panel_handle, uint8_t clk_div);
+
+/**
+ * @brief Set the brightness
+ * 
+ * Scales the segment currents of the default white balance, the frame buffer is untouched so it is cheap
+ * enough to be stepped by an animation: one transaction per change, none if the level is the same.
+ * Takes effect on the next frame.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param brightness 0 (off) to 255 (the default init commands)
+ * @return esp_err_t 
+ */
+esp_err_t pt6891_set_brightness(esp_lcd_panel_handle_t panel_handle, uint8_t brightness);
+
+/**
+ * @brief Set the gamma profile
+ * 
+ * Uploads the precomputed tables of the profile followed by a single gamma update, taking effect on the next frame.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param gamma_profile Gamma profile
+ * @return esp_err_t 
+ */
+esp_err_t pt6891_set_gamma_profile(esp_lcd_panel_handle_t panel_handle, pt6891_gamma_profile_t gamma_profile);
+
+/**
+ * @brief Start hardware scroll
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param scroll_config Scroll window and mode
+ * @return esp_err_t 
+ */
+esp_err_t pt6891_scroll_start(esp_lcd_panel_handle_t panel_handle, const pt6891_scroll_config_t* scroll_config);
+
+/**
+ * @brief Stop hardware scroll
+ * 
+ * The frame buffer keeps the scrolled content, redraw the window afterwards.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @return esp_err_t 
+ */
+esp_err_t pt6891_scroll_stop(esp_lcd_panel_handle_t panel_handle);
+
+/**
+ * @brief Wait for the start of the next frame
+ * 
+ * Blocks the calling task until the next INT edge, RAM written right after it is scanned out whole.
+ * Only one task may wait at a time.
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param timeout_ms Timeout in milliseconds, -1 to wait forever
+ * @return esp_err_t ESP_ERR_NOT_SUPPORTED if no INT GPIO, ESP_ERR_TIMEOUT if no edge in time
+ */
+esp_err_t pt6891_wait_vsync(esp_lcd_panel_handle_t panel_handle, int timeout_ms);
+
+/**
+ * @brief Get the frame period measured on INT
+ * 
+ * @param panel_handle Panel handle returned by esp_lcd_new_panel_pt6891
+ * @param period_us Returned frame period in microseconds
+ * @return esp_err_t ESP_ERR_INVALID_STATE until two INT edges are seen
+ */
+esp_err_t pt6891_get_frame_period(esp_lcd_panel_handle_t panel_handle, uint32_t* period_us);
+
 /**
  * @brief Create OLED panel for PT6891
  * 
+ * bits_per_pixel selects the color mode and the format of draw_bitmap data:
+ * - 16: RGB565, 2 bytes per pixel
+ * - 18: RGB666, 3 bytes per pixel (b00[5:0] each)
+ * - 6: Mono 64 Gray, 1 byte per pixel (b00[5:0])
+ * - 1: Mono 2 Gray, rows of (width + 7) / 8 bytes, MSB first
+ * 
+ * In mono modes every pixel lights its R, G and B lines alike, only the red gamma and brightness apply,
+ * and swap_xy is not supported.
+ * 
+ * disp_sleep enters standby (oscillator off, display off, RAM kept) and blocks for one frame until the
+ * controller accepts WAKEUP again. In standby draw_bitmap, disp_on_off, pt6891_set_* and pt6891_scroll_* fail with
+ * ESP_ERR_INVALID_STATE; waking up turns the display back on if it was.
+ * 
  * @param panel_io_handle OLED panel IO Handle
  * @param panel_dev_config General panel configuration
  * @param panel_handle Returned panel handle
@@ -0,0 +1,32 @@
+#ifndef __PT6891_GLASS_H__
+#define __PT6891_GLASS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MONO_COM_PER_ROW 3 // Each RGB row of this panel is 3 COM lines, one RAM row each in mono mode
+
+/**
+ * @brief Screen Pixel Offsets, the Part of the RAM Wired to the Glass
+ * 
+ * [H_MIRROR][V_MIRROR][X_START, Y_START, Y_GATE]
+ * 
+ * Shared by the driver and the host test emulator
+ * 
+ */
+static const int pt6891_glass_offsets[2][2][3] = {
+    {
+        {33, 0, 4},
+        {33, 4, 24},
+    }, {
+        {0, 0, 4},
+        {0, 4, 24},
+    },
+};
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __PT6891_GLASS_H__
@@ -0,0 +1,45 @@
+#include "flush_queue.h"
+
+// Indexes run freely and wrap at 2^32, the slot is the index modulo FLUSH_QUEUE_SIZE
+
+void flush_queue_init(flush_queue_t* queue) {
+    atomic_init(&queue -> head, 0);
+    atomic_init(&queue -> tail, 0);
+}
+
+bool flush_queue_push(flush_queue_t* queue, const flush_stripe_t* stripe) {
+    unsigned head = atomic_load_explicit(&queue -> head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&queue -> tail, memory_order_acquire);
+    if (head - tail == FLUSH_QUEUE_SIZE) {
+        return false;
+    }
+
+    queue -> stripes[head % FLUSH_QUEUE_SIZE] = *stripe;
+    // Publish the stripe before the consumer can see the new head
+    atomic_store_explicit(&queue -> head, head + 1, memory_order_release);
+
+    return true;
+}
+
+const flush_stripe_t* flush_queue_front(flush_queue_t* queue) {
+    unsigned tail = atomic_load_explicit(&queue -> tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&queue -> head, memory_order_acquire);
+    if (head == tail) {
+        return NULL;
+    }
+
+    return &queue -> stripes[tail % FLUSH_QUEUE_SIZE];
+}
+
+void flush_queue_pop(flush_queue_t* queue) {
+    unsigned tail = atomic_load_explicit(&queue -> tail, memory_order_relaxed);
+    // The slot is done with before the producer can reuse it
+    atomic_store_explicit(&queue -> tail, tail + 1, memory_order_release);
+}
+
+bool flush_queue_empty(flush_queue_t* queue) {
+    unsigned tail = atomic_load_explicit(&queue -> tail, memory_order_acquire);
+    unsigned head = atomic_load_explicit(&queue -> head, memory_order_acquire);
+
+    return head == tail;
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "flush_queue.h"
+
+#define STRIPE_PIXELS 95 * 14
+#define NUM_BUFFERS 2
+#define NUM_STRIPES 200000
+
+static void test_single_thread(void) {
+    flush_queue_t queue;
+    flush_queue_init(&queue);
+
+    assert(flush_queue_empty(&queue));
+    assert(flush_queue_front(&queue) == NULL);
+
+    // Fill, then wrap around a few times
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < FLUSH_QUEUE_SIZE; i++) {
+            flush_stripe_t stripe = {.x_start = round * 100 + i, .last = i == FLUSH_QUEUE_SIZE - 1};
+            assert(flush_queue_push(&queue, &stripe));
+        }
+        flush_stripe_t stripe = {0};
+        assert(!flush_queue_push(&queue, &stripe));
+
+        for (int i = 0; i < FLUSH_QUEUE_SIZE; i++) {
+            const flush_stripe_t* front = flush_queue_front(&queue);
+            assert(front != NULL);
+            assert(front -> x_start == round * 100 + i);
+            assert(front -> last == (i == FLUSH_QUEUE_SIZE - 1));
+            // Not removed until popped
+            assert(flush_queue_front(&queue) == front);
+            assert(!flush_queue_empty(&queue));
+            flush_queue_pop(&queue);
+        }
+        assert(flush_queue_empty(&queue));
+    }
+}
+
+// Same pipeline as the ESP port: the render thread fills 2 buffers in turn and waits for the flush
+// thread to hand a buffer back before rendering into it again
+
+static flush_queue_t pipeline_queue;
+static uint32_t buffers[NUM_BUFFERS][STRIPE_PIXELS];
+static atomic_bool buffer_flushing[NUM_BUFFERS];
+static uint32_t panel[STRIPE_PIXELS];
+static int num_flushed;
+
+static void* render_thread(void* arg) {
+    for (uint32_t n = 0; n < NUM_STRIPES; n++) {
+        int b = n % NUM_BUFFERS;
+        while (atomic_load(&buffer_flushing[b])) {
+            sched_yield();
+        }
+        for (int i = 0; i < STRIPE_PIXELS; i++) {
+            buffers[b][i] = n ^ i;
+        }
+
+        atomic_store(&buffer_flushing[b], true);
+        flush_stripe_t stripe = {.x_start = b, .y_start = n, .data = buffers[b], .last = (n % 2) == 1};
+        while (!flush_queue_push(&pipeline_queue, &stripe)) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void* flush_thread(void* arg) {
+    uint32_t expected = 0;
+    while (expected < NUM_STRIPES) {
+        const flush_stripe_t* stripe = flush_queue_front(&pipeline_queue);
+        if (stripe == NULL) {
+            sched_yield();
+            continue;
+        }
+
+        // Stripes come in order and their pixels are complete
+        assert((uint32_t) stripe -> y_start == expected);
+        assert(stripe -> data == buffers[expected % NUM_BUFFERS]);
+        memcpy(panel, stripe -> data, sizeof(panel));
+        for (int i = 0; i < STRIPE_PIXELS; i++) {
+            assert(panel[i] == (expected ^ i));
+        }
+
+        int b = stripe -> x_start;
+        flush_queue_pop(&pipeline_queue);
+        atomic_store(&buffer_flushing[b], false);
+        expected++;
+        num_flushed++;
+    }
+
+    return NULL;
+}
+
+static void test_pipeline_threads(void) {
+    flush_queue_init(&pipeline_queue);
+
+    pthread_t render;
+    pthread_t flush;
+    assert(pthread_create(&flush, NULL, flush_thread, NULL) == 0);
+    assert(pthread_create(&render, NULL, render_thread, NULL) == 0);
+    assert(pthread_join(render, NULL) == 0);
+    assert(pthread_join(flush, NULL) == 0);
+
+    assert(num_flushed == NUM_STRIPES);
+    assert(flush_queue_empty(&pipeline_queue));
+}
+
+int main(void) {
+    test_single_thread();
+    test_pipeline_threads();
+
+    printf("test_flush_queue: OK\n");
+    return 0;
+}
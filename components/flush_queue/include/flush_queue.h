@@ -0,0 +1,84 @@
+#ifndef __FLUSH_QUEUE_H__
+#define __FLUSH_QUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define FLUSH_QUEUE_SIZE 4  // Power of 2, LVGL hands over one draw buffer at a time
+
+/**
+ * @brief One Rendered Stripe, the area and pixels of an LVGL flush
+ * 
+ */
+typedef struct {
+    int x_start;        // First column
+    int y_start;        // First row
+    int x_end;          // Last column, included
+    int y_end;          // Last row, included
+    const void* data;   // Pixels, owned by the producer until the stripe is popped
+    bool last;          // Last stripe of a refresh
+} flush_stripe_t;
+
+/**
+ * @brief Lock-free Queue of Rendered Stripes
+ * 
+ * One producer (the render task) and one consumer (the flush task), on any cores. The consumer works on the
+ * stripe in place and pops it when done, so an empty queue means every stripe has been handed to the panel.
+ * 
+ */
+typedef struct {
+    flush_stripe_t stripes[FLUSH_QUEUE_SIZE];
+    atomic_uint head;   // Next slot to write, only written by the producer
+    atomic_uint tail;   // Next slot to read, only written by the consumer
+} flush_queue_t;
+
+/**
+ * @brief Empty the queue, call before the producer and the consumer start
+ * 
+ * @param queue Queue
+ */
+void flush_queue_init(flush_queue_t* queue);
+
+/**
+ * @brief Add a stripe, producer only
+ * 
+ * @param queue Queue
+ * @param stripe Stripe, copied into the queue
+ * @return bool false if the queue is full
+ */
+bool flush_queue_push(flush_queue_t* queue, const flush_stripe_t* stripe);
+
+/**
+ * @brief Get the oldest stripe without removing it, consumer only
+ * 
+ * @param queue Queue
+ * @return const flush_stripe_t* NULL if the queue is empty
+ */
+const flush_stripe_t* flush_queue_front(flush_queue_t* queue);
+
+/**
+ * @brief Remove the oldest stripe once it is handled, consumer only
+ * 
+ * @param queue Queue, must not be empty
+ */
+void flush_queue_pop(flush_queue_t* queue);
+
+/**
+ * @brief Check whether every pushed stripe has been popped, from any task
+ * 
+ * @param queue Queue
+ * @return bool 
+ */
+bool flush_queue_empty(flush_queue_t* queue);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __FLUSH_QUEUE_H__
@@ -0,0 +1,79 @@
+#include "frame_telemetry.h"
+
+#include <string.h>
+
+// Sequence numbers run freely and wrap at 2^32, the slot is the number modulo FRAME_TELEMETRY_SIZE
+
+static const char* const phase_names[FRAME_PHASE_NUM] = {
+    [FRAME_PHASE_LAYOUT] = "layout",
+    [FRAME_PHASE_JOIN] = "join",
+    [FRAME_PHASE_RENDER] = "render",
+    [FRAME_PHASE_FLUSH_WAIT] = "flush_wait",
+    [FRAME_PHASE_FLUSH] = "flush",
+};
+
+void frame_telemetry_init(frame_telemetry_t* telemetry) {
+    memset(telemetry, 0, sizeof(*telemetry));
+}
+
+void frame_telemetry_begin(frame_telemetry_t* telemetry, int64_t now_us) {
+    memset(&telemetry -> current, 0, sizeof(telemetry -> current));
+    telemetry -> current.start_us = now_us;
+}
+
+void frame_telemetry_phase_begin(frame_telemetry_t* telemetry, frame_phase_t phase, int64_t now_us) {
+    telemetry -> phase_start_us[phase] = now_us;
+}
+
+void frame_telemetry_phase_end(frame_telemetry_t* telemetry, frame_phase_t phase, int64_t now_us, uint32_t pixels) {
+    frame_record_t* frame = &telemetry -> current;
+    uint32_t elapsed_us = now_us - telemetry -> phase_start_us[phase];
+    frame -> phase_us[phase] += elapsed_us;
+
+    if (phase == FRAME_PHASE_RENDER) {
+        frame -> areas++;
+        frame -> rendered_px += pixels;
+        if (elapsed_us > frame -> render_max_us) {
+            frame -> render_max_us = elapsed_us;
+        }
+    }
+}
+
+frame_record_t* frame_telemetry_current(frame_telemetry_t* telemetry) {
+    return &telemetry -> current;
+}
+
+bool frame_telemetry_end(frame_telemetry_t* telemetry, int64_t now_us) {
+    frame_record_t* frame = &telemetry -> current;
+    if (!frame -> areas) {
+        return false;
+    }
+
+    frame -> seq = telemetry -> next_seq++;
+    frame -> frame_us = now_us - frame -> start_us;
+    telemetry -> records[frame -> seq % FRAME_TELEMETRY_SIZE] = *frame;
+
+    return true;
+}
+
+size_t frame_telemetry_read(const frame_telemetry_t* telemetry, uint32_t* seq, frame_record_t* records, size_t max_records) {
+    uint32_t first = *seq;
+    uint32_t available = telemetry -> next_seq - first;
+    if (available > FRAME_TELEMETRY_SIZE) {
+        // Overwritten since the last read, or ahead of the writer after an init
+        available = telemetry -> next_seq < FRAME_TELEMETRY_SIZE ? telemetry -> next_seq : FRAME_TELEMETRY_SIZE;
+        first = telemetry -> next_seq - available;
+    }
+
+    size_t count = available < max_records ? available : max_records;
+    for (size_t i = 0; i < count; i++) {
+        records[i] = telemetry -> records[(first + i) % FRAME_TELEMETRY_SIZE];
+    }
+    *seq = first + count;
+
+    return count;
+}
+
+const char* frame_telemetry_phase_name(frame_phase_t phase) {
+    return phase < FRAME_PHASE_NUM ? phase_names[phase] : "?";
+}
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "frame_telemetry.h"
+
+static frame_telemetry_t telemetry;
+
+// A frame of `areas` areas of 100 pixels, each phase lasting its index + 1 us per area
+static int64_t record_frame(int64_t now_us, int areas) {
+    frame_telemetry_begin(&telemetry, now_us);
+    frame_telemetry_phase_begin(&telemetry, FRAME_PHASE_LAYOUT, now_us);
+    now_us += 1;
+    frame_telemetry_phase_end(&telemetry, FRAME_PHASE_LAYOUT, now_us, 0);
+    frame_telemetry_phase_begin(&telemetry, FRAME_PHASE_JOIN, now_us);
+    now_us += 2;
+    frame_telemetry_phase_end(&telemetry, FRAME_PHASE_JOIN, now_us, 0);
+
+    for (int i = 0; i < areas; i++) {
+        frame_telemetry_phase_begin(&telemetry, FRAME_PHASE_RENDER, now_us);
+        now_us += 3 + i;
+        frame_telemetry_phase_end(&telemetry, FRAME_PHASE_RENDER, now_us, 100);
+        frame_telemetry_phase_begin(&telemetry, FRAME_PHASE_FLUSH_WAIT, now_us);
+        now_us += 4;
+        frame_telemetry_phase_end(&telemetry, FRAME_PHASE_FLUSH_WAIT, now_us, 0);
+        frame_telemetry_phase_begin(&telemetry, FRAME_PHASE_FLUSH, now_us);
+        now_us += 5;
+        frame_telemetry_phase_end(&telemetry, FRAME_PHASE_FLUSH, now_us, 100);
+    }
+
+    frame_telemetry_current(&telemetry) -> drawn_px = areas * 150;
+    now_us += 10;
+    frame_telemetry_end(&telemetry, now_us);
+
+    return now_us;
+}
+
+static void test_phases(void) {
+    frame_telemetry_init(&telemetry);
+    record_frame(1000, 3);
+
+    frame_record_t record;
+    uint32_t seq = 0;
+    assert(frame_telemetry_read(&telemetry, &seq, &record, 1) == 1);
+    assert(seq == 1);
+
+    assert(record.seq == 0);
+    assert(record.start_us == 1000);
+    assert(record.phase_us[FRAME_PHASE_LAYOUT] == 1);
+    assert(record.phase_us[FRAME_PHASE_JOIN] == 2);
+    assert(record.phase_us[FRAME_PHASE_RENDER] == 3 + 4 + 5);
+    assert(record.phase_us[FRAME_PHASE_FLUSH_WAIT] == 3 * 4);
+    assert(record.phase_us[FRAME_PHASE_FLUSH] == 3 * 5);
+    assert(record.render_max_us == 5);
+    assert(record.frame_us == 1 + 2 + 12 + 12 + 15 + 10);
+    assert(record.areas == 3);
+    assert(record.rendered_px == 300);
+    assert(record.drawn_px == 450);
+
+    // Nothing new
+    assert(frame_telemetry_read(&telemetry, &seq, &record, 1) == 0);
+    assert(seq == 1);
+}
+
+static void test_empty_frame_dropped(void) {
+    frame_telemetry_init(&telemetry);
+    record_frame(0, 0);
+
+    frame_record_t record;
+    uint32_t seq = 0;
+    assert(frame_telemetry_read(&telemetry, &seq, &record, 1) == 0);
+    assert(seq == 0);
+
+    // The next frame starts clean
+    record_frame(100, 1);
+    assert(frame_telemetry_read(&telemetry, &seq, &record, 1) == 1);
+    assert(record.seq == 0);
+    assert(record.areas == 1);
+    assert(record.phase_us[FRAME_PHASE_LAYOUT] == 1);
+}
+
+static void test_readers_fall_behind(void) {
+    frame_telemetry_init(&telemetry);
+
+    int64_t now_us = 0;
+    for (int i = 0; i < FRAME_TELEMETRY_SIZE + 10; i++) {
+        now_us = record_frame(now_us, 1);
+    }
+
+    // The first 10 frames are overwritten
+    frame_record_t records[FRAME_TELEMETRY_SIZE];
+    uint32_t seq = 0;
+    assert(frame_telemetry_read(&telemetry, &seq, records, 4) == 4);
+    assert(records[0].seq == 10);
+    assert(records[3].seq == 13);
+    assert(seq == 14);
+
+    size_t count = frame_telemetry_read(&telemetry, &seq, records, FRAME_TELEMETRY_SIZE);
+    assert(count == FRAME_TELEMETRY_SIZE - 4);
+    for (size_t i = 0; i < count; i++) {
+        assert(records[i].seq == 14 + i);
+    }
+    assert(seq == FRAME_TELEMETRY_SIZE + 10);
+
+    // A reader ahead of the writer, e.g. after an init, gets what is there
+    frame_telemetry_init(&telemetry);
+    record_frame(0, 1);
+    record_frame(100, 1);
+    assert(frame_telemetry_read(&telemetry, &seq, records, FRAME_TELEMETRY_SIZE) == 2);
+    assert(records[0].seq == 0);
+    assert(seq == 2);
+}
+
+int main(void) {
+    test_phases();
+    test_empty_frame_dropped();
+    test_readers_fall_behind();
+
+    assert(strcmp(frame_telemetry_phase_name(FRAME_PHASE_FLUSH_WAIT), "flush_wait") == 0);
+
+    printf("test_frame_telemetry: OK\n");
+    return 0;
+}
@@ -0,0 +1,135 @@
+#ifndef __FRAME_TELEMETRY_H__
+#define __FRAME_TELEMETRY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define FRAME_TELEMETRY_SIZE 64     // Power of 2, frames kept for the readers
+
+/**
+ * @brief Timed Phases of a Frame, the same steps as the refresh phases of LVGL
+ *
+ */
+typedef enum {
+    FRAME_PHASE_LAYOUT,
+    FRAME_PHASE_JOIN,
+    FRAME_PHASE_RENDER,         // Sum of the rendered areas
+    FRAME_PHASE_FLUSH_WAIT,     // Waiting for a draw buffer to come back
+    FRAME_PHASE_FLUSH,          // Handing the draw buffers over, the transfer itself runs on
+    FRAME_PHASE_NUM,
+} frame_phase_t;
+
+/**
+ * @brief Timings and Counters of One Frame
+ *
+ */
+typedef struct {
+    uint32_t seq;                           // Frame number, counts every frame recorded since init
+    int64_t start_us;                       // Start of the frame
+    uint32_t frame_us;                      // Whole frame, the phases and what is between them
+    uint32_t phase_us[FRAME_PHASE_NUM];
+    uint32_t render_max_us;                 // Longest render of one area
+    uint16_t areas;                         // Areas rendered, each one flushed
+    uint32_t rendered_px;                   // Pixels of the rendered areas
+    uint32_t drawn_px;                      // Pixels written by the renderer, above rendered_px is overdraw
+    uint32_t heap_free;                     // Memory at the end of the frame, filled by the caller
+    uint32_t heap_min_free;
+    uint32_t gui_mem_used;
+} frame_record_t;
+
+/**
+ * @brief Ring Buffer of Frame Records
+ *
+ * One writer times the phases of the frame in progress, a frame is only recorded when it rendered something.
+ * Readers keep their own position, the oldest frames are overwritten when they fall behind. Writer and readers
+ * are serialized by the caller, e.g. by the lock of the GUI library.
+ *
+ */
+typedef struct {
+    frame_record_t records[FRAME_TELEMETRY_SIZE];
+    uint32_t next_seq;                      // Sequence number of the next recorded frame
+    frame_record_t current;                 // Frame in progress
+    int64_t phase_start_us[FRAME_PHASE_NUM];
+} frame_telemetry_t;
+
+/**
+ * @brief Drop every record
+ *
+ * @param telemetry Telemetry
+ */
+void frame_telemetry_init(frame_telemetry_t* telemetry);
+
+/**
+ * @brief Start a frame, the frame in progress if any is dropped
+ *
+ * @param telemetry Telemetry
+ * @param now_us Current time
+ */
+void frame_telemetry_begin(frame_telemetry_t* telemetry, int64_t now_us);
+
+/**
+ * @brief Start a phase of the frame in progress
+ *
+ * @param telemetry Telemetry
+ * @param phase Phase
+ * @param now_us Current time
+ */
+void frame_telemetry_phase_begin(frame_telemetry_t* telemetry, frame_phase_t phase, int64_t now_us);
+
+/**
+ * @brief End a phase, its time adds up with the previous ones of the same phase in this frame
+ *
+ * @param telemetry Telemetry
+ * @param phase Phase
+ * @param now_us Current time
+ * @param pixels Pixels of the area, counted as a rendered area with FRAME_PHASE_RENDER and ignored otherwise
+ */
+void frame_telemetry_phase_end(frame_telemetry_t* telemetry, frame_phase_t phase, int64_t now_us, uint32_t pixels);
+
+/**
+ * @brief Get the frame in progress to fill the counters not timed here before it ends
+ *
+ * @param telemetry Telemetry
+ * @return frame_record_t*
+ */
+frame_record_t* frame_telemetry_current(frame_telemetry_t* telemetry);
+
+/**
+ * @brief End the frame in progress and record it if it rendered an area
+ *
+ * @param telemetry Telemetry
+ * @param now_us Current time
+ * @return bool true if the frame is recorded
+ */
+bool frame_telemetry_end(frame_telemetry_t* telemetry, int64_t now_us);
+
+/**
+ * @brief Copy the frames recorded from a sequence number on, oldest first
+ *
+ * @param telemetry Telemetry
+ * @param seq In: first frame wanted, out: the frame after the last one copied. Frames already overwritten are
+ *            skipped, the gap in the sequence numbers tells how many.
+ * @param records Copies of the frames
+ * @param max_records Size of records
+ * @return size_t Frames copied
+ */
+size_t frame_telemetry_read(const frame_telemetry_t* telemetry, uint32_t* seq, frame_record_t* records, size_t max_records);
+
+/**
+ * @brief Name of a phase, for logs and column headers
+ *
+ * @param phase Phase
+ * @return const char*
+ */
+const char* frame_telemetry_phase_name(frame_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // __FRAME_TELEMETRY_H__
@@ -115,16 +115,19 @@
 #define LV_DRAW_COMPLEX 1
 #if LV_DRAW_COMPLEX != 0
 
-    /*Allow buffering some shadow calculation.
-    *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
-    #define LV_SHADOW_CACHE_SIZE 0
-
-    /* Set number of maximally cached circle data.
-    * The circumference of 1/4 circle are saved for anti-aliasing
-    * radius * 4 bytes are used per circle (the most often used radiuses are saved)
+    /*Maximum memory (in bytes) of the cached blurred shadow corners.
+    *A corner has (shadow_width + radius)^2 bytes and a 24 bytes descriptor on 32 bit targets.
+    *The least recently used corner is freed first.
+    *Replaces LV_SHADOW_CACHE_SIZE, the largest cached shadow size, which is rejected. 0: to disable caching*/
+    #define LV_SHADOW_CACHE_DEF_SIZE 8192
+
+    /* Maximum memory (in bytes) of the cached circle data of the rounded corners.
+    * The circumference of 1/4 circle are saved for anti-aliasing and kept between the refreshes.
+    * radius * 6 + 6 bytes and a descriptor (40 bytes on 32 bit targets) are used per circle
+    * (the least recently used is freed first)
+    * Replaces LV_CIRCLE_CACHE_SIZE, a number of circles, which is rejected.
     * 0: to disable caching */
-    #define LV_CIRCLE_CACHE_SIZE 4
+    #define LV_CIRCLE_CACHE_DEF_SIZE 4096
 #endif /*LV_DRAW_COMPLEX*/
 
 /**
@@ -393,6 +396,13 @@
 
 /*Enables/disables support for compressed fonts.*/
 #define LV_USE_FONT_COMPRESSED 0
+#if LV_USE_FONT_COMPRESSED
+    /*Maximum memory (in bytes) of the decompressed glyph bitmaps kept between the refreshes.
+     *A bitmap has box_w * box_h * bpp / 8 bytes and a descriptor (28 bytes on 32 bit targets)
+     *(the least recently used is freed first)
+     *0: to disable caching*/
+    #define LV_FONT_BITMAP_CACHE_DEF_SIZE 8192
+#endif
 
 /*Enable subpixel rendering*/
 #define LV_USE_FONT_SUBPX 0
@@ -168,6 +168,14 @@ LV_EXPORT_CONST_INT(LV_DPI_DEF);
     #define LV_LOG_TRACE_ANIM       0
 #endif  /*LV_USE_LOG*/
 
+/*Options replaced by ones with a different meaning, the old value would be ignored silently*/
+#ifdef LV_CIRCLE_CACHE_SIZE
+    #error "LV_CIRCLE_CACHE_SIZE (number of circles) is replaced by LV_CIRCLE_CACHE_DEF_SIZE (bytes)"
+#endif
+#ifdef LV_SHADOW_CACHE_SIZE
+    #error "LV_SHADOW_CACHE_SIZE (largest shadow size) is replaced by LV_SHADOW_CACHE_DEF_SIZE (bytes)"
+#endif
+
 
 /*If running without lv_conf.h add typedefs with default value*/
 #ifdef LV_CONF_SKIP
@@ -14,6 +14,7 @@
 #include "lv_theme.h"
 #include "../misc/lv_assert.h"
 #include "../draw/lv_draw.h"
+#include "../draw/sw/lv_draw_sw.h"
 #include "../misc/lv_anim.h"
 #include "../misc/lv_timer.h"
 #include "../misc/lv_async.h"
@@ -196,6 +197,13 @@ void lv_init(void)
 
 void lv_deinit(void)
 {
+#if LV_DRAW_COMPLEX
+    _lv_draw_mask_cleanup();
+    lv_draw_sw_shadow_free_cache();
+#endif
+#if LV_USE_FONT_COMPRESSED
+    lv_font_fmt_txt_free_bitmap_cache(NULL);
+#endif
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
@@ -858,9 +866,19 @@ static void lv_obj_event(const lv_obj_class_t * class_p, lv_event_t * e)
         lv_coord_t h = lv_obj_get_style_height(obj, LV_PART_MAIN);
         lv_coord_t align = lv_obj_get_style_align(obj, LV_PART_MAIN);
         uint16_t layout = lv_obj_get_style_layout(obj, LV_PART_MAIN);
-        if(layout || align || w == LV_SIZE_CONTENT || h == LV_SIZE_CONTENT) {
+        lv_obj_t * child = lv_event_get_param(e);
+        if(align || w == LV_SIZE_CONTENT || h == LV_SIZE_CONTENT) {
             lv_obj_mark_layout_as_dirty(obj);
         }
+        else if(layout) {
+            /*Only a child of this object changed, the layout can start from it*/
+            if(child && lv_obj_get_parent(child) == obj) {
+                _lv_obj_mark_layout_children_as_dirty(obj, lv_obj_get_index(child));
+            }
+            else {
+                lv_obj_mark_layout_as_dirty(obj);
+            }
+        }
     }
     else if(code == LV_EVENT_CHILD_DELETED) {
         obj->readjust_scroll_after_layout = 1;
@@ -162,6 +162,8 @@ typedef struct {
 
     lv_coord_t ext_click_pad;           /**< Extra click padding in all direction*/
     lv_coord_t ext_draw_size;           /**< EXTend the size in every direction for drawing.*/
+    uint32_t layout_inv_child_id;       /**< While the layout is updated: the first child whose size changed, 0 if all
+                                          *  the children are placed again*/
 
     lv_scrollbar_mode_t scrollbar_mode : 2; /**< How to display scrollbars*/
     lv_scroll_snap_t scroll_snap_x : 2;     /**< Where to align the snappable children horizontally*/
@@ -190,6 +192,8 @@ typedef struct _lv_obj_t {
     uint16_t h_layout   : 1;
     uint16_t w_layout   : 1;
     uint16_t being_deleted   : 1;
+    uint16_t layout_children_inv : 1;   /**< Only the size of some children changed, see `layout_inv_child_id`*/
+    uint16_t tree_layout_inv : 1;       /**< A descendant has its layout invalidated*/
 } lv_obj_t;
 
 
@@ -26,6 +26,7 @@
 static lv_coord_t calc_content_width(lv_obj_t * obj);
 static lv_coord_t calc_content_height(lv_obj_t * obj);
 static void layout_update_core(lv_obj_t * obj);
+static void mark_tree_layout_as_dirty(lv_obj_t * obj);
 static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv);
 
 /**********************
@@ -201,6 +202,7 @@ bool lv_obj_refr_size(lv_obj_t * obj)
     lv_obj_invalidate(obj);
 
     obj->readjust_scroll_after_layout = 1;
+    mark_tree_layout_as_dirty(obj);
 
     /*If the object was out of the parent invalidate the new scrollbar area too.
      *If it wasn't out of the parent but out now, also invalidate the scrollbars*/
@@ -288,6 +290,7 @@ bool lv_obj_is_layout_positioned(const lv_obj_t * obj)
 void lv_obj_mark_layout_as_dirty(lv_obj_t * obj)
 {
     obj->layout_inv = 1;
+    mark_tree_layout_as_dirty(obj);
 
     /*Mark the screen as dirty too to mark that there is something to do on this screen*/
     lv_obj_t * scr = lv_obj_get_screen(obj);
@@ -298,6 +301,24 @@ void lv_obj_mark_layout_as_dirty(lv_obj_t * obj)
     if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
 }
 
+void _lv_obj_mark_layout_children_as_dirty(lv_obj_t * obj, uint32_t child_id)
+{
+    /*Already updated from the first child*/
+    if(obj->layout_inv) return;
+
+    if(obj->layout_children_inv == 0 || child_id < obj->spec_attr->layout_inv_child_id) {
+        obj->spec_attr->layout_inv_child_id = child_id;
+    }
+    obj->layout_children_inv = 1;
+    mark_tree_layout_as_dirty(obj);
+
+    lv_obj_t * scr = lv_obj_get_screen(obj);
+    scr->scr_layout_inv = 1;
+
+    lv_disp_t * disp = lv_obj_get_disp(scr);
+    if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
+}
+
 void lv_obj_update_layout(const lv_obj_t * obj)
 {
     static bool mutex = false;
@@ -1132,15 +1153,29 @@ static void layout_update_core(lv_obj_t * obj)
 {
     uint32_t i;
     uint32_t child_cnt = lv_obj_get_child_cnt(obj);
-    for(i = 0; i < child_cnt; i++) {
-        lv_obj_t * child = obj->spec_attr->children[i];
-        layout_update_core(child);
+
+    /*Go down only into the subtrees with something to update*/
+    if(obj->tree_layout_inv) {
+        obj->tree_layout_inv = 0;
+        for(i = 0; i < child_cnt; i++) {
+            lv_obj_t * child = obj->spec_attr->children[i];
+            if(child->layout_inv || child->layout_children_inv || child->tree_layout_inv ||
+               child->readjust_scroll_after_layout) {
+                layout_update_core(child);
+            }
+        }
     }
 
-    if(obj->layout_inv) {
-        obj->layout_inv = 0;
-        lv_obj_refr_size(obj);
-        lv_obj_refr_pos(obj);
+    if(obj->layout_inv || obj->layout_children_inv) {
+        /*If only some children changed size the object keeps its size and position*/
+        if(obj->layout_inv) {
+            obj->layout_inv = 0;
+            obj->layout_children_inv = 0;
+            lv_obj_refr_size(obj);
+            lv_obj_refr_pos(obj);
+            if(obj->spec_attr) obj->spec_attr->layout_inv_child_id = 0;
+        }
+        obj->layout_children_inv = 0;
 
         if(child_cnt > 0) {
             uint32_t layout_id = lv_obj_get_style_layout(obj, LV_PART_MAIN);
@@ -1148,6 +1183,7 @@ static void layout_update_core(lv_obj_t * obj)
                 void  * user_data = LV_GC_ROOT(_lv_layout_list)[layout_id - 1].user_data;
                 LV_GC_ROOT(_lv_layout_list)[layout_id - 1].cb(obj, user_data);
             }
+            obj->spec_attr->layout_inv_child_id = 0;
         }
     }
 
@@ -1157,6 +1193,17 @@ static void layout_update_core(lv_obj_t * obj)
     }
 }
 
+/*Mark the parents to find `obj` when the layout is updated. Not stopped at a marked parent because
+ *the parents' marks are cleared on the way down and an update in progress can mark them again.*/
+static void mark_tree_layout_as_dirty(lv_obj_t * obj)
+{
+    lv_obj_t * parent = lv_obj_get_parent(obj);
+    while(parent) {
+        parent->tree_layout_inv = 1;
+        parent = lv_obj_get_parent(parent);
+    }
+}
+
 static void transform_point(const lv_obj_t * obj, lv_point_t * p, bool inv)
 {
     int16_t angle = lv_obj_get_style_transform_angle(obj, 0);
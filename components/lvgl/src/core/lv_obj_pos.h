@@ -146,6 +146,15 @@ bool lv_obj_is_layout_positioned(const struct _lv_obj_t * obj);
  */
 void lv_obj_mark_layout_as_dirty(struct _lv_obj_t * obj);
 
+/**
+ * Mark the layout of an object for update because the size of one of its children changed.
+ * Unlike `lv_obj_mark_layout_as_dirty` the size and position of the object are kept, and the layout
+ * can skip the children before the changed one.
+ * @param obj       pointer to an object with a layout
+ * @param child_id  index of the child whose size changed
+ */
+void _lv_obj_mark_layout_children_as_dirty(struct _lv_obj_t * obj, uint32_t child_id);
+
 /**
  * Update the layout of an object.
  * @param obj      pointer to an object whose children needs to be updated
@@ -26,16 +26,25 @@
 /*********************
  *      DEFINES
  *********************/
+#define OCCLUDER_MAX    16  /*Opaque objects remembered while drawing, the others hide nothing*/
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    lv_area_t area;             /*Opaque part of the object on the clip area*/
+    const lv_obj_t * parent;    /*Parent of the opaque object*/
+    uint32_t index;             /*Child index of the opaque object, it hides its older siblings and their children*/
+} occluder_t;
+
 typedef struct {
     uint32_t    perf_last_time;
     uint32_t    elaps_sum;
     uint32_t    frame_cnt;
     uint32_t    fps_sum_cnt;
     uint32_t    fps_sum_all;
+    uint32_t    drawn_px_start;
+    uint32_t    flushed_px_start;
 #if LV_USE_LABEL
     lv_obj_t  * perf_label;
 #endif
@@ -52,16 +61,26 @@ typedef struct {
  *  STATIC PROTOTYPES
  **********************/
 static void lv_refr_join_area(void);
+static int32_t join_cost(const lv_area_t * a1_p, const lv_area_t * a2_p);
+static void inv_area_coalesce(lv_disp_t * disp, const lv_area_t * area_p);
 static void refr_invalid_areas(void);
+static void refr_invalid_bands(void);
+static void refr_band(const lv_area_t * band_p);
 static void refr_sync_areas(void);
 static void refr_area(const lv_area_t * area_p);
 static void refr_area_part(lv_draw_ctx_t * draw_ctx);
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj);
 static void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
+static void refr_obj_culled(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj);
+static void occluders_push_children(lv_obj_t * obj, uint32_t first, const lv_area_t * clip_area);
+static void occluders_push_younger(lv_obj_t * obj, const lv_area_t * clip_area);
+static void occluders_pop(const lv_obj_t * parent, uint32_t index);
+static bool occluders_clip(lv_area_t * area);
 static uint32_t get_max_row(lv_disp_t * disp, lv_coord_t area_w, lv_coord_t area_h);
 static void draw_buf_flush(lv_disp_t * disp);
 static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void refr_phase(lv_disp_refr_phase_t phase, bool end, const lv_area_t * area);
 
 #if LV_USE_PERF_MONITOR
     static void perf_monitor_init(perf_monitor_t * perf_monitor);
@@ -75,6 +94,14 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
  **********************/
 static uint32_t px_num;
 static lv_disp_t * disp_refr; /*Display being refreshed*/
+static uint32_t drawn_px;     /*Pixels written by the renderer*/
+static uint32_t flushed_px;   /*Pixels passed to `flush_cb`*/
+
+/*Opaque objects drawn after the object being drawn. The children of an object are pushed
+ *in descending index order so the occluders of the youngest children are on the top.*/
+static occluder_t occluders[OCCLUDER_MAX];
+static uint32_t occluder_cnt;
+static uint32_t occluder_floor;   /*Occluders below are out of the layer being drawn*/
 
 #if LV_USE_PERF_MONITOR
     static perf_monitor_t   perf_monitor;
@@ -141,24 +168,6 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
     /*If the object is visible on the current clip area OR has overflow visible draw it.
      *With overflow visible drawing should happen to apply the masks which might affect children */
     bool should_draw = com_clip_res || lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
-    if(should_draw) {
-        draw_ctx->clip_area = &clip_coords_for_obj;
-
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
-        lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
-#if LV_USE_REFR_DEBUG
-        lv_color_t debug_color = lv_color_make(lv_rand(0, 0xFF), lv_rand(0, 0xFF), lv_rand(0, 0xFF));
-        lv_draw_rect_dsc_t draw_dsc;
-        lv_draw_rect_dsc_init(&draw_dsc);
-        draw_dsc.bg_color.full = debug_color.full;
-        draw_dsc.bg_opa = LV_OPA_20;
-        draw_dsc.border_width = 1;
-        draw_dsc.border_opa = LV_OPA_30;
-        draw_dsc.border_color = debug_color;
-        lv_draw_rect(draw_ctx, &draw_dsc, &obj_coords_ext);
-#endif
-    }
 
     /*With overflow visible keep the previous clip area to let the children visible out of this object too
      *With not overflow visible limit the clip are to the object's coordinates to clip the children*/
@@ -173,15 +182,59 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
         }
     }
 
+    /*The opaque children hide the parts of the object under them*/
+    uint32_t occluder_start = occluder_cnt;
+    if(refr_children && disp_refr->driver->cull_occluded) {
+        occluders_push_children(obj, 0, &clip_coords_for_children);
+    }
+
+    if(should_draw) {
+        /*Without overflow visible the main draw is only clipped by the objects drawn later,
+         *if they hide all of it there is no mask to apply for the children either*/
+        lv_area_t clip_coords_for_main = clip_coords_for_obj;
+        bool main_visible = true;
+        if(com_clip_res && !lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) {
+            main_visible = occluders_clip(&clip_coords_for_main);
+        }
+
+        if(main_visible) {
+            draw_ctx->clip_area = &clip_coords_for_main;
+
+            lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
+            lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
+            lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+#if LV_USE_REFR_DEBUG
+            lv_color_t debug_color = lv_color_make(lv_rand(0, 0xFF), lv_rand(0, 0xFF), lv_rand(0, 0xFF));
+            lv_draw_rect_dsc_t draw_dsc;
+            lv_draw_rect_dsc_init(&draw_dsc);
+            draw_dsc.bg_color.full = debug_color.full;
+            draw_dsc.bg_opa = LV_OPA_20;
+            draw_dsc.border_width = 1;
+            draw_dsc.border_opa = LV_OPA_30;
+            draw_dsc.border_color = debug_color;
+            lv_draw_rect(draw_ctx, &draw_dsc, &obj_coords_ext);
+#endif
+        }
+    }
+
+    /*Masks added by the main draw (e.g. by an event) clip the children, masked children hide nothing*/
+    uint32_t i;
+    uint32_t kept = occluder_start;
+    for(i = occluder_start; i < occluder_cnt; i++) {
+        if(!lv_draw_mask_is_any(&occluders[i].area)) occluders[kept++] = occluders[i];
+    }
+    occluder_cnt = kept;
+
     if(refr_children) {
         draw_ctx->clip_area = &clip_coords_for_children;
-        uint32_t i;
         uint32_t child_cnt = lv_obj_get_child_cnt(obj);
         for(i = 0; i < child_cnt; i++) {
             lv_obj_t * child = obj->spec_attr->children[i];
-            refr_obj(draw_ctx, child);
+            occluders_pop(obj, i);
+            refr_obj_culled(draw_ctx, child);
         }
     }
+    occluder_cnt = occluder_start;
 
     /*If the object was visible on the clip area call the post draw events too*/
     if(should_draw) {
@@ -251,12 +304,11 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     /*Save the area*/
     if(disp->inv_p < LV_INV_BUF_SIZE) {
         lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
+        disp->inv_p++;
     }
-    else {   /*If no place for the area add the screen*/
-        disp->inv_p = 0;
-        lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+    else {   /*If no place for the area join the two cheapest areas to make place*/
+        inv_area_coalesce(disp, &com_area);
     }
-    disp->inv_p++;
     if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
 }
 
@@ -305,22 +357,29 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         disp_refr = lv_disp_get_default();
     }
 
+    refr_phase(LV_DISP_REFR_PHASE_REFR, false, NULL);
+
     /*Refresh the screen's layout if required*/
+    refr_phase(LV_DISP_REFR_PHASE_LAYOUT, false, NULL);
     lv_obj_update_layout(disp_refr->act_scr);
     if(disp_refr->prev_scr) lv_obj_update_layout(disp_refr->prev_scr);
 
     lv_obj_update_layout(disp_refr->top_layer);
     lv_obj_update_layout(disp_refr->sys_layer);
+    refr_phase(LV_DISP_REFR_PHASE_LAYOUT, true, NULL);
 
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
         LV_LOG_WARN("there is no active screen");
+        refr_phase(LV_DISP_REFR_PHASE_REFR, true, NULL);
         REFR_TRACE("finished");
         return;
     }
 
+    refr_phase(LV_DISP_REFR_PHASE_JOIN, false, NULL);
     lv_refr_join_area();
+    refr_phase(LV_DISP_REFR_PHASE_JOIN, true, NULL);
     refr_sync_areas();
     refr_invalid_areas();
 
@@ -356,9 +415,7 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     lv_mem_buf_free_all();
     _lv_font_clean_up_fmt_txt();
 
-#if LV_DRAW_COMPLEX
-    _lv_draw_mask_cleanup();
-#endif
+    refr_phase(LV_DISP_REFR_PHASE_REFR, true, NULL);
 
 #if LV_USE_PERF_MONITOR && LV_USE_LABEL
     lv_obj_t * perf_label = perf_monitor.perf_label;
@@ -413,7 +470,16 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         perf_monitor.fps_sum_all += fps;
         perf_monitor.fps_sum_cnt ++;
         uint32_t cpu = 100 - lv_timer_get_idle();
-        lv_label_set_text_fmt(perf_label, "%"LV_PRIu32" FPS\n%"LV_PRIu32"%% CPU", fps, cpu);
+
+        /*Pixels written more than once since the last update, 0% if each flushed pixel is written once*/
+        uint32_t drawn = drawn_px - perf_monitor.drawn_px_start;
+        uint32_t flushed = flushed_px - perf_monitor.flushed_px_start;
+        uint32_t overdraw = flushed && drawn > flushed ? (uint32_t)(((uint64_t)drawn - flushed) * 100 / flushed) : 0;
+        perf_monitor.drawn_px_start = drawn_px;
+        perf_monitor.flushed_px_start = flushed_px;
+
+        lv_label_set_text_fmt(perf_label, "%"LV_PRIu32" FPS, %"LV_PRIu32"%% CPU\n%"LV_PRIu32"%% overdraw", fps, cpu,
+                              overdraw);
     }
 #endif
 
@@ -451,6 +517,27 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     REFR_TRACE("finished");
 }
 
+void _lv_refr_add_drawn_px(uint32_t px)
+{
+    drawn_px += px;
+}
+
+void lv_refr_get_overdraw(uint32_t * drawn, uint32_t * flushed)
+{
+    if(drawn) *drawn = drawn_px;
+    if(flushed) *flushed = flushed_px;
+}
+
+void lv_refr_reset_overdraw_counter(void)
+{
+    drawn_px = 0;
+    flushed_px = 0;
+#if LV_USE_PERF_MONITOR
+    perf_monitor.drawn_px_start = 0;
+    perf_monitor.flushed_px_start = 0;
+#endif
+}
+
 #if LV_USE_PERF_MONITOR
 void lv_refr_reset_fps_counter(void)
 {
@@ -473,40 +560,104 @@ uint32_t lv_refr_get_fps_avg(void)
  **********************/
 
 /**
- * Join the areas which has got common parts
+ * Join the areas which are cheaper to redraw together than with one more flush.
+ * Areas in the same rows end up in one band when the gap between them costs less than `flush_cost`.
  */
 static void lv_refr_join_area(void)
 {
+    int32_t flush_cost = (int32_t)disp_refr->driver->flush_cost;
     uint32_t join_from;
     uint32_t join_in;
     lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
+    bool joined;
+
+    /*A grown area can be worth joining with an area it was not before, repeat until nothing changes*/
+    do {
+        joined = false;
+        for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
+            if(disp_refr->inv_area_joined[join_in] != 0) continue;
+
+            /*Check all areas to join them in 'join_in'*/
+            for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
+                /*Handle only unjoined areas and ignore itself*/
+                if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
+                    continue;
+                }
 
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
-            }
+                /*Without flush cost only the areas on each other can be smaller joined*/
+                if(flush_cost == 0 &&
+                   _lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
+                    continue;
+                }
 
-            /*Check if the areas are on each other*/
-            if(_lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
-                continue;
+                /*Join two area only if the pixels added are cheaper than the saved flush*/
+                if(join_cost(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) < flush_cost) {
+                    _lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
+                    lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+
+                    /*Mark 'join_form' is joined into 'join_in'*/
+                    disp_refr->inv_area_joined[join_from] = 1;
+                    joined = true;
+                }
             }
+        }
+    } while(joined);
+}
+
+/**
+ * Get the pixels added by redrawing two areas as their union
+ * @param a1_p pointer to an area
+ * @param a2_p pointer to an other area
+ * @return the pixels of the union minus the pixels of the two areas, negative if they overlap
+ */
+static int32_t join_cost(const lv_area_t * a1_p, const lv_area_t * a2_p)
+{
+    lv_area_t joined_area;
+    _lv_area_join(&joined_area, a1_p, a2_p);
 
-            _lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
+    return (int32_t)lv_area_get_size(&joined_area) - (int32_t)lv_area_get_size(a1_p) -
+           (int32_t)lv_area_get_size(a2_p);
+}
 
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+/**
+ * Save an area in a full invalidate buffer by joining the pair of areas (the new one included)
+ * which adds the fewest pixels, instead of redrawing the whole screen
+ * @param disp pointer to display with `LV_INV_BUF_SIZE` invalidated areas
+ * @param area_p pointer to the area to save
+ */
+static void inv_area_coalesce(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    /*`inv_p` stands for the new area*/
+    const lv_area_t * areas[LV_INV_BUF_SIZE + 1];
+    int32_t sizes[LV_INV_BUF_SIZE + 1];
+    uint32_t i;
+    uint32_t j;
+    for(i = 0; i <= disp->inv_p; i++) {
+        areas[i] = i < disp->inv_p ? &disp->inv_areas[i] : area_p;
+        sizes[i] = (int32_t)lv_area_get_size(areas[i]);
+    }
 
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
+    uint32_t best_in = 0;
+    uint32_t best_from = disp->inv_p;
+    int32_t best_cost = INT32_MAX;
+    for(i = 0; i < disp->inv_p; i++) {
+        for(j = i + 1; j <= disp->inv_p; j++) {
+            int32_t w = LV_MAX(areas[i]->x2, areas[j]->x2) - LV_MIN(areas[i]->x1, areas[j]->x1) + 1;
+            int32_t h = LV_MAX(areas[i]->y2, areas[j]->y2) - LV_MIN(areas[i]->y1, areas[j]->y1) + 1;
+            int32_t cost = w * h - sizes[i] - sizes[j];
+            if(cost < best_cost) {
+                best_cost = cost;
+                best_in = i;
+                best_from = j;
             }
         }
     }
+
+    lv_area_t joined_area;
+    _lv_area_join(&joined_area, areas[best_in], areas[best_from]);
+    /*Two saved areas are joined, the new area takes the freed place*/
+    if(best_from < disp->inv_p) lv_area_copy(&disp->inv_areas[best_from], area_p);
+    lv_area_copy(&disp->inv_areas[best_in], &joined_area);
 }
 
 /**
@@ -609,6 +760,12 @@ static void refr_invalid_areas(void)
     disp_refr->driver->draw_buf->last_part = 0;
     disp_refr->rendering_in_progress = true;
 
+    if(disp_refr->driver->band_refresh && !disp_refr->driver->full_refresh) {
+        refr_invalid_bands();
+        disp_refr->rendering_in_progress = false;
+        return;
+    }
+
     for(i = 0; i < disp_refr->inv_p; i++) {
         /*Refresh the unjoined areas*/
         if(disp_refr->inv_area_joined[i] == 0) {
@@ -624,6 +781,83 @@ static void refr_invalid_areas(void)
     disp_refr->rendering_in_progress = false;
 }
 
+/**
+ * Refresh the rows of the unjoined areas from top to bottom. The dirty span of each row goes into
+ * the current band, so pixels covered by several areas are rendered only once and the object tree
+ * is walked once per band instead of once per area.
+ */
+static void refr_invalid_bands(void)
+{
+    int32_t flush_cost = (int32_t)disp_refr->driver->flush_cost;
+    lv_coord_t last_y = -1;
+    uint32_t i;
+    for(i = 0; i < disp_refr->inv_p; i++) {
+        if(disp_refr->inv_area_joined[i] == 0) last_y = LV_MAX(last_y, disp_refr->inv_areas[i].y2);
+    }
+
+    lv_area_t band;
+    bool band_open = false;
+    lv_coord_t y;
+    for(y = 0; y <= last_y; y++) {
+        /*Dirty span of the row*/
+        lv_area_t row;
+        lv_area_set(&row, LV_COORD_MAX, y, LV_COORD_MIN, y);
+        for(i = 0; i < disp_refr->inv_p; i++) {
+            const lv_area_t * area_p = &disp_refr->inv_areas[i];
+            if(disp_refr->inv_area_joined[i] != 0 || y < area_p->y1 || y > area_p->y2) continue;
+
+            row.x1 = LV_MIN(row.x1, area_p->x1);
+            row.x2 = LV_MAX(row.x2, area_p->x2);
+        }
+
+        /*A clean row ends the band*/
+        if(row.x1 > row.x2) {
+            if(band_open) refr_band(&band);
+            band_open = false;
+            continue;
+        }
+
+        if(band_open) {
+            lv_area_t joined_area;
+            _lv_area_join(&joined_area, &band, &row);
+
+            /*Keep the band if the pixels added are cheaper than an other band*/
+            int32_t cost = (int32_t)lv_area_get_size(&joined_area) - (int32_t)lv_area_get_size(&band) -
+                           (int32_t)lv_area_get_size(&row);
+            if(flush_cost == 0 || cost <= flush_cost) {
+                lv_area_copy(&band, &joined_area);
+                continue;
+            }
+
+            refr_band(&band);
+        }
+
+        lv_area_copy(&band, &row);
+        band_open = true;
+    }
+
+    if(band_open) {
+        disp_refr->driver->draw_buf->last_area = 1;
+        refr_band(&band);
+    }
+}
+
+/**
+ * Refresh a band of `refr_invalid_bands`
+ * @param band_p pointer to the band
+ */
+static void refr_band(const lv_area_t * band_p)
+{
+    lv_area_t band;
+    lv_area_copy(&band, band_p);
+    if(disp_refr->driver->rounder_cb) disp_refr->driver->rounder_cb(disp_refr->driver, &band);
+
+    disp_refr->driver->draw_buf->last_part = 0;
+    refr_area(&band);
+
+    px_num += lv_area_get_size(&band);
+}
+
 /**
  * Refresh an area if there is Virtual Display Buffer
  * @param area_p  pointer to an area to refresh
@@ -708,8 +942,12 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
     bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
     if((draw_buf->buf1 && !draw_buf->buf2) ||
        (draw_buf->buf1 && draw_buf->buf2 && full_sized)) {
-        while(draw_buf->flushing) {
-            if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
+        if(draw_buf->flushing) {
+            refr_phase(LV_DISP_REFR_PHASE_FLUSH_WAIT, false, NULL);
+            while(draw_buf->flushing) {
+                if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
+            }
+            refr_phase(LV_DISP_REFR_PHASE_FLUSH_WAIT, true, NULL);
         }
 
         /*If the screen is transparent initialize it when the flushing is ready*/
@@ -725,6 +963,8 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
 #endif
     }
 
+    refr_phase(LV_DISP_REFR_PHASE_RENDER, false, draw_ctx->buf_area);
+
     lv_obj_t * top_act_scr = NULL;
     lv_obj_t * top_prev_scr = NULL;
 
@@ -795,6 +1035,10 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_top(disp_refr));
     refr_obj_and_children(draw_ctx, lv_disp_get_layer_sys(disp_refr));
 
+    /*Wait for the draw units as the rendered content is flushed right after*/
+    if(draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
+    refr_phase(LV_DISP_REFR_PHASE_RENDER, true, draw_ctx->buf_area);
+
     draw_buf_flush(disp_refr);
 }
 
@@ -852,8 +1096,14 @@ static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj)
     if(top_obj == NULL) top_obj = lv_disp_get_scr_act(disp_refr);
     if(top_obj == NULL) return;  /*Shouldn't happen*/
 
+    occluder_cnt = 0;
+    occluder_floor = 0;
+
+    /*The opaque 'younger' siblings of top_obj and of its parents are drawn later*/
+    if(disp_refr->driver->cull_occluded) occluders_push_younger(top_obj, draw_ctx->clip_area);
+
     /*Refresh the top object and its children*/
-    refr_obj(draw_ctx, top_obj);
+    refr_obj_culled(draw_ctx, top_obj);
 
     /*Draw the 'younger' sibling objects because they can be on top_obj*/
     lv_obj_t * parent;
@@ -873,7 +1123,8 @@ static void refr_obj_and_children(lv_draw_ctx_t * draw_ctx, lv_obj_t * top_obj)
             }
             else {
                 /*Refresh the objects*/
-                refr_obj(draw_ctx, child);
+                occluders_pop(parent, i);
+                refr_obj_culled(draw_ctx, child);
             }
         }
 
@@ -965,6 +1216,138 @@ static void layer_alpha_test(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, lv_draw_l
 }
 
 
+/**
+ * Refresh an object without the parts hidden by the occluders
+ * @param draw_ctx pointer to the draw context, its clip area is kept
+ * @param obj pointer to an object
+ */
+static void refr_obj_culled(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
+{
+    if(occluder_cnt == occluder_floor) {
+        refr_obj(draw_ctx, obj);
+        return;
+    }
+
+    /*The area where the object and its children can draw*/
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    lv_area_t clip_area = *clip_area_ori;
+    if(!lv_obj_has_flag(obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE)) {
+        lv_area_t obj_coords_ext;
+        lv_obj_get_coords(obj, &obj_coords_ext);
+        lv_coord_t ext_draw_size = _lv_obj_get_ext_draw_size(obj);
+        lv_area_increase(&obj_coords_ext, ext_draw_size, ext_draw_size);
+        /*A zoomed or rotated object draws on its transformed area*/
+        if(_lv_obj_get_layer_type(obj) == LV_LAYER_TYPE_TRANSFORM) {
+            lv_obj_get_transformed_area(obj, &obj_coords_ext, false, false);
+        }
+        if(!_lv_area_intersect(&clip_area, clip_area_ori, &obj_coords_ext)) return;
+    }
+
+    if(!occluders_clip(&clip_area)) return;
+
+    draw_ctx->clip_area = &clip_area;
+    refr_obj(draw_ctx, obj);
+    draw_ctx->clip_area = clip_area_ori;
+}
+
+/**
+ * Save the opaque children of an object as occluders of the objects drawn before them
+ * @param obj pointer to an object
+ * @param first index of the first child to check
+ * @param clip_area pointer to the area where the children are drawn
+ */
+static void occluders_push_children(lv_obj_t * obj, uint32_t first, const lv_area_t * clip_area)
+{
+    int32_t child_cnt = (int32_t)lv_obj_get_child_cnt(obj);
+    if(child_cnt <= (int32_t)first) return;
+
+    /*The children are not fully drawn where the object masks them (e.g. `clip_corner`)*/
+    lv_cover_check_info_t info;
+    info.res = LV_COVER_RES_COVER;
+    info.area = clip_area;
+    lv_event_send(obj, LV_EVENT_COVER_CHECK, &info);
+    if(info.res == LV_COVER_RES_MASKED) return;
+
+    int32_t i;
+    for(i = child_cnt - 1; i >= (int32_t)first && occluder_cnt < OCCLUDER_MAX; i--) {
+        lv_obj_t * child = obj->spec_attr->children[i];
+        if(lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+        if(_lv_obj_get_layer_type(child) != LV_LAYER_TYPE_NONE) continue;
+
+        lv_area_t area;
+        if(!_lv_area_intersect(&area, &child->coords, clip_area)) continue;
+        if(lv_draw_mask_is_any(&area)) continue;
+        if(lv_obj_get_style_opa_recursive(child, LV_PART_MAIN) < LV_OPA_MAX) continue;
+
+        info.res = LV_COVER_RES_COVER;
+        info.area = &area;
+        lv_event_send(child, LV_EVENT_COVER_CHECK, &info);
+        if(info.res != LV_COVER_RES_COVER) continue;
+
+        occluders[occluder_cnt].area = area;
+        occluders[occluder_cnt].parent = obj;
+        occluders[occluder_cnt].index = i;
+        occluder_cnt++;
+    }
+}
+
+/**
+ * Save the opaque 'younger' siblings of an object and of its parents, the outermost first
+ * @param obj pointer to an object
+ * @param clip_area pointer to the area being drawn
+ */
+static void occluders_push_younger(lv_obj_t * obj, const lv_area_t * clip_area)
+{
+    lv_obj_t * parent = lv_obj_get_parent(obj);
+    if(parent == NULL) return;
+
+    occluders_push_younger(parent, clip_area);
+    occluders_push_children(parent, lv_obj_get_index(obj) + 1, clip_area);
+}
+
+/**
+ * Remove the occluders which are drawn before a child
+ * @param parent pointer to the parent of the child
+ * @param index index of the child
+ */
+static void occluders_pop(const lv_obj_t * parent, uint32_t index)
+{
+    while(occluder_cnt > occluder_floor && occluders[occluder_cnt - 1].parent == parent &&
+          occluders[occluder_cnt - 1].index <= index) {
+        occluder_cnt--;
+    }
+}
+
+/**
+ * Remove the parts of an area hidden by the occluders, if the rest is still a rectangle
+ * @param area pointer to the area to clip
+ * @return false: the occluders hide the whole area
+ */
+static bool occluders_clip(lv_area_t * area)
+{
+    uint32_t i;
+    for(i = occluder_floor; i < occluder_cnt; i++) {
+        const lv_area_t * occ = &occluders[i].area;
+        if(occ->x1 > area->x2 || occ->x2 < area->x1 || occ->y1 > area->y2 || occ->y2 < area->y1) continue;
+
+        bool cover_x = occ->x1 <= area->x1 && occ->x2 >= area->x2;
+        bool cover_y = occ->y1 <= area->y1 && occ->y2 >= area->y2;
+        if(cover_x && cover_y) return false;
+
+        /*A band over the full width or height can be cut from a side*/
+        if(cover_x) {
+            if(occ->y1 <= area->y1) area->y1 = occ->y2 + 1;
+            else if(occ->y2 >= area->y2) area->y2 = occ->y1 - 1;
+        }
+        else if(cover_y) {
+            if(occ->x1 <= area->x1) area->x1 = occ->x2 + 1;
+            else if(occ->x2 >= area->x2) area->x2 = occ->x1 - 1;
+        }
+    }
+
+    return true;
+}
+
 void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
 {
     /*Do not refresh hidden objects*/
@@ -1027,6 +1410,10 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
             if(layer_ctx->area_act.y2 > layer_ctx->area_full.y2) layer_ctx->area_act.y2 = layer_ctx->area_full.y2;
         }
 
+        /*The layer is blended as a whole, the occluders out of it don't clip its content*/
+        uint32_t occluder_floor_ori = occluder_floor;
+        occluder_floor = occluder_cnt;
+
         while(layer_ctx->area_act.y1 <= layer_area_full.y2) {
             if(flags & LV_DRAW_LAYER_FLAG_CAN_SUBDIVIDE) {
                 layer_alpha_test(obj, draw_ctx, layer_ctx, flags);
@@ -1046,6 +1433,7 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
             layer_ctx->area_act.y2 = layer_ctx->area_act.y1 + layer_ctx->max_row_with_no_alpha - 1;
         }
 
+        occluder_floor = occluder_floor_ori;
         lv_draw_layer_destroy(draw_ctx, layer_ctx);
     }
 }
@@ -1280,10 +1668,12 @@ static void draw_buf_flush(lv_disp_t * disp)
     /* In partial double buffered mode wait until the other buffer is freed
      * and driver is ready to receive the new buffer */
     bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
-    if(draw_buf->buf1 && draw_buf->buf2 && !full_sized) {
+    if(draw_buf->buf1 && draw_buf->buf2 && !full_sized && draw_buf->flushing) {
+        refr_phase(LV_DISP_REFR_PHASE_FLUSH_WAIT, false, NULL);
         while(draw_buf->flushing) {
             if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
         }
+        refr_phase(LV_DISP_REFR_PHASE_FLUSH_WAIT, true, NULL);
     }
 
     draw_buf->flushing = 1;
@@ -1294,6 +1684,7 @@ static void draw_buf_flush(lv_disp_t * disp)
     bool flushing_last = draw_buf->flushing_last;
 
     if(disp->driver->flush_cb) {
+        refr_phase(LV_DISP_REFR_PHASE_FLUSH, false, draw_ctx->buf_area);
         /*Rotate the buffer to the display's native orientation if necessary*/
         if(disp->driver->rotated != LV_DISP_ROT_NONE && disp->driver->sw_rotate) {
             draw_buf_rotate(draw_ctx->buf_area, draw_ctx->buf);
@@ -1301,6 +1692,7 @@ static void draw_buf_flush(lv_disp_t * disp)
         else {
             call_flush_cb(disp->driver, draw_ctx->buf_area, draw_ctx->buf);
         }
+        refr_phase(LV_DISP_REFR_PHASE_FLUSH, true, draw_ctx->buf_area);
     }
 
     /*If there are 2 buffers swap them. With direct mode swap only on the last area*/
@@ -1324,9 +1716,15 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
         .y2 = area->y2 + drv->offset_y
     };
 
+    flushed_px += lv_area_get_size(area);
     drv->flush_cb(drv, &offset_area, color_p);
 }
 
+static void refr_phase(lv_disp_refr_phase_t phase, bool end, const lv_area_t * area)
+{
+    if(disp_refr->driver->refr_phase_cb) disp_refr->driver->refr_phase_cb(disp_refr->driver, phase, end, area);
+}
+
 #if LV_USE_PERF_MONITOR
 static void perf_monitor_init(perf_monitor_t * _perf_monitor)
 {
@@ -1336,6 +1734,8 @@ static void perf_monitor_init(perf_monitor_t * _perf_monitor)
     _perf_monitor->fps_sum_cnt = 0;
     _perf_monitor->frame_cnt = 0;
     _perf_monitor->perf_last_time = 0;
+    _perf_monitor->drawn_px_start = 0;
+    _perf_monitor->flushed_px_start = 0;
     _perf_monitor->perf_label = NULL;
 }
 #endif
@@ -85,6 +85,25 @@ lv_disp_t * _lv_refr_get_disp_refreshing(void);
  */
 void _lv_refr_set_disp_refreshing(lv_disp_t * disp);
 
+/**
+ * Count pixels written by the renderer, to get the overdraw with `lv_refr_get_overdraw`
+ * @param px number of pixels
+ */
+void _lv_refr_add_drawn_px(uint32_t px);
+
+/**
+ * Get the pixels written by the renderer and the pixels flushed since the last
+ * `lv_refr_reset_overdraw_counter`. Each pixel flushed is written once or more (overdraw).
+ * @param drawn pointer to store the pixels written, can be NULL
+ * @param flushed pointer to store the pixels flushed, can be NULL
+ */
+void lv_refr_get_overdraw(uint32_t * drawn, uint32_t * flushed);
+
+/**
+ * Reset the overdraw counter
+ */
+void lv_refr_reset_overdraw_counter(void);
+
 #if LV_USE_PERF_MONITOR
 /**
  * Reset FPS counter
@@ -16,8 +16,15 @@
 /*********************
  *      DEFINES
  *********************/
-#define CIRCLE_CACHE_LIFE_MAX   1000
-#define CIRCLE_CACHE_AGING(life, r)   life = LV_MIN(life + (r < 16 ? 1 : (r >> 4)), 1000)
+#define CIRCLE_CACHE            LV_GC_ROOT(_lv_circle_cache)
+#define CIRCLE_BUCKET(r)        CIRCLE_CACHE.bucket[(r) & (_LV_CIRCLE_CACHE_BUCKET_CNT - 1)]
+
+/*Memory used by the circle of a radius. The buffer has `uint16_t` for opa_start_on_y and x_start_on_y.*/
+#define CIRCLE_BUF_SIZE(r)      ((uint32_t)(r) * 6 + 6)
+#define CIRCLE_ENTRY_SIZE(r)    (CIRCLE_BUF_SIZE(r) + sizeof(_lv_draw_mask_radius_circle_dsc_t))
+
+/*Shorter transparent or covering runs are blended as a part of a partial span*/
+#define SPAN_LEN_MIN    8
 
 /**********************
  *      TYPEDEFS
@@ -56,13 +63,20 @@ static void circ_init(lv_point_t * c, lv_coord_t * tmp, lv_coord_t radius);
 static bool circ_cont(lv_point_t * c);
 static void circ_next(lv_point_t * c, lv_coord_t * tmp);
 static void circ_calc_aa4(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t radius);
+static _lv_draw_mask_radius_circle_dsc_t * circle_cache_find(lv_coord_t radius);
+static void circle_cache_add(_lv_draw_mask_radius_circle_dsc_t * entry);
+static void circle_cache_free(lv_cache_list_node_t * node);
 static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t y, lv_coord_t * len,
                                 lv_coord_t * x_start);
 static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, lv_opa_t mask_new);
+static lv_coord_t /* LV_ATTRIBUTE_FAST_MEM */ span_run_end(const lv_opa_t * mask_buf, lv_coord_t x, lv_coord_t len,
+                                                           lv_opa_t v);
+static bool span_add(lv_draw_mask_spans_t * spans, lv_draw_mask_span_type_t type, lv_coord_t len);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static uint32_t circle_cache_max_size = LV_CIRCLE_CACHE_DEF_SIZE;
 
 /**********************
  *      MACROS
@@ -163,6 +177,71 @@ lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_apply_ids(lv_opa_t * mask_
     return changed ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
 }
 
+/**
+ * Apply the added buffers on a line like `lv_draw_mask_apply` and describe the result as spans too.
+ * @param mask_buf store the result mask here. Has to be `len` byte long. Should be initialized with `0xFF`.
+ * @param abs_x absolute X coordinate where the line to calculate start
+ * @param abs_y absolute Y coordinate where the line to calculate start
+ * @param len length of the line to calculate (in pixel count)
+ * @param spans store the spans of `mask_buf` here. `spans->cnt` is 0 if the line is transparent or too fragmented.
+ * @return the same as `lv_draw_mask_apply`
+ */
+lv_draw_mask_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_apply_spans(lv_opa_t * mask_buf, lv_coord_t abs_x,
+                                                                  lv_coord_t abs_y, lv_coord_t len,
+                                                                  lv_draw_mask_spans_t * spans)
+{
+    lv_draw_mask_res_t res = lv_draw_mask_apply(mask_buf, abs_x, abs_y, len);
+
+    /*Not only for `CHANGED`: the caller might have initialized the buffer with an opacity*/
+    if(res == LV_DRAW_MASK_RES_TRANSP) spans->cnt = 0;
+    else lv_draw_mask_get_spans(mask_buf, len, spans);
+
+    return res;
+}
+
+/**
+ * Split a mask line to runs of transparent, fully covering and other pixels.
+ * Short transparent and covering runs are merged into the partial spans around them.
+ * @param mask_buf the mask line
+ * @param len length of the line (in pixel count)
+ * @param spans store the spans here
+ * @return the number of spans, also stored in `spans->cnt`.
+ *         0 if the line needs more than `LV_DRAW_MASK_SPAN_MAX` spans.
+ */
+uint8_t LV_ATTRIBUTE_FAST_MEM lv_draw_mask_get_spans(const lv_opa_t * mask_buf, lv_coord_t len,
+                                                     lv_draw_mask_spans_t * spans)
+{
+    spans->cnt = 0;
+
+    lv_coord_t partial_len = 0;     /*Length of the partial span before `x` which is not added yet*/
+    lv_coord_t x = 0;
+    while(x < len) {
+        lv_opa_t v = mask_buf[x];
+        if(v == LV_OPA_TRANSP || v == LV_OPA_COVER) {
+            lv_coord_t x_end = span_run_end(mask_buf, x, len, v);
+            if(x_end - x >= SPAN_LEN_MIN) {
+                if(partial_len && !span_add(spans, LV_DRAW_MASK_SPAN_PARTIAL, partial_len)) return 0;
+                partial_len = 0;
+                lv_draw_mask_span_type_t type = v == LV_OPA_COVER ? LV_DRAW_MASK_SPAN_COVER : LV_DRAW_MASK_SPAN_TRANSP;
+                if(!span_add(spans, type, x_end - x)) return 0;
+            }
+            else {
+                partial_len += x_end - x;
+            }
+            x = x_end;
+        }
+        else {
+            lv_coord_t x_start = x;
+            for(x++; x < len && mask_buf[x] != LV_OPA_TRANSP && mask_buf[x] != LV_OPA_COVER; x++);
+            partial_len += x - x_start;
+        }
+    }
+
+    if(partial_len && !span_add(spans, LV_DRAW_MASK_SPAN_PARTIAL, partial_len)) return 0;
+
+    return spans->cnt;
+}
+
 /**
  * Remove a mask with a given ID
  * @param id the ID of the mask.  Returned by `lv_draw_mask_add`
@@ -214,12 +293,11 @@ void lv_draw_mask_free_param(void * p)
     if(pdsc->type == LV_DRAW_MASK_TYPE_RADIUS) {
         lv_draw_mask_radius_param_t * radius_p = (lv_draw_mask_radius_param_t *) p;
         if(radius_p->circle) {
-            if(radius_p->circle->life < 0) {
-                lv_mem_free(radius_p->circle->cir_opa);
+            if(radius_p->circle->not_cached) {
                 lv_mem_free(radius_p->circle);
             }
             else {
-                radius_p->circle->used_cnt--;
+                radius_p->circle->node.used_cnt--;
             }
         }
     }
@@ -231,13 +309,18 @@ void lv_draw_mask_free_param(void * p)
 
 void _lv_draw_mask_cleanup(void)
 {
-    uint8_t i;
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).buf) {
-            lv_mem_free(LV_GC_ROOT(_lv_circle_cache[i]).buf);
-        }
-        lv_memset_00(&LV_GC_ROOT(_lv_circle_cache[i]), sizeof(LV_GC_ROOT(_lv_circle_cache[i])));
-    }
+    _lv_cache_list_clear(&CIRCLE_CACHE.lru);
+}
+
+void lv_draw_mask_set_circle_cache_size(uint32_t max_bytes)
+{
+    circle_cache_max_size = max_bytes;
+    _lv_cache_list_make_room(&CIRCLE_CACHE.lru, circle_cache_max_size, 0);
+}
+
+void lv_draw_mask_get_circle_cache_stats(lv_cache_list_stats_t * stats)
+{
+    *stats = CIRCLE_CACHE.lru.stats;
 }
 
 /**
@@ -491,42 +574,34 @@ void lv_draw_mask_radius_init(lv_draw_mask_radius_param_t * param, const lv_area
         return;
     }
 
-    uint32_t i;
-
-    /*Try to reuse a circle cache entry*/
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).radius == radius) {
-            LV_GC_ROOT(_lv_circle_cache[i]).used_cnt++;
-            CIRCLE_CACHE_AGING(LV_GC_ROOT(_lv_circle_cache[i]).life, radius);
-            param->circle = &LV_GC_ROOT(_lv_circle_cache[i]);
-            return;
-        }
+    /*The circle depends only on the radius, `inv` and the anti-aliasing are applied when the mask is used*/
+    _lv_draw_mask_radius_circle_dsc_t * entry = circle_cache_find(radius);
+    if(entry) {
+        _lv_cache_list_hit(&CIRCLE_CACHE.lru, &entry->node);
+        entry->node.used_cnt++;
+        param->circle = entry;
+        return;
     }
 
-    /*If not found find a free entry with lowest life*/
-    _lv_draw_mask_radius_circle_dsc_t * entry = NULL;
-    for(i = 0; i < LV_CIRCLE_CACHE_SIZE; i++) {
-        if(LV_GC_ROOT(_lv_circle_cache[i]).used_cnt == 0) {
-            if(!entry) entry = &LV_GC_ROOT(_lv_circle_cache[i]);
-            else if(LV_GC_ROOT(_lv_circle_cache[i]).life < entry->life) entry = &LV_GC_ROOT(_lv_circle_cache[i]);
-        }
-    }
+    CIRCLE_CACHE.lru.stats.misses++;
+    /*The buffer of the circle follows the descriptor*/
+    entry = lv_mem_alloc(CIRCLE_ENTRY_SIZE(radius));
+    LV_ASSERT_MALLOC(entry);
+    lv_memset_00(entry, sizeof(_lv_draw_mask_radius_circle_dsc_t));
+    entry->buf = (uint8_t *)(entry + 1);
+    entry->node.used_cnt = 1;
 
-    if(!entry) {
-        entry = lv_mem_alloc(sizeof(_lv_draw_mask_radius_circle_dsc_t));
-        LV_ASSERT_MALLOC(entry);
-        lv_memset_00(entry, sizeof(_lv_draw_mask_radius_circle_dsc_t));
-        entry->life = -1;
+    circ_calc_aa4(entry, radius);
+
+    /*If only used circles could be freed keep this one for this mask only*/
+    if(_lv_cache_list_make_room(&CIRCLE_CACHE.lru, circle_cache_max_size, CIRCLE_ENTRY_SIZE(radius))) {
+        circle_cache_add(entry);
     }
     else {
-        entry->used_cnt++;
-        entry->life = 0;
-        CIRCLE_CACHE_AGING(entry->life, radius);
+        entry->not_cached = 1;
     }
 
     param->circle = entry;
-
-    circ_calc_aa4(param->circle, radius);
 }
 
 /**
@@ -1367,11 +1442,7 @@ static void circ_calc_aa4(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t radi
     if(radius == 0) return;
     c->radius = radius;
 
-    /*Allocate buffers*/
-    if(c->buf) lv_mem_free(c->buf);
-
-    c->buf = lv_mem_alloc(radius * 6 + 6);  /*Use uint16_t for opa_start_on_y and x_start_on_y*/
-    LV_ASSERT_MALLOC(c->buf);
+    /*`c->buf` has CIRCLE_BUF_SIZE(radius) bytes*/
     c->cir_opa = c->buf;
     c->opa_start_on_y = (uint16_t *)(c->buf + 2 * radius + 2);
     c->x_start_on_y = (uint16_t *)(c->buf + 4 * radius + 4);
@@ -1510,6 +1581,33 @@ static void circ_calc_aa4(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t radi
     lv_mem_buf_release(cir_x);
 }
 
+static _lv_draw_mask_radius_circle_dsc_t * circle_cache_find(lv_coord_t radius)
+{
+    _lv_draw_mask_radius_circle_dsc_t * entry = CIRCLE_BUCKET(radius);
+    while(entry) {
+        if(entry->radius == radius) return entry;
+        entry = entry->hash_next;
+    }
+    return NULL;
+}
+
+static void circle_cache_add(_lv_draw_mask_radius_circle_dsc_t * entry)
+{
+    _lv_draw_mask_radius_circle_dsc_t ** bucket = &CIRCLE_BUCKET(entry->radius);
+    entry->hash_next = *bucket;
+    *bucket = entry;
+    _lv_cache_list_add(&CIRCLE_CACHE.lru, &entry->node, CIRCLE_ENTRY_SIZE(entry->radius), circle_cache_free);
+}
+
+static void circle_cache_free(lv_cache_list_node_t * node)
+{
+    _lv_draw_mask_radius_circle_dsc_t * entry = (_lv_draw_mask_radius_circle_dsc_t *)node;
+    _lv_draw_mask_radius_circle_dsc_t ** link = &CIRCLE_BUCKET(entry->radius);
+    while(*link != entry) link = &(*link)->hash_next;
+    *link = entry->hash_next;
+    lv_mem_free(entry);
+}
+
 static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_t y, lv_coord_t * len,
                                 lv_coord_t * x_start)
 {
@@ -1519,6 +1617,45 @@ static lv_opa_t * get_next_line(_lv_draw_mask_radius_circle_dsc_t * c, lv_coord_
 }
 
 
+/**
+ * Find the end of a run of `v` values
+ * @param mask_buf the mask line
+ * @param x the first pixel of the run
+ * @param len length of the line
+ * @param v `LV_OPA_TRANSP` or `LV_OPA_COVER`
+ * @return the index of the first pixel after the run
+ */
+static lv_coord_t LV_ATTRIBUTE_FAST_MEM span_run_end(const lv_opa_t * mask_buf, lv_coord_t x, lv_coord_t len,
+                                                     lv_opa_t v)
+{
+    for(; x < len && ((lv_uintptr_t)&mask_buf[x] & 0x3); x++) {
+        if(mask_buf[x] != v) return x;
+    }
+
+    /*Compare 4 pixels at once*/
+    uint32_t v32 = v == LV_OPA_COVER ? 0xFFFFFFFF : 0;
+    for(; x <= len - 4; x += 4) {
+        if(*((const uint32_t *)&mask_buf[x]) != v32) break;
+    }
+
+    for(; x < len && mask_buf[x] == v; x++);
+
+    return x;
+}
+
+static bool span_add(lv_draw_mask_spans_t * spans, lv_draw_mask_span_type_t type, lv_coord_t len)
+{
+    if(spans->cnt >= LV_DRAW_MASK_SPAN_MAX) {
+        spans->cnt = 0;
+        return false;
+    }
+
+    spans->span[spans->cnt].type = type;
+    spans->span[spans->cnt].len = len;
+    spans->cnt++;
+    return true;
+}
+
 static inline lv_opa_t LV_ATTRIBUTE_FAST_MEM mask_mix(lv_opa_t mask_act, lv_opa_t mask_new)
 {
     if(mask_new >= LV_OPA_MAX) return mask_act;
@@ -18,6 +18,7 @@ extern "C" {
 #include "../misc/lv_area.h"
 #include "../misc/lv_color.h"
 #include "../misc/lv_math.h"
+#include "../misc/lv_cache_list.h"
 
 /*********************
  *      DEFINES
@@ -29,6 +30,9 @@ extern "C" {
 # define _LV_MASK_MAX_NUM     1
 #endif
 
+/*Spans of a mask line, a more fragmented line is not encoded*/
+#define LV_DRAW_MASK_SPAN_MAX   16
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -42,6 +46,27 @@ enum {
 
 typedef uint8_t lv_draw_mask_res_t;
 
+enum {
+    LV_DRAW_MASK_SPAN_TRANSP,   /**< Every pixel of the span is `LV_OPA_TRANSP`*/
+    LV_DRAW_MASK_SPAN_COVER,    /**< Every pixel of the span is `LV_OPA_COVER`*/
+    LV_DRAW_MASK_SPAN_PARTIAL,  /**< Anything else, the mask buffer has to be read pixel by pixel*/
+};
+
+typedef uint8_t lv_draw_mask_span_type_t;
+
+typedef struct {
+    lv_coord_t len;
+    lv_draw_mask_span_type_t type;
+} lv_draw_mask_span_t;
+
+/**
+ * Run-length description of a mask line. The spans follow each other from the start of the line.
+ */
+typedef struct {
+    lv_draw_mask_span_t span[LV_DRAW_MASK_SPAN_MAX];
+    uint8_t cnt;                /**< 0 if the line was not encoded*/
+} lv_draw_mask_spans_t;
+
 typedef struct {
     void * param;
     void * custom_id;
@@ -153,17 +178,24 @@ typedef struct {
     uint16_t delta_deg;
 } lv_draw_mask_angle_param_t;
 
-typedef struct  {
-    uint8_t * buf;
+typedef struct _lv_draw_mask_radius_circle_dsc_t {
+    lv_cache_list_node_t node;  /*The entry in the cache, `used_cnt` counts the referencing masks*/
+    uint8_t * buf;              /*The tables below, allocated together with the descriptor*/
     lv_opa_t * cir_opa;         /*Opacity of values on the circumference of an 1/4 circle*/
     uint16_t * x_start_on_y;        /*The x coordinate of the circle for each y value*/
     uint16_t * opa_start_on_y;      /*The index of `cir_opa` for each y value*/
-    int32_t life;               /*How many times the entry way used*/
-    uint32_t used_cnt;          /*Like a semaphore to count the referencing masks*/
+    struct _lv_draw_mask_radius_circle_dsc_t * hash_next;   /*Next entry in the same bucket of the cache*/
     lv_coord_t radius;          /*The radius of the entry*/
+    uint8_t not_cached : 1;     /*The cache was full with used entries, free it with the mask*/
 } _lv_draw_mask_radius_circle_dsc_t;
 
-typedef _lv_draw_mask_radius_circle_dsc_t _lv_draw_mask_radius_circle_dsc_arr_t[LV_CIRCLE_CACHE_SIZE];
+/*Number of hash buckets of the circle cache, a power of 2*/
+#define _LV_CIRCLE_CACHE_BUCKET_CNT 16
+
+typedef struct {
+    _lv_draw_mask_radius_circle_dsc_t * bucket[_LV_CIRCLE_CACHE_BUCKET_CNT];
+    lv_cache_list_t lru;
+} _lv_draw_mask_circle_cache_t;
 
 typedef struct {
     /*The first element must be the common descriptor*/
@@ -261,6 +293,31 @@ lv_draw_mask_res_t /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_mask_apply_ids(lv_opa_t *
                                                                       lv_coord_t abs_y, lv_coord_t len,
                                                                       const int16_t * ids, int16_t ids_count);
 
+/**
+ * Apply the added buffers on a line like `lv_draw_mask_apply` and describe the result as spans too.
+ * @param mask_buf store the result mask here. Has to be `len` byte long. Should be initialized with `0xFF`.
+ * @param abs_x absolute X coordinate where the line to calculate start
+ * @param abs_y absolute Y coordinate where the line to calculate start
+ * @param len length of the line to calculate (in pixel count)
+ * @param spans store the spans of `mask_buf` here. `spans->cnt` is 0 if the line is transparent or too fragmented.
+ * @return the same as `lv_draw_mask_apply`
+ */
+lv_draw_mask_res_t /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_mask_apply_spans(lv_opa_t * mask_buf, lv_coord_t abs_x,
+                                                                        lv_coord_t abs_y, lv_coord_t len,
+                                                                        lv_draw_mask_spans_t * spans);
+
+/**
+ * Split a mask line to runs of transparent, fully covering and other pixels.
+ * Short transparent and covering runs are merged into the partial spans around them.
+ * @param mask_buf the mask line
+ * @param len length of the line (in pixel count)
+ * @param spans store the spans here
+ * @return the number of spans, also stored in `spans->cnt`.
+ *         0 if the line needs more than `LV_DRAW_MASK_SPAN_MAX` spans.
+ */
+uint8_t /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_mask_get_spans(const lv_opa_t * mask_buf, lv_coord_t len,
+                                                           lv_draw_mask_spans_t * spans);
+
 //! @endcond
 
 /**
@@ -289,11 +346,25 @@ void * lv_draw_mask_remove_custom(void * custom_id);
 void lv_draw_mask_free_param(void * p);
 
 /**
- * Called by LVGL the rendering of a screen is ready to clean up
- * the temporal (cache) data of the masks
+ * Free the cached circles of the radius masks. Called by `lv_deinit`.
+ * The circles are kept between the refreshes, so this is needed only to release the memory.
  */
 void _lv_draw_mask_cleanup(void);
 
+/**
+ * Set the size of the circle cache of the radius masks.
+ * The least recently used circles are freed if the cache is larger than the new size.
+ * @param max_bytes max. bytes of the cached circles. 0: calculate the circles for every mask
+ */
+void lv_draw_mask_set_circle_cache_size(uint32_t max_bytes);
+
+/**
+ * Get the statistics of the circle cache of the radius masks.
+ * A hit is a radius mask which found its circle in the cache, a miss one which calculated it.
+ * @param stats store the statistics here
+ */
+void lv_draw_mask_get_circle_cache_stats(lv_cache_list_stats_t * stats);
+
 //! @cond Doxygen_Suppress
 
 /**
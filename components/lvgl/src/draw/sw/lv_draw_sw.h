@@ -17,6 +17,7 @@ extern "C" {
 #include "../lv_draw.h"
 #include "../../misc/lv_area.h"
 #include "../../misc/lv_color.h"
+#include "../../misc/lv_cache_list.h"
 #include "../../hal/lv_hal_disp.h"
 
 /*********************
@@ -91,6 +92,27 @@ void lv_draw_sw_layer_blend(struct _lv_draw_ctx_t * draw_ctx, struct _lv_draw_la
 
 void lv_draw_sw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx);
 
+#if LV_DRAW_COMPLEX
+/**
+ * Set the size of the cache of the blurred shadow corners.
+ * The least recently used corners are freed if the cache is larger than the new size.
+ * @param max_bytes max. bytes of the cached corners. 0: blur the corner for every shadow
+ */
+void lv_draw_sw_shadow_set_cache_size(uint32_t max_bytes);
+
+/**
+ * Free the cached shadow corners. Called by `lv_deinit`.
+ */
+void lv_draw_sw_shadow_free_cache(void);
+
+/**
+ * Get the statistics of the cache of the blurred shadow corners.
+ * A hit is a shadow which found its corner in the cache, a miss one which blurred it.
+ * @param stats store the statistics here
+ */
+void lv_draw_sw_shadow_get_cache_stats(lv_cache_list_stats_t * stats);
+#endif
+
 /***********************
  * GLOBAL VARIABLES
  ***********************/
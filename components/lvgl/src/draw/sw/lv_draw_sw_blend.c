@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_sw.h"
+#include "lv_draw_sw_blend_simd.h"
 #include "../../misc/lv_math.h"
 #include "../../hal/lv_hal_disp.h"
 #include "../../core/lv_refr.h"
@@ -23,6 +24,17 @@
  *  STATIC PROTOTYPES
  **********************/
 
+static void blend_basic(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc, bool simd);
+
+static void blend_normal(lv_color_t * dest_buf, const lv_area_t * dest_area, lv_coord_t dest_stride,
+                         lv_color_t color, const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
+                         const lv_opa_t * mask, lv_coord_t mask_stride, bool simd);
+
+static void blend_normal_spans(lv_color_t * dest_buf, const lv_area_t * dest_area, lv_coord_t dest_stride,
+                               lv_color_t color, const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
+                               const lv_opa_t * mask, const lv_draw_mask_spans_t * spans, lv_coord_t span_ofs,
+                               bool simd);
+
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide);
 
@@ -102,6 +114,8 @@ void lv_draw_sw_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * d
     lv_area_t blend_area;
     if(!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) return;
 
+    _lv_refr_add_drawn_px(lv_area_get_size(&blend_area));
+
     if(draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
 
     ((lv_draw_sw_ctx_t *)draw_ctx)->blend(draw_ctx, dsc);
@@ -109,6 +123,20 @@ void lv_draw_sw_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * d
 
 void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
                                                   const lv_draw_sw_blend_dsc_t * dsc)
+{
+    blend_basic(draw_ctx, dsc, true);
+}
+
+void lv_draw_sw_blend_basic_c(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc)
+{
+    blend_basic(draw_ctx, dsc, false);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void LV_ATTRIBUTE_FAST_MEM blend_basic(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc, bool simd)
 {
     lv_opa_t * mask;
     if(dsc->mask_buf == NULL) mask = NULL;
@@ -165,6 +193,14 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
         mask_stride = 0;
     }
 
+    /*The spans start at the beginning of the mask line, the blended area might be clipped*/
+    const lv_draw_mask_spans_t * spans = NULL;
+    lv_coord_t span_ofs = 0;
+    if(mask && dsc->mask_spans && dsc->mask_spans->cnt && dsc->mask_area->y1 == dsc->mask_area->y2) {
+        spans = dsc->mask_spans;
+        span_ofs = blend_area.x1 - dsc->mask_area->x1;
+    }
+
     lv_area_move(&blend_area, -draw_ctx->buf_area->x1, -draw_ctx->buf_area->y1);
 
 
@@ -187,11 +223,13 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 #endif
     else if(dsc->blend_mode == LV_BLEND_MODE_NORMAL) {
-        if(dsc->src_buf == NULL) {
-            fill_normal(dest_buf, &blend_area, dest_stride, dsc->color, dsc->opa, mask, mask_stride);
+        if(spans) {
+            blend_normal_spans(dest_buf, &blend_area, dest_stride, dsc->color, src_buf, src_stride, dsc->opa, mask,
+                               spans, span_ofs, simd);
         }
         else {
-            map_normal(dest_buf, &blend_area, dest_stride, src_buf, src_stride, dsc->opa, mask, mask_stride);
+            blend_normal(dest_buf, &blend_area, dest_stride, dsc->color, src_buf, src_stride, dsc->opa, mask,
+                         mask_stride, simd);
         }
     }
     else {
@@ -206,10 +244,67 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx,
     }
 }
 
+static void LV_ATTRIBUTE_FAST_MEM blend_normal(lv_color_t * dest_buf, const lv_area_t * dest_area,
+                                               lv_coord_t dest_stride, lv_color_t color, const lv_color_t * src_buf,
+                                               lv_coord_t src_stride, lv_opa_t opa, const lv_opa_t * mask,
+                                               lv_coord_t mask_stride, bool simd)
+{
+#if LV_DRAW_SW_SIMD == 0
+    LV_UNUSED(simd);
+#endif
+
+    if(src_buf == NULL) {
+#if LV_DRAW_SW_SIMD
+        if(simd && lv_draw_sw_blend_simd_fill(dest_buf, dest_area, dest_stride, color, opa, mask,
+                                              mask_stride) == LV_RES_OK) return;
+#endif
+        fill_normal(dest_buf, dest_area, dest_stride, color, opa, mask, mask_stride);
+    }
+    else {
+#if LV_DRAW_SW_SIMD
+        if(simd && lv_draw_sw_blend_simd_map(dest_buf, dest_area, dest_stride, src_buf, src_stride, opa, mask,
+                                             mask_stride) == LV_RES_OK) return;
+#endif
+        map_normal(dest_buf, dest_area, dest_stride, src_buf, src_stride, opa, mask, mask_stride);
+    }
+}
+
+/**
+ * Blend a line span by span: skip the transparent spans, fill or copy the covering ones
+ * and blend only the partial spans with the mask.
+ * @param span_ofs      the first pixel of `dest_area` in the spans
+ */
+static void LV_ATTRIBUTE_FAST_MEM blend_normal_spans(lv_color_t * dest_buf, const lv_area_t * dest_area,
+                                                     lv_coord_t dest_stride, lv_color_t color,
+                                                     const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
+                                                     const lv_opa_t * mask, const lv_draw_mask_spans_t * spans,
+                                                     lv_coord_t span_ofs, bool simd)
+{
+    lv_coord_t w = lv_area_get_width(dest_area);
+    lv_area_t span_area = *dest_area;
+
+    /*Start of the span relative to `dest_area`*/
+    lv_coord_t x = -span_ofs;
+    uint32_t i;
+    for(i = 0; i < spans->cnt && x < w; i++) {
+        lv_coord_t x1 = LV_MAX(x, 0);
+        x += spans->span[i].len;
+        lv_coord_t x2 = LV_MIN(x, w) - 1;
+        if(x1 > x2 || spans->span[i].type == LV_DRAW_MASK_SPAN_TRANSP) continue;
+
+        /*Without the mask the result is the same, except filling with opacity and copying with `LV_OPA_MAX`
+         *which calculate the colors in a different way without a mask*/
+        const lv_opa_t * span_mask = mask + x1;
+        if(spans->span[i].type == LV_DRAW_MASK_SPAN_COVER) {
+            if(src_buf ? opa != LV_OPA_MAX : opa >= LV_OPA_MAX) span_mask = NULL;
+        }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+        span_area.x1 = dest_area->x1 + x1;
+        span_area.x2 = dest_area->x1 + x2;
+        blend_normal(dest_buf + x1, &span_area, dest_stride, color, src_buf ? src_buf + x1 : NULL, src_stride, opa,
+                     span_mask, 0, simd);
+    }
+}
 
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide)
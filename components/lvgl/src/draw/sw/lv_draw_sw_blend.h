@@ -34,6 +34,7 @@ typedef struct {
     lv_opa_t * mask_buf;            /**< NULL if ignored, or an alpha mask to apply on `blend_area`*/
     lv_draw_mask_res_t mask_res;    /**< The result of the previous mask operation */
     const lv_area_t * mask_area;    /**< The area of `mask_buf` with absolute coordinates*/
+    const lv_draw_mask_spans_t * mask_spans; /**< NULL or the spans of `mask_buf` if `mask_area` is one line high*/
     lv_opa_t opa;                   /**< The overall opacity*/
     lv_blend_mode_t blend_mode;     /**< E.g. LV_BLEND_MODE_ADDITIVE*/
 } lv_draw_sw_blend_dsc_t;
@@ -59,6 +60,14 @@ void lv_draw_sw_blend(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_d
 void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_sw_blend_basic(struct _lv_draw_ctx_t * draw_ctx,
                                                         const lv_draw_sw_blend_dsc_t * dsc);
 
+/**
+ * Same as `lv_draw_sw_blend_basic` but only with the C code, without the SIMD instructions
+ * enabled by `LV_USE_DRAW_SW_SIMD`. It is the reference of the SIMD code.
+ * @param draw_ctx      pointer to a draw context
+ * @param dsc           pointer to an initialized blend descriptor
+ */
+void lv_draw_sw_blend_basic_c(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc);
+
 /**********************
  *      MACROS
  **********************/
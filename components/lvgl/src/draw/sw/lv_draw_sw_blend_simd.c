@@ -0,0 +1,295 @@
+/**
+ * @file lv_draw_sw_blend_simd.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_blend_simd.h"
+
+#if LV_DRAW_SW_SIMD
+
+#include "../../misc/lv_math.h"
+#include <string.h>
+
+#if LV_DRAW_SW_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*8 pixels, or 8 values of one channel or opacity*/
+#if LV_DRAW_SW_SIMD_SSE2
+typedef __m128i simd_u16_t;
+#endif
+
+/*The fill color of `fill_normal` with opacity, see `lv_color_mix_premult`*/
+typedef struct {
+    simd_u16_t r;
+    simd_u16_t g;
+    simd_u16_t b;
+    simd_u16_t opa_inv;
+} premult_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_res_t blend_masked(lv_color_t * dest_buf, int32_t w, int32_t h, lv_coord_t dest_stride,
+                             const lv_color_t * src_buf, lv_coord_t src_stride, lv_color_t color, lv_opa_t opa,
+                             const lv_opa_t * mask, lv_coord_t mask_stride, bool mask_only, lv_opa_t mask_full);
+static inline simd_u16_t splat(uint16_t v);
+static inline simd_u16_t load_px(const lv_color_t * buf);
+static inline void store_px(lv_color_t * buf, simd_u16_t px);
+static inline simd_u16_t load_mask(const lv_opa_t * mask);
+static inline simd_u16_t mask_opa(simd_u16_t mask, simd_u16_t opa, simd_u16_t mask_full);
+static inline simd_u16_t mix_ratio(simd_u16_t opa);
+static inline simd_u16_t mix(simd_u16_t fg, simd_u16_t bg, simd_u16_t ratio);
+static inline simd_u16_t mix_premult(const premult_t * fg, simd_u16_t bg);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_simd_fill(lv_color_t * dest_buf, const lv_area_t * dest_area,
+                                                          lv_coord_t dest_stride, lv_color_t color, lv_opa_t opa,
+                                                          const lv_opa_t * mask, lv_coord_t mask_stride)
+{
+    int32_t w = lv_area_get_width(dest_area);
+    int32_t h = lv_area_get_height(dest_area);
+    if(w < LV_DRAW_SW_SIMD_PX) return LV_RES_INV;
+
+    if(mask) {
+        return blend_masked(dest_buf, w, h, dest_stride, NULL, 0, color, opa, mask, mask_stride,
+                            opa >= LV_OPA_MAX, LV_OPA_COVER);
+    }
+
+    /*`lv_color_fill` already writes as fast as the memory*/
+    if(opa >= LV_OPA_MAX) return LV_RES_INV;
+
+    /*Rounded like in `fill_normal`, where 252 wraps around to 0. Leave that to the C code.*/
+    uint32_t opa_round = (((uint32_t)opa + 4) >> 3) << 3;
+    if(opa_round > LV_OPA_COVER) return LV_RES_INV;
+
+    /*`fill_normal` mixes the black pixels before the first other color with `lv_color_mix`*/
+    lv_color_t black_res = lv_color_mix(color, lv_color_black(), opa);
+    bool leading_black = true;
+
+    opa = opa_round;
+    uint16_t color_premult[3];
+    lv_color_premult(color, opa, color_premult);
+    lv_opa_t opa_inv = 255 - opa;
+
+    premult_t fg;
+    fg.r = splat(color_premult[0]);
+    fg.g = splat(color_premult[1]);
+    fg.b = splat(color_premult[2]);
+    fg.opa_inv = splat(opa_inv);
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        x = 0;
+        if(leading_black) {
+            while(x < w && dest_buf[x].full == 0) {
+                dest_buf[x] = black_res;
+                x++;
+            }
+            if(x < w) leading_black = false;
+        }
+
+        for(; x <= w - LV_DRAW_SW_SIMD_PX; x += LV_DRAW_SW_SIMD_PX) {
+            store_px(&dest_buf[x], mix_premult(&fg, load_px(&dest_buf[x])));
+        }
+        for(; x < w; x++) {
+            dest_buf[x] = lv_color_mix_premult(color_premult, dest_buf[x], opa_inv);
+        }
+        dest_buf += dest_stride;
+    }
+
+    return LV_RES_OK;
+}
+
+lv_res_t LV_ATTRIBUTE_FAST_MEM lv_draw_sw_blend_simd_map(lv_color_t * dest_buf, const lv_area_t * dest_area,
+                                                         lv_coord_t dest_stride, const lv_color_t * src_buf,
+                                                         lv_coord_t src_stride, lv_opa_t opa,
+                                                         const lv_opa_t * mask, lv_coord_t mask_stride)
+{
+    int32_t w = lv_area_get_width(dest_area);
+    int32_t h = lv_area_get_height(dest_area);
+    if(w < LV_DRAW_SW_SIMD_PX) return LV_RES_INV;
+
+    if(mask) {
+        return blend_masked(dest_buf, w, h, dest_stride, src_buf, src_stride, lv_color_black(), opa, mask,
+                            mask_stride, opa > LV_OPA_MAX, LV_OPA_MAX);
+    }
+
+    /*Copied with `lv_memcpy`*/
+    if(opa >= LV_OPA_MAX) return LV_RES_INV;
+
+    simd_u16_t ratio = mix_ratio(splat(opa));
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x <= w - LV_DRAW_SW_SIMD_PX; x += LV_DRAW_SW_SIMD_PX) {
+            store_px(&dest_buf[x], mix(load_px(&src_buf[x]), load_px(&dest_buf[x]), ratio));
+        }
+        for(; x < w; x++) {
+            dest_buf[x] = lv_color_mix(src_buf[x], dest_buf[x], opa);
+        }
+        dest_buf += dest_stride;
+        src_buf += src_stride;
+    }
+
+    return LV_RES_OK;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Blend a color or an image through a mask.
+ * @param src_buf       the image to blend, or NULL to fill with `color`
+ * @param mask_only     true: the opacity is the mask's; false: the mask scales `opa`
+ * @param mask_full     with `mask_only == false`, from this mask value on the opacity is `opa`
+ */
+static lv_res_t LV_ATTRIBUTE_FAST_MEM blend_masked(lv_color_t * dest_buf, int32_t w, int32_t h,
+                                                   lv_coord_t dest_stride, const lv_color_t * src_buf,
+                                                   lv_coord_t src_stride, lv_color_t color, lv_opa_t opa,
+                                                   const lv_opa_t * mask, lv_coord_t mask_stride, bool mask_only,
+                                                   lv_opa_t mask_full)
+{
+    simd_u16_t fg = splat(color.full);
+    simd_u16_t opa_v = splat(opa);
+    simd_u16_t mask_full_v = splat(mask_full);
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x <= w - LV_DRAW_SW_SIMD_PX; x += LV_DRAW_SW_SIMD_PX) {
+            uint64_t mask64;
+            memcpy(&mask64, &mask[x], sizeof(mask64));
+            if(mask64 == 0) continue;
+
+            if(src_buf) fg = load_px(&src_buf[x]);
+            if(mask_only && mask64 == UINT64_MAX) {
+                store_px(&dest_buf[x], fg);
+                continue;
+            }
+
+            simd_u16_t px_opa = load_mask(&mask[x]);
+            if(!mask_only) px_opa = mask_opa(px_opa, opa_v, mask_full_v);
+            store_px(&dest_buf[x], mix(fg, load_px(&dest_buf[x]), mix_ratio(px_opa)));
+        }
+
+        for(; x < w; x++) {
+            if(mask[x] == LV_OPA_TRANSP) continue;
+
+            lv_opa_t px_opa = mask[x];
+            if(!mask_only) px_opa = px_opa >= mask_full ? opa : (uint32_t)((uint32_t)px_opa * opa) >> 8;
+            dest_buf[x] = lv_color_mix(src_buf ? src_buf[x] : color, dest_buf[x], px_opa);
+        }
+
+        dest_buf += dest_stride;
+        if(src_buf) src_buf += src_stride;
+        mask += mask_stride;
+    }
+
+    return LV_RES_OK;
+}
+
+#if LV_DRAW_SW_SIMD_SSE2
+
+static inline simd_u16_t splat(uint16_t v)
+{
+    return _mm_set1_epi16((short)v);
+}
+
+static inline simd_u16_t load_px(const lv_color_t * buf)
+{
+    return _mm_loadu_si128((const __m128i *)buf);
+}
+
+static inline void store_px(lv_color_t * buf, simd_u16_t px)
+{
+    _mm_storeu_si128((__m128i *)buf, px);
+}
+
+static inline simd_u16_t load_mask(const lv_opa_t * mask)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)mask), _mm_setzero_si128());
+}
+
+/*`mask >= mask_full ? opa : mask * opa >> 8`*/
+static inline simd_u16_t mask_opa(simd_u16_t mask, simd_u16_t opa, simd_u16_t mask_full)
+{
+    simd_u16_t scaled = _mm_srli_epi16(_mm_mullo_epi16(mask, opa), 8);
+    simd_u16_t full = _mm_cmpeq_epi16(_mm_max_epi16(mask, mask_full), mask);
+    return _mm_or_si128(_mm_and_si128(full, opa), _mm_andnot_si128(full, scaled));
+}
+
+/*The 0..32 ratio of `lv_color_mix` with 16 bit colors*/
+static inline simd_u16_t mix_ratio(simd_u16_t opa)
+{
+    return _mm_srli_epi16(_mm_add_epi16(opa, _mm_set1_epi16(4)), 3);
+}
+
+/*Per channel `bg + (fg - bg) * ratio / 32`, rounded down. This is what the 32 bit trick of
+ *`lv_color_mix` computes: the channels never borrow from each other.*/
+static inline simd_u16_t mix(simd_u16_t fg, simd_u16_t bg, simd_u16_t ratio)
+{
+    simd_u16_t mask6 = _mm_set1_epi16(0x3F);
+    simd_u16_t mask5 = _mm_set1_epi16(0x1F);
+
+    simd_u16_t fg_r = _mm_srli_epi16(fg, 11);
+    simd_u16_t bg_r = _mm_srli_epi16(bg, 11);
+    simd_u16_t fg_g = _mm_and_si128(_mm_srli_epi16(fg, 5), mask6);
+    simd_u16_t bg_g = _mm_and_si128(_mm_srli_epi16(bg, 5), mask6);
+    simd_u16_t fg_b = _mm_and_si128(fg, mask5);
+    simd_u16_t bg_b = _mm_and_si128(bg, mask5);
+
+    simd_u16_t r = _mm_add_epi16(bg_r, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(fg_r, bg_r), ratio), 5));
+    simd_u16_t g = _mm_add_epi16(bg_g, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(fg_g, bg_g), ratio), 5));
+    simd_u16_t b = _mm_add_epi16(bg_b, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(fg_b, bg_b), ratio), 5));
+
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+}
+
+/*Per channel `LV_UDIV255(fg_premult + bg * opa_inv)`. The sum is at most 63 * 255 and
+ *`(x * 0x8081) >> 23` is `((x * 0x8081) >> 16) >> 7` for such `x`.*/
+static inline simd_u16_t mix_premult(const premult_t * fg, simd_u16_t bg)
+{
+    simd_u16_t div255 = _mm_set1_epi16((short)0x8081);
+    simd_u16_t mask6 = _mm_set1_epi16(0x3F);
+    simd_u16_t mask5 = _mm_set1_epi16(0x1F);
+
+    simd_u16_t r = _mm_add_epi16(fg->r, _mm_mullo_epi16(_mm_srli_epi16(bg, 11), fg->opa_inv));
+    simd_u16_t g = _mm_add_epi16(fg->g, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(bg, 5), mask6), fg->opa_inv));
+    simd_u16_t b = _mm_add_epi16(fg->b, _mm_mullo_epi16(_mm_and_si128(bg, mask5), fg->opa_inv));
+
+    r = _mm_srli_epi16(_mm_mulhi_epu16(r, div255), 7);
+    g = _mm_srli_epi16(_mm_mulhi_epu16(g, div255), 7);
+    b = _mm_srli_epi16(_mm_mulhi_epu16(b, div255), 7);
+
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+}
+
+#endif
+
+#endif /*LV_DRAW_SW_SIMD*/
@@ -0,0 +1,88 @@
+/**
+ * @file lv_draw_sw_blend_simd.h
+ *
+ */
+
+#ifndef LV_DRAW_SW_BLEND_SIMD_H
+#define LV_DRAW_SW_BLEND_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../misc/lv_color.h"
+#include "../../misc/lv_area.h"
+#include "../../misc/lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*The instruction set is selected from the compiler's target. Only SSE2 is covered by the tests,
+ *other targets keep the C code.
+ *The vector code reproduces `lv_color_mix` of RGB565, other color formats keep the C code.*/
+#if LV_USE_DRAW_SW_SIMD && LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0 && LV_COLOR_MIX_ROUND_OFS == 0
+#if defined(__SSE2__)
+#define LV_DRAW_SW_SIMD_SSE2 1
+#endif
+#endif
+
+#ifndef LV_DRAW_SW_SIMD_SSE2
+#define LV_DRAW_SW_SIMD_SSE2 0
+#endif
+
+#define LV_DRAW_SW_SIMD LV_DRAW_SW_SIMD_SSE2
+
+/*Pixels in a vector. Narrower areas are left to the C code.*/
+#define LV_DRAW_SW_SIMD_PX 8
+
+#if LV_DRAW_SW_SIMD
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Fill an area with a color like `fill_normal` of lv_draw_sw_blend.c, with the same result.
+ * @param dest_buf      the first pixel of the area
+ * @param dest_area     the area, relative to the destination buffer
+ * @param dest_stride   width of the destination buffer
+ * @param color         fill color
+ * @param opa           overall opacity
+ * @param mask          the mask of the first pixel, or NULL
+ * @param mask_stride   width of the mask buffer
+ * @return              LV_RES_OK: filled; LV_RES_INV: not handled, the C code has to fill
+ */
+lv_res_t lv_draw_sw_blend_simd_fill(lv_color_t * dest_buf, const lv_area_t * dest_area, lv_coord_t dest_stride,
+                                    lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stride);
+
+/**
+ * Blend an image to an area like `map_normal` of lv_draw_sw_blend.c, with the same result.
+ * @param dest_buf      the first pixel of the area
+ * @param dest_area     the area, relative to the destination buffer
+ * @param dest_stride   width of the destination buffer
+ * @param src_buf       the first pixel of the image to blend
+ * @param src_stride    width of the image
+ * @param opa           overall opacity
+ * @param mask          the mask of the first pixel, or NULL
+ * @param mask_stride   width of the mask buffer
+ * @return              LV_RES_OK: blended; LV_RES_INV: not handled, the C code has to blend
+ */
+lv_res_t lv_draw_sw_blend_simd_map(lv_color_t * dest_buf, const lv_area_t * dest_area, lv_coord_t dest_stride,
+                                   const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
+                                   const lv_opa_t * mask, lv_coord_t mask_stride);
+
+#endif /*LV_DRAW_SW_SIMD*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_BLEND_SIMD_H*/
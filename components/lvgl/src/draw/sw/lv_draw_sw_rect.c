@@ -11,6 +11,7 @@
 #include "../../misc/lv_txt_ap.h"
 #include "../../core/lv_refr.h"
 #include "../../misc/lv_assert.h"
+#include "../../misc/lv_gc.h"
 #include "lv_draw_sw_dither.h"
 
 /*********************
@@ -20,10 +21,21 @@
 #define SHADOW_ENHANCE          1
 #define SPLIT_LIMIT             50
 
+#define SHADOW_CACHE            LV_GC_ROOT(_lv_shadow_cache)
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_DRAW_COMPLEX
+/*A blurred corner of `size * size` opacities follows the entry*/
+typedef struct {
+    lv_cache_list_node_t node;
+    lv_coord_t sw;
+    lv_coord_t r;
+    lv_coord_t w;                           /*Size of the blurred rectangle, limited by `shadow_cache_key`*/
+    lv_coord_t h;
+} shadow_cache_entry_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -40,6 +52,11 @@ static void /* LV_ATTRIBUTE_FAST_MEM */ draw_shadow(lv_draw_ctx_t * draw_ctx, co
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_draw_corner_buf(const lv_area_t * coords, uint16_t * sh_buf,
                                                                lv_coord_t s, lv_coord_t r);
 static void /* LV_ATTRIBUTE_FAST_MEM */ shadow_blur_corner(lv_coord_t size, lv_coord_t sw, uint16_t * sh_ups_buf);
+static void shadow_mirror_corner(lv_opa_t * sh_buf, lv_coord_t size);
+static void shadow_cache_key(lv_coord_t sw, lv_coord_t r, lv_coord_t * w, lv_coord_t * h);
+static lv_opa_t * shadow_cache_find(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h);
+static void shadow_cache_add(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h, const lv_opa_t * sh_buf);
+static void shadow_cache_free(lv_cache_list_node_t * node);
 #endif
 
 void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area, const lv_area_t * inner_area,
@@ -52,10 +69,8 @@ static void draw_border_simple(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer
 /**********************
  *  STATIC VARIABLES
  **********************/
-#if defined(LV_SHADOW_CACHE_SIZE) && LV_SHADOW_CACHE_SIZE > 0
-    static uint8_t sh_cache[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
-    static int32_t sh_cache_size = -1;
-    static int32_t sh_cache_r = -1;
+#if LV_DRAW_COMPLEX
+    static uint32_t sh_cache_max_size = LV_SHADOW_CACHE_DEF_SIZE;
 #endif
 
 /**********************
@@ -82,6 +97,24 @@ void lv_draw_sw_rect(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, c
     LV_ASSERT_MEM_INTEGRITY();
 }
 
+#if LV_DRAW_COMPLEX
+void lv_draw_sw_shadow_set_cache_size(uint32_t max_bytes)
+{
+    sh_cache_max_size = max_bytes;
+    _lv_cache_list_make_room(&SHADOW_CACHE, sh_cache_max_size, 0);
+}
+
+void lv_draw_sw_shadow_free_cache(void)
+{
+    _lv_cache_list_clear(&SHADOW_CACHE);
+}
+
+void lv_draw_sw_shadow_get_cache_stats(lv_cache_list_stats_t * stats)
+{
+    *stats = SHADOW_CACHE.stats;
+}
+#endif
+
 void lv_draw_sw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
 {
 #if LV_COLOR_SCREEN_TRANSP && LV_COLOR_DEPTH == 32
@@ -161,9 +194,11 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
     blend_area.x1 = clipped_coords.x1;
     blend_area.x2 = clipped_coords.x2;
 
+    lv_draw_mask_spans_t mask_spans;
     blend_dsc.mask_buf = mask_buf;
     blend_dsc.blend_area = &blend_area;
     blend_dsc.mask_area = &blend_area;
+    blend_dsc.mask_spans = &mask_spans;
     blend_dsc.opa = LV_OPA_COVER;
 
 
@@ -226,7 +261,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
             /* Initialize the mask to opa instead of 0xFF and blend with LV_OPA_COVER.
              * It saves calculating the final opa in lv_draw_sw_blend*/
             lv_memset(mask_buf, opa, clipped_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clipped_coords.x1, h, clipped_w);
+            blend_dsc.mask_res = lv_draw_mask_apply_spans(mask_buf, clipped_coords.x1, h, clipped_w, &mask_spans);
             if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
 
 #if _DITHER_GRADIENT
@@ -248,7 +283,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
         /* Initialize the mask to opa instead of 0xFF and blend with LV_OPA_COVER.
          * It saves calculating the final opa in lv_draw_sw_blend*/
         lv_memset(mask_buf, opa, clipped_w);
-        blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, blend_area.x1, top_y, clipped_w);
+        blend_dsc.mask_res = lv_draw_mask_apply_spans(mask_buf, blend_area.x1, top_y, clipped_w, &mask_spans);
         if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
 
         if(top_y >= clipped_coords.y1) {
@@ -299,7 +334,7 @@ static void draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, co
             /*If there is no other mask do not apply mask as in the center there is no radius to mask*/
             if(mask_any_center) {
                 lv_memset(mask_buf, opa, clipped_w);
-                blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clipped_coords.x1, h, clipped_w);
+                blend_dsc.mask_res = lv_draw_mask_apply_spans(mask_buf, clipped_coords.x1, h, clipped_w, &mask_spans);
             }
 
             blend_area.y1 = h;
@@ -483,30 +518,19 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
     /*Get how many pixels are affected by the blur on the corners*/
     int32_t corner_size = dsc->shadow_width  + r_sh;
 
-    lv_opa_t * sh_buf;
+    /*The corner depends on the size of the blurred rectangle only until its other corners get into the buffer*/
+    lv_coord_t key_w = lv_area_get_width(&core_area);
+    lv_coord_t key_h = lv_area_get_height(&core_area);
+    shadow_cache_key(dsc->shadow_width, r_sh, &key_w, &key_h);
 
-#if LV_SHADOW_CACHE_SIZE
-    if(sh_cache_size == corner_size && sh_cache_r == r_sh) {
-        /*Use the cache if available*/
-        sh_buf = lv_mem_buf_get(corner_size * corner_size);
-        lv_memcpy(sh_buf, sh_cache, corner_size * corner_size);
-    }
-    else {
+    lv_opa_t * sh_buf = shadow_cache_find(dsc->shadow_width, r_sh, key_w, key_h);
+    bool sh_buf_cached = sh_buf != NULL;
+    if(!sh_buf_cached) {
         /*A larger buffer is required for calculation*/
         sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
         shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
-
-        /*Cache the corner if it fits into the cache size*/
-        if((uint32_t)corner_size * corner_size < sizeof(sh_cache)) {
-            lv_memcpy(sh_cache, sh_buf, corner_size * corner_size);
-            sh_cache_size = corner_size;
-            sh_cache_r = r_sh;
-        }
+        shadow_cache_add(dsc->shadow_width, r_sh, key_w, key_h, sh_buf);
     }
-#else
-    sh_buf = lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
-    shadow_draw_corner_buf(&core_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
-#endif
 
     /*Skip a lot of masking if the background will cover the shadow that would be masked out*/
     bool mask_any = lv_draw_mask_is_any(&shadow_area);
@@ -571,7 +595,7 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
                 blend_area.y2 = y;
 
                 if(!simple_sub) {
-                    lv_memcpy(mask_buf, sh_buf_tmp, corner_size);
+                    lv_memcpy(mask_buf, sh_buf_tmp, w);
                     blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clip_area_sub.x1, y, w);
                     if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
                 }
@@ -614,7 +638,7 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
                 blend_area.y2 = y;
 
                 if(!simple_sub) {
-                    lv_memcpy(mask_buf, sh_buf_tmp, corner_size);
+                    lv_memcpy(mask_buf, sh_buf_tmp, w);
                     blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clip_area_sub.x1, y, w);
                     if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
                 }
@@ -768,21 +792,7 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
     }
 
     /*Mirror the shadow corner buffer horizontally*/
-    sh_buf_tmp = sh_buf ;
-    for(y = 0; y < corner_size; y++) {
-        int32_t x;
-        lv_opa_t * start = sh_buf_tmp;
-        lv_opa_t * end = sh_buf_tmp + corner_size - 1;
-        for(x = 0; x < corner_size / 2; x++) {
-            lv_opa_t tmp = *start;
-            *start = *end;
-            *end = tmp;
-
-            start++;
-            end--;
-        }
-        sh_buf_tmp += corner_size;
-    }
+    shadow_mirror_corner(sh_buf, corner_size);
 
     /*Left side*/
     blend_area.x1 = shadow_area.x1;
@@ -854,7 +864,7 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
                 blend_area.y2 = y;
 
                 if(!simple_sub) {
-                    lv_memcpy(mask_buf, sh_buf_tmp, corner_size);
+                    lv_memcpy(mask_buf, sh_buf_tmp, w);
                     blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clip_area_sub.x1, y, w);
                     if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
                 }
@@ -898,7 +908,7 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
                 blend_area.y2 = y;
 
                 if(!simple_sub) {
-                    lv_memcpy(mask_buf, sh_buf_tmp, corner_size);
+                    lv_memcpy(mask_buf, sh_buf_tmp, w);
                     blend_dsc.mask_res = lv_draw_mask_apply(mask_buf, clip_area_sub.x1, y, w);
                     if(blend_dsc.mask_res == LV_DRAW_MASK_RES_FULL_COVER) blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
                 }
@@ -939,7 +949,9 @@ static void LV_ATTRIBUTE_FAST_MEM draw_shadow(lv_draw_ctx_t * draw_ctx, const lv
         lv_draw_mask_free_param(&mask_rout_param);
         lv_draw_mask_remove_id(mask_rout_id);
     }
-    lv_mem_buf_release(sh_buf);
+    /*Give back the corner to the cache as it was*/
+    if(sh_buf_cached) shadow_mirror_corner(sh_buf, corner_size);
+    else lv_mem_buf_release(sh_buf);
     lv_mem_buf_release(mask_buf);
 }
 
@@ -1109,6 +1121,84 @@ static void LV_ATTRIBUTE_FAST_MEM shadow_blur_corner(lv_coord_t size, lv_coord_t
 
     lv_mem_buf_release(sh_ups_blur_buf);
 }
+
+static void shadow_mirror_corner(lv_opa_t * sh_buf, lv_coord_t size)
+{
+    lv_coord_t y;
+    for(y = 0; y < size; y++) {
+        int32_t x;
+        lv_opa_t * start = sh_buf;
+        lv_opa_t * end = sh_buf + size - 1;
+        for(x = 0; x < size / 2; x++) {
+            lv_opa_t tmp = *start;
+            *start = *end;
+            *end = tmp;
+
+            start++;
+            end--;
+        }
+        sh_buf += size;
+    }
+}
+
+/**
+ * Limit the size of the blurred rectangle to the largest one which still changes the corner.
+ * On a larger rectangle the other corners of the radius mask are out of the corner buffer.
+ * @param sw shadow width
+ * @param r radius
+ * @param w width of the blurred rectangle, limited on return
+ * @param h height of the blurred rectangle, limited on return
+ */
+static void shadow_cache_key(lv_coord_t sw, lv_coord_t r, lv_coord_t * w, lv_coord_t * h)
+{
+    /*The same mask area as `shadow_draw_corner_buf` uses*/
+    lv_coord_t x2 = sw / 2 + r - 1 - ((sw & 1) ? 0 : 1);
+    lv_coord_t y1 = sw / 2 + 1;
+    lv_coord_t w_max = x2 + r + 1;
+    lv_coord_t h_max = sw + r + r - y1 + 1;
+    if(*w > w_max) *w = w_max;
+    if(*h > h_max) *h = h_max;
+}
+
+static lv_opa_t * shadow_cache_find(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h)
+{
+    lv_cache_list_node_t * node = SHADOW_CACHE.first;
+    while(node) {
+        shadow_cache_entry_t * entry = (shadow_cache_entry_t *)node;
+        if(entry->sw == sw && entry->r == r && entry->w == w && entry->h == h) {
+            _lv_cache_list_hit(&SHADOW_CACHE, node);
+            return (lv_opa_t *)(entry + 1);
+        }
+        node = node->next;
+    }
+
+    SHADOW_CACHE.stats.misses++;
+    return NULL;
+}
+
+static void shadow_cache_add(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h, const lv_opa_t * sh_buf)
+{
+    uint32_t corner_size = sw + r;
+    uint32_t size = sizeof(shadow_cache_entry_t) + corner_size * corner_size;
+    if(!_lv_cache_list_make_room(&SHADOW_CACHE, sh_cache_max_size, size)) return;
+
+    shadow_cache_entry_t * entry = lv_mem_alloc(size);
+    LV_ASSERT_MALLOC(entry);
+    if(entry == NULL) return;
+
+    entry->node.used_cnt = 0;
+    entry->sw = sw;
+    entry->r = r;
+    entry->w = w;
+    entry->h = h;
+    lv_memcpy(entry + 1, sh_buf, corner_size * corner_size);
+    _lv_cache_list_add(&SHADOW_CACHE, &entry->node, size, shadow_cache_free);
+}
+
+static void shadow_cache_free(lv_cache_list_node_t * node)
+{
+    lv_mem_free(node);
+}
 #endif
 
 static void draw_outline(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
@@ -1172,9 +1262,11 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
     if(!_lv_area_intersect(&draw_area, outer_area, draw_ctx->clip_area)) return;
     int32_t draw_area_w = lv_area_get_width(&draw_area);
 
+    lv_draw_mask_spans_t mask_spans;
     lv_draw_sw_blend_dsc_t blend_dsc;
     lv_memset_00(&blend_dsc, sizeof(blend_dsc));
     blend_dsc.mask_buf = lv_mem_buf_get(draw_area_w);;
+    blend_dsc.mask_spans = &mask_spans;
 
 
     /*Create mask for the outer area*/
@@ -1221,7 +1313,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
             blend_area.y2 = h;
 
             lv_memset_ff(blend_dsc.mask_buf, draw_area_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, draw_area.x1, h, draw_area_w);
+            blend_dsc.mask_res = lv_draw_mask_apply_spans(blend_dsc.mask_buf, draw_area.x1, h, draw_area_w,
+                                                          &mask_spans);
             lv_draw_sw_blend(draw_ctx, &blend_dsc);
         }
 
@@ -1294,7 +1387,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
             if(top_y < draw_area.y1 && bottom_y > draw_area.y2) continue;   /*This line is clipped now*/
 
             lv_memset_ff(blend_dsc.mask_buf, draw_area_w);
-            blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, top_y, draw_area_w);
+            blend_dsc.mask_res = lv_draw_mask_apply_spans(blend_dsc.mask_buf, blend_area.x1, top_y, draw_area_w,
+                                                          &mask_spans);
 
             if(top_y >= draw_area.y1) {
                 blend_area.y1 = top_y;
@@ -1321,7 +1415,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_spans(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                  &mask_spans);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1332,7 +1427,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_spans(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                  &mask_spans);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1350,7 +1446,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_spans(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                  &mask_spans);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -1361,7 +1458,8 @@ void draw_border_generic(lv_draw_ctx_t * draw_ctx, const lv_area_t * outer_area,
                     blend_area.y2 = h;
 
                     lv_memset_ff(blend_dsc.mask_buf, blend_w);
-                    blend_dsc.mask_res = lv_draw_mask_apply(blend_dsc.mask_buf, blend_area.x1, h, blend_w);
+                    blend_dsc.mask_res = lv_draw_mask_apply_spans(blend_dsc.mask_buf, blend_area.x1, h, blend_w,
+                                                                  &mask_spans);
                     lv_draw_sw_blend(draw_ctx, &blend_dsc);
                 }
             }
@@ -281,8 +281,23 @@ static void flex_update(lv_obj_t * cont, void * user_data)
         *cross_pos += total_track_cross_size;
     }
 
+    /*If only some children changed size the tracks before the first one of them keep their place.
+     *Only the cross position of the next track is needed from them.*/
+    int32_t changed_id = cont->spec_attr->layout_inv_child_id;
+    if(f.rev || track_cross_place != LV_FLEX_ALIGN_START || (rtl && !f.row)) changed_id = 0;
+
     while(track_first_item < (int32_t)cont->spec_attr->child_cnt && track_first_item >= 0) {
         track_t t;
+        if(changed_id > track_first_item) {
+            t.grow_dsc_calc = 0;
+            next_track_first_item = find_track_end(cont, &f, track_first_item, max_main_size, item_gap, &t);
+            if(next_track_first_item <= changed_id) {
+                track_first_item = next_track_first_item;
+                *cross_pos += t.track_cross_size + gap + track_gap;
+                continue;
+            }
+        }
+
         t.grow_dsc_calc = 1;
         /*Search the first item of the next row*/
         next_track_first_item = find_track_end(cont, &f, track_first_item, max_main_size, item_gap, &t);
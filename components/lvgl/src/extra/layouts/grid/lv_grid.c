@@ -57,6 +57,7 @@ static void item_repos(lv_obj_t * item, _lv_grid_calc_t * c, item_repos_hint_t *
 static lv_coord_t grid_align(lv_coord_t cont_size,  bool auto_size, uint8_t align, lv_coord_t gap, uint32_t track_num,
                              lv_coord_t * size_array, lv_coord_t * pos_array, bool reverse);
 static uint32_t count_tracks(const lv_coord_t * templ);
+static bool has_content_track(const lv_coord_t * templ);
 
 static inline const lv_coord_t * get_col_dsc(lv_obj_t * obj)
 {
@@ -364,8 +365,12 @@ static void grid_update(lv_obj_t * cont, void * user_data)
     hint.grid_abs.x = pad_left + cont->coords.x1 - lv_obj_get_scroll_x(cont);
     hint.grid_abs.y = pad_top + cont->coords.y1 - lv_obj_get_scroll_y(cont);
 
-    uint32_t i;
-    for(i = 0; i < cont->spec_attr->child_cnt; i++) {
+    /*If only some children changed size and no track is sized by its content the cells stay where they are.
+     *Only the children from the first changed one on can move in their cell.*/
+    uint32_t i = cont->spec_attr->layout_inv_child_id;
+    if(has_content_track(col_templ) || has_content_track(row_templ)) i = 0;
+
+    for(; i < cont->spec_attr->child_cnt; i++) {
         lv_obj_t * item = cont->spec_attr->children[i];
         item_repos(item, &c, &hint);
     }
@@ -778,5 +783,15 @@ static uint32_t count_tracks(const lv_coord_t * templ)
     return i;
 }
 
+static bool has_content_track(const lv_coord_t * templ)
+{
+    uint32_t i;
+    for(i = 0; templ[i] != LV_GRID_TEMPLATE_LAST; i++) {
+        if(IS_CONTENT(templ[i])) return true;
+    }
+
+    return false;
+}
+
 
 #endif /*LV_USE_GRID*/
@@ -18,6 +18,9 @@
 /*********************
  *      DEFINES
  *********************/
+#define BITMAP_CACHE                LV_GC_ROOT(_lv_font_bitmap_cache)
+#define BITMAP_CACHE_BUCKET(font, letter) \
+    BITMAP_CACHE.bucket[((letter) ^ ((uintptr_t)(font) >> 4)) & (_LV_FONT_BITMAP_CACHE_BUCKET_CNT - 1)]
 
 /**********************
  *      TYPEDEFS
@@ -44,6 +47,9 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
     static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint8_t len);
     static inline void rle_init(const uint8_t * in,  uint8_t bpp);
     static inline uint8_t rle_next(void);
+    static const uint8_t * bitmap_cache_find(const lv_font_t * font, uint32_t letter);
+    static uint8_t * bitmap_cache_add(const lv_font_t * font, uint32_t letter, uint32_t buf_size);
+    static void bitmap_cache_free(lv_cache_list_node_t * node);
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 /**********************
@@ -56,6 +62,8 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
     static uint8_t rle_prev_v;
     static uint8_t rle_cnt;
     static rle_state_t rle_state;
+
+    static uint32_t bitmap_cache_max_size = LV_FONT_BITMAP_CACHE_DEF_SIZE;
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 /**********************
@@ -81,6 +89,15 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     if(unicode_letter == '\t') unicode_letter = ' ';
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+
+#if LV_USE_FONT_COMPRESSED
+    /*A decompressed bitmap needs no glyph lookup*/
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) {
+        const uint8_t * cached = bitmap_cache_find(font, unicode_letter);
+        if(cached) return cached;
+    }
+#endif
+
     uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
     if(!gid) return NULL;
 
@@ -115,18 +132,25 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
                 break;
         }
 
-        if(last_buf_size < buf_size) {
-            uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
-            LV_ASSERT_MALLOC(tmp);
-            if(tmp == NULL) return NULL;
-            LV_GC_ROOT(_lv_font_decompr_buf) = tmp;
-            last_buf_size = buf_size;
+        BITMAP_CACHE.lru.stats.misses++;
+
+        /*Decompress into the cache or if it's too small into the shared buffer*/
+        uint8_t * buf = bitmap_cache_add(font, unicode_letter, buf_size);
+        if(buf == NULL) {
+            if(last_buf_size < buf_size) {
+                uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
+                LV_ASSERT_MALLOC(tmp);
+                if(tmp == NULL) return NULL;
+                LV_GC_ROOT(_lv_font_decompr_buf) = tmp;
+                last_buf_size = buf_size;
+            }
+            buf = LV_GC_ROOT(_lv_font_decompr_buf);
         }
 
         bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
-        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h,
+        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], buf, gdsc->box_w, gdsc->box_h,
                    (uint8_t)fdsc->bpp, prefilter);
-        return LV_GC_ROOT(_lv_font_decompr_buf);
+        return buf;
 #else /*!LV_USE_FONT_COMPRESSED*/
         LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
         return NULL;
@@ -202,6 +226,37 @@ void _lv_font_clean_up_fmt_txt(void)
 #endif
 }
 
+#if LV_USE_FONT_COMPRESSED
+void lv_font_fmt_txt_set_bitmap_cache_size(uint32_t max_bytes)
+{
+    bitmap_cache_max_size = max_bytes;
+    _lv_cache_list_make_room(&BITMAP_CACHE.lru, bitmap_cache_max_size, 0);
+}
+
+void lv_font_fmt_txt_free_bitmap_cache(const lv_font_t * font)
+{
+    if(font == NULL) {
+        _lv_cache_list_clear(&BITMAP_CACHE.lru);
+        return;
+    }
+
+    lv_cache_list_node_t * node = BITMAP_CACHE.lru.first;
+    while(node) {
+        lv_cache_list_node_t * next = node->next;
+        if(((_lv_font_bitmap_cache_entry_t *)node)->font == font) {
+            _lv_cache_list_remove(&BITMAP_CACHE.lru, node);
+            bitmap_cache_free(node);
+        }
+        node = next;
+    }
+}
+
+void lv_font_fmt_txt_get_bitmap_cache_stats(lv_cache_list_stats_t * stats)
+{
+    *stats = BITMAP_CACHE.lru.stats;
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -573,6 +628,56 @@ static inline uint8_t rle_next(void)
 
     return ret;
 }
+static const uint8_t * bitmap_cache_find(const lv_font_t * font, uint32_t letter)
+{
+    _lv_font_bitmap_cache_entry_t * entry = BITMAP_CACHE_BUCKET(font, letter);
+    while(entry) {
+        if(entry->letter == letter && entry->font == font) {
+            _lv_cache_list_hit(&BITMAP_CACHE.lru, &entry->node);
+            return (const uint8_t *)(entry + 1);
+        }
+        entry = entry->hash_next;
+    }
+
+    return NULL;
+}
+
+/**
+ * Add an entry for the bitmap of a letter to the cache
+ * @param font pointer to the font
+ * @param letter the letter
+ * @param buf_size size of the decompressed bitmap
+ * @return the buffer of the bitmap in the entry or NULL if it doesn't fit into the cache
+ */
+static uint8_t * bitmap_cache_add(const lv_font_t * font, uint32_t letter, uint32_t buf_size)
+{
+    uint32_t size = sizeof(_lv_font_bitmap_cache_entry_t) + buf_size;
+    /*A returned bitmap is used only until the next letter, so any of them can be freed*/
+    if(!_lv_cache_list_make_room(&BITMAP_CACHE.lru, bitmap_cache_max_size, size)) return NULL;
+
+    _lv_font_bitmap_cache_entry_t * entry = lv_mem_alloc(size);
+    LV_ASSERT_MALLOC(entry);
+    if(entry == NULL) return NULL;
+
+    entry->node.used_cnt = 0;
+    entry->font = font;
+    entry->letter = letter;
+    _lv_font_bitmap_cache_entry_t ** bucket = &BITMAP_CACHE_BUCKET(font, letter);
+    entry->hash_next = *bucket;
+    *bucket = entry;
+    _lv_cache_list_add(&BITMAP_CACHE.lru, &entry->node, size, bitmap_cache_free);
+    return (uint8_t *)(entry + 1);
+}
+
+static void bitmap_cache_free(lv_cache_list_node_t * node)
+{
+    _lv_font_bitmap_cache_entry_t * entry = (_lv_font_bitmap_cache_entry_t *)node;
+    _lv_font_bitmap_cache_entry_t ** link = &BITMAP_CACHE_BUCKET(entry->font, entry->letter);
+    while(*link != entry) link = &(*link)->hash_next;
+    *link = entry->hash_next;
+    lv_mem_free(entry);
+}
+
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 /** Code Comparator.
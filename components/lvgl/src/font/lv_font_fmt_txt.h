@@ -17,6 +17,7 @@ extern "C" {
 #include <stddef.h>
 #include <stdbool.h>
 #include "lv_font.h"
+#include "../misc/lv_cache_list.h"
 
 /*********************
  *      DEFINES
@@ -197,6 +198,22 @@ typedef struct {
     lv_font_fmt_txt_glyph_cache_t * cache;
 } lv_font_fmt_txt_dsc_t;
 
+/*An entry of the cache of the decompressed glyph bitmaps, the bitmap follows it*/
+typedef struct _lv_font_bitmap_cache_entry_t {
+    lv_cache_list_node_t node;
+    struct _lv_font_bitmap_cache_entry_t * hash_next;   /*Next entry in the same bucket*/
+    const lv_font_t * font;
+    uint32_t letter;
+} _lv_font_bitmap_cache_entry_t;
+
+/*Number of hash buckets of the glyph bitmap cache, a power of 2*/
+#define _LV_FONT_BITMAP_CACHE_BUCKET_CNT 32
+
+typedef struct {
+    _lv_font_bitmap_cache_entry_t * bucket[_LV_FONT_BITMAP_CACHE_BUCKET_CNT];
+    lv_cache_list_t lru;
+} _lv_font_bitmap_cache_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -225,6 +242,29 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
  */
 void _lv_font_clean_up_fmt_txt(void);
 
+#if LV_USE_FONT_COMPRESSED
+/**
+ * Set the size of the cache of the decompressed glyph bitmaps.
+ * The least recently used bitmaps are freed if the cache is larger than the new size.
+ * @param max_bytes max. bytes of the cached bitmaps. 0: decompress the bitmap for every letter
+ */
+void lv_font_fmt_txt_set_bitmap_cache_size(uint32_t max_bytes);
+
+/**
+ * Free the cached bitmaps of a font. Needs to be called before a compressed font is freed.
+ * Called by `lv_font_free` and with NULL by `lv_deinit`.
+ * @param font pointer to a font or NULL to free the bitmaps of all fonts
+ */
+void lv_font_fmt_txt_free_bitmap_cache(const lv_font_t * font);
+
+/**
+ * Get the statistics of the cache of the decompressed glyph bitmaps.
+ * A hit is a letter of a compressed font which found its bitmap in the cache, a miss one which decompressed it.
+ * @param stats store the statistics here
+ */
+void lv_font_fmt_txt_get_bitmap_cache_stats(lv_cache_list_stats_t * stats);
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -120,6 +120,9 @@ void lv_font_free(lv_font_t * font)
         lv_font_fmt_txt_dsc_t * dsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
         if(NULL != dsc) {
+#if LV_USE_FONT_COMPRESSED
+            lv_font_fmt_txt_free_bitmap_cache(font);
+#endif
 
             if(dsc->kern_classes == 0) {
                 lv_font_fmt_txt_kern_pair_t * kern_dsc =
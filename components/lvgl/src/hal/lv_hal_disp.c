@@ -93,7 +93,10 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
     driver->offset_y         = 0;
     driver->antialiasing     = LV_COLOR_DEPTH > 8 ? 1 : 0;
     driver->screen_transp    = 0;
+    driver->band_refresh     = 0;
+    driver->cull_occluded    = 0;
     driver->dpi              = LV_DPI_DEF;
+    driver->flush_cost       = 0;
     driver->color_chroma_key = LV_COLOR_CHROMA_KEY;
 
 #if LV_USE_GPU_RA6M3_G2D
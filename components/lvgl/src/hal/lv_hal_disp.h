@@ -63,6 +63,19 @@ typedef struct _lv_disp_draw_buf_t {
     volatile uint32_t last_part         : 1; /*1: the last part of the current area is being rendered*/
 } lv_disp_draw_buf_t;
 
+/**
+ * Steps of a refresh reported to `refr_phase_cb`
+ */
+typedef enum {
+    LV_DISP_REFR_PHASE_REFR = 0,    /**< The whole refresh of the display, the other phases are inside it*/
+    LV_DISP_REFR_PHASE_LAYOUT,      /**< Update the layout of the screens and the layers*/
+    LV_DISP_REFR_PHASE_JOIN,        /**< Join the invalidated areas*/
+    LV_DISP_REFR_PHASE_RENDER,      /**< Render a part of an area into the draw buffer*/
+    LV_DISP_REFR_PHASE_FLUSH_WAIT,  /**< Wait for a draw buffer being flushed*/
+    LV_DISP_REFR_PHASE_FLUSH,       /**< Pass the draw buffer to `flush_cb`*/
+    _LV_DISP_REFR_PHASE_LAST
+} lv_disp_refr_phase_t;
+
 typedef enum {
     LV_DISP_ROT_NONE = 0,
     LV_DISP_ROT_90,
@@ -99,9 +112,17 @@ typedef struct _lv_disp_drv_t {
     uint32_t rotated : 2;            /**< 1: turn the display by 90 degree. @warning Does not update coordinates for you!*/
     uint32_t screen_transp : 1;      /**Handle if the screen doesn't have a solid (opa == LV_OPA_COVER) background.
                                        * Use only if required because it's slower.*/
+    uint32_t band_refresh : 1;       /**< 1: Render the rows of the invalidated areas band by band, each band once*/
+    uint32_t cull_occluded : 1;      /**< 1: Don't draw the parts of the objects hidden by opaque objects drawn later*/
 
     uint32_t dpi : 10;              /** DPI (dot per inch) of the display. Default value is `LV_DPI_DEF`.*/
 
+    /** Fixed cost of one `flush_cb` call in pixels, e.g. the commands addressing the area on the display.
+     * Invalidated areas are joined when the pixels added by their union cost less than the saved flush.
+     * With `band_refresh` a band of rows is split where the next row would add more than `flush_cost` pixels.
+     * Default value is 0: join only if the union is smaller than the two areas, and never split a band.*/
+    uint32_t flush_cost;
+
     /** MANDATORY: Write the internal buffer (draw_buf) to the display. 'lv_disp_flush_ready()' has to be
      * called when finished*/
     void (*flush_cb)(struct _lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
@@ -137,6 +158,11 @@ typedef struct _lv_disp_drv_t {
     /** OPTIONAL: called when start rendering */
     void (*render_start_cb)(struct _lv_disp_drv_t * disp_drv);
 
+    /** OPTIONAL: Called at the start (`end == false`) and at the end of each phase of a refresh to time them.
+     * `area` is the area being rendered or flushed, NULL for the other phases*/
+    void (*refr_phase_cb)(struct _lv_disp_drv_t * disp_drv, lv_disp_refr_phase_t phase, bool end,
+                          const lv_area_t * area);
+
     /** On CHROMA_KEYED images this color will be transparent.
      * `LV_COLOR_CHROMA_KEY` by default. (lv_conf.h)*/
     lv_color_t color_chroma_key;
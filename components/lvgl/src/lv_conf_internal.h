@@ -291,26 +291,29 @@
 #endif
 #if LV_DRAW_COMPLEX != 0
 
-    /*Allow buffering some shadow calculation.
-    *LV_SHADOW_CACHE_SIZE is the max. shadow size to buffer, where shadow size is `shadow_width + radius`
-    *Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
-    #ifndef LV_SHADOW_CACHE_SIZE
-        #ifdef CONFIG_LV_SHADOW_CACHE_SIZE
-            #define LV_SHADOW_CACHE_SIZE CONFIG_LV_SHADOW_CACHE_SIZE
+    /*Maximum memory (in bytes) of the cached blurred shadow corners.
+    *A corner has (shadow_width + radius)^2 bytes and a 24 bytes descriptor on 32 bit targets.
+    *The least recently used corner is freed first.
+    *Replaces LV_SHADOW_CACHE_SIZE, the largest cached shadow size, which is rejected. 0: to disable caching*/
+    #ifndef LV_SHADOW_CACHE_DEF_SIZE
+        #ifdef CONFIG_LV_SHADOW_CACHE_DEF_SIZE
+            #define LV_SHADOW_CACHE_DEF_SIZE CONFIG_LV_SHADOW_CACHE_DEF_SIZE
         #else
-            #define LV_SHADOW_CACHE_SIZE 0
+            #define LV_SHADOW_CACHE_DEF_SIZE 8192
         #endif
     #endif
 
-    /* Set number of maximally cached circle data.
-    * The circumference of 1/4 circle are saved for anti-aliasing
-    * radius * 4 bytes are used per circle (the most often used radiuses are saved)
+    /* Maximum memory (in bytes) of the cached circle data of the rounded corners.
+    * The circumference of 1/4 circle are saved for anti-aliasing and kept between the refreshes.
+    * radius * 6 + 6 bytes and a descriptor (40 bytes on 32 bit targets) are used per circle
+    * (the least recently used is freed first)
+    * Replaces LV_CIRCLE_CACHE_SIZE, a number of circles, which is rejected.
     * 0: to disable caching */
-    #ifndef LV_CIRCLE_CACHE_SIZE
-        #ifdef CONFIG_LV_CIRCLE_CACHE_SIZE
-            #define LV_CIRCLE_CACHE_SIZE CONFIG_LV_CIRCLE_CACHE_SIZE
+    #ifndef LV_CIRCLE_CACHE_DEF_SIZE
+        #ifdef CONFIG_LV_CIRCLE_CACHE_DEF_SIZE
+            #define LV_CIRCLE_CACHE_DEF_SIZE CONFIG_LV_CIRCLE_CACHE_DEF_SIZE
         #else
-            #define LV_CIRCLE_CACHE_SIZE 4
+            #define LV_CIRCLE_CACHE_DEF_SIZE 4096
         #endif
     #endif
 #endif /*LV_DRAW_COMPLEX*/
@@ -412,6 +415,17 @@
     #endif
 #endif
 
+/*Blend RGB565 with SIMD instructions in the software renderer: SSE2 on x86.
+ *Only SSE2 is implemented: there is no PIE code for the ESP32-S3, the target gets nothing from it.
+ *The result is the same as with the C code. Other targets and color formats keep the C code.*/
+#ifndef LV_USE_DRAW_SW_SIMD
+    #ifdef CONFIG_LV_USE_DRAW_SW_SIMD
+        #define LV_USE_DRAW_SW_SIMD CONFIG_LV_USE_DRAW_SW_SIMD
+    #else
+        #define LV_USE_DRAW_SW_SIMD 0
+    #endif
+#endif
+
 /*-------------
  * GPU
  *-----------*/
@@ -1228,6 +1242,19 @@
         #define LV_USE_FONT_COMPRESSED 0
     #endif
 #endif
+#if LV_USE_FONT_COMPRESSED
+    /*Maximum memory (in bytes) of the decompressed glyph bitmaps kept between the refreshes.
+     *A bitmap has box_w * box_h * bpp / 8 bytes and a descriptor (28 bytes on 32 bit targets)
+     *(the least recently used is freed first)
+     *0: to disable caching*/
+    #ifndef LV_FONT_BITMAP_CACHE_DEF_SIZE
+        #ifdef CONFIG_LV_FONT_BITMAP_CACHE_DEF_SIZE
+            #define LV_FONT_BITMAP_CACHE_DEF_SIZE CONFIG_LV_FONT_BITMAP_CACHE_DEF_SIZE
+        #else
+            #define LV_FONT_BITMAP_CACHE_DEF_SIZE 8192
+        #endif
+    #endif
+#endif
 
 /*Enable subpixel rendering*/
 #ifndef LV_USE_FONT_SUBPX
@@ -2525,6 +2552,14 @@ LV_EXPORT_CONST_INT(LV_DPI_DEF);
     #define LV_LOG_TRACE_ANIM       0
 #endif  /*LV_USE_LOG*/
 
+/*Options replaced by ones with a different meaning, the old value would be ignored silently*/
+#ifdef LV_CIRCLE_CACHE_SIZE
+    #error "LV_CIRCLE_CACHE_SIZE (number of circles) is replaced by LV_CIRCLE_CACHE_DEF_SIZE (bytes)"
+#endif
+#ifdef LV_SHADOW_CACHE_SIZE
+    #error "LV_SHADOW_CACHE_SIZE (largest shadow size) is replaced by LV_SHADOW_CACHE_DEF_SIZE (bytes)"
+#endif
+
 
 /*If running without lv_conf.h add typedefs with default value*/
 #ifdef LV_CONF_SKIP
@@ -0,0 +1,142 @@
+/**
+ * @file lv_cache_list.c
+ * Least recently used list of the cache entries with a byte budget.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_cache_list.h"
+#include "lv_gc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void node_unlink(lv_cache_list_t * list, lv_cache_list_node_t * node);
+static void node_push_first(lv_cache_list_t * list, lv_cache_list_node_t * node);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_cache_list_add(lv_cache_list_t * list, lv_cache_list_node_t * node, uint32_t size,
+                        lv_cache_list_free_cb_t free_cb)
+{
+    /*Known to `_lv_cache_list_reclaim` from the first entry on*/
+    if(list->free_cb == NULL) {
+        list->free_cb = free_cb;
+        list->next_list = LV_GC_ROOT(_lv_cache_lists);
+        LV_GC_ROOT(_lv_cache_lists) = list;
+    }
+
+    node->size = size;
+    node_push_first(list, node);
+
+    list->stats.entries++;
+    list->stats.size += size;
+}
+
+void _lv_cache_list_remove(lv_cache_list_t * list, lv_cache_list_node_t * node)
+{
+    node_unlink(list, node);
+
+    list->stats.entries--;
+    list->stats.size -= node->size;
+}
+
+void _lv_cache_list_hit(lv_cache_list_t * list, lv_cache_list_node_t * node)
+{
+    list->stats.hits++;
+    if(list->first == node) return;
+
+    node_unlink(list, node);
+    node_push_first(list, node);
+}
+
+bool _lv_cache_list_make_room(lv_cache_list_t * list, uint32_t max_size, uint32_t size)
+{
+    if(size > max_size) return false;
+
+    lv_cache_list_node_t * node = list->last;
+    while(list->stats.size + size > max_size) {
+        while(node && node->used_cnt) node = node->prev;
+        if(node == NULL) return false;
+
+        lv_cache_list_node_t * prev = node->prev;
+        _lv_cache_list_remove(list, node);
+        list->stats.evictions++;
+        list->free_cb(node);
+        node = prev;
+    }
+
+    return true;
+}
+
+void _lv_cache_list_clear(lv_cache_list_t * list)
+{
+    while(list->first) {
+        lv_cache_list_node_t * node = list->first;
+        _lv_cache_list_remove(list, node);
+        list->free_cb(node);
+    }
+}
+
+bool _lv_cache_list_reclaim(void)
+{
+    bool freed = false;
+    lv_cache_list_t * list;
+    for(list = LV_GC_ROOT(_lv_cache_lists); list; list = list->next_list) {
+        lv_cache_list_node_t * node = list->last;
+        while(node && node != list->first) {
+            lv_cache_list_node_t * prev = node->prev;
+            if(node->used_cnt == 0) {
+                _lv_cache_list_remove(list, node);
+                list->stats.evictions++;
+                list->free_cb(node);
+                freed = true;
+            }
+            node = prev;
+        }
+    }
+
+    return freed;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void node_unlink(lv_cache_list_t * list, lv_cache_list_node_t * node)
+{
+    if(node->prev) node->prev->next = node->next;
+    else list->first = node->next;
+    if(node->next) node->next->prev = node->prev;
+    else list->last = node->prev;
+    node->prev = NULL;
+    node->next = NULL;
+}
+
+static void node_push_first(lv_cache_list_t * list, lv_cache_list_node_t * node)
+{
+    node->prev = NULL;
+    node->next = list->first;
+    if(list->first) list->first->prev = node;
+    else list->last = node;
+    list->first = node;
+}
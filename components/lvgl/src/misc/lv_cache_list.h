@@ -0,0 +1,118 @@
+/**
+ * @file lv_cache_list.h
+ * Least recently used list of the cache entries with a byte budget.
+ * The node is embedded as the first member of the entries, finding an entry by its key is left to the cache.
+ */
+
+#ifndef LV_CACHE_LIST_H
+#define LV_CACHE_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** The first member of a cache entry*/
+typedef struct _lv_cache_list_node_t {
+    struct _lv_cache_list_node_t * prev;    /*The more recently used entry*/
+    struct _lv_cache_list_node_t * next;    /*The less recently used entry*/
+    uint32_t size;                          /*Bytes of the entry counted in the cache*/
+    uint32_t used_cnt;                      /*Referenced outside of the cache, not freed to make room if not 0*/
+} lv_cache_list_node_t;
+
+typedef struct {
+    uint32_t hits;          /*Lookups which found their entry in the cache*/
+    uint32_t misses;        /*Lookups which had to create their entry*/
+    uint32_t evictions;     /*Entries freed to make room for a new one*/
+    uint32_t entries;       /*Entries in the cache now*/
+    uint32_t size;          /*Bytes used by the entries in the cache now*/
+} lv_cache_list_stats_t;
+
+/**
+ * Called for an entry already removed from the list to remove it from the lookup of the cache and free it
+ */
+typedef void (*lv_cache_list_free_cb_t)(lv_cache_list_node_t * node);
+
+/** A zeroed list is empty*/
+typedef struct _lv_cache_list_t {
+    lv_cache_list_node_t * first;       /*The most recently used entry*/
+    lv_cache_list_node_t * last;        /*The least recently used entry*/
+    lv_cache_list_free_cb_t free_cb;    /*Frees the entries, set by the first `_lv_cache_list_add`*/
+    struct _lv_cache_list_t * next_list;    /*The next list `_lv_cache_list_reclaim` frees entries of*/
+    lv_cache_list_stats_t stats;
+} lv_cache_list_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Add an entry to the list as the most recently used one
+ * @param list pointer to the list
+ * @param node the node of the entry, `used_cnt` is left as it is
+ * @param size bytes of the entry to count in the cache
+ * @param free_cb frees the entries of the list, the same for every entry
+ */
+void _lv_cache_list_add(lv_cache_list_t * list, lv_cache_list_node_t * node, uint32_t size,
+                        lv_cache_list_free_cb_t free_cb);
+
+/**
+ * Remove an entry from the list. It does not free the entry.
+ * @param list pointer to the list
+ * @param node the node of the entry
+ */
+void _lv_cache_list_remove(lv_cache_list_t * list, lv_cache_list_node_t * node);
+
+/**
+ * Count a hit and make an entry the most recently used one
+ * @param list pointer to the list
+ * @param node the node of the entry found in the cache
+ */
+void _lv_cache_list_hit(lv_cache_list_t * list, lv_cache_list_node_t * node);
+
+/**
+ * Free the least recently used, not referenced entries until `size` more bytes fit into the cache
+ * @param list pointer to the list
+ * @param max_size max. bytes of the cache
+ * @param size the bytes to make room for, 0 to only apply a new `max_size`
+ * @return true: `size` bytes fit; false: the cache is too small or the remaining entries are referenced
+ */
+bool _lv_cache_list_make_room(lv_cache_list_t * list, uint32_t max_size, uint32_t size);
+
+/**
+ * Free every entry, the referenced ones too. The hit, miss and eviction counters are kept.
+ * @param list pointer to the list
+ */
+void _lv_cache_list_clear(lv_cache_list_t * list);
+
+/**
+ * Free the not referenced entries of every list but their most recently used one, counted as evictions.
+ * Called by `lv_mem_alloc` and `lv_mem_realloc` when the heap is full.
+ * The most recently used entry is kept as the caches return pointers into it which are used until the next lookup.
+ * @return true: some memory was freed; false: nothing to free
+ */
+bool _lv_cache_list_reclaim(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_CACHE_LIST_H*/
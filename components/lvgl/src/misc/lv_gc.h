@@ -19,8 +19,10 @@ extern "C" {
 #include "lv_ll.h"
 #include "lv_timer.h"
 #include "lv_types.h"
+#include "lv_cache_list.h"
 #include "../draw/lv_img_cache.h"
 #include "../draw/lv_draw_mask.h"
+#include "../font/lv_font_fmt_txt.h"
 #include "../core/lv_obj_pos.h"
 
 /*********************
@@ -54,11 +56,14 @@ extern "C" {
     LV_DISPATCH_COND(f, _lv_img_cache_entry_t, _lv_img_cache_single, LV_IMG_CACHE_DEF, 0)              \
     LV_DISPATCH(f, lv_timer_t*, _lv_timer_act)                                                         \
     LV_DISPATCH(f, lv_mem_buf_arr_t , lv_mem_buf)                                                      \
-    LV_DISPATCH_COND(f, _lv_draw_mask_radius_circle_dsc_arr_t , _lv_circle_cache, LV_DRAW_COMPLEX, 1)  \
+    LV_DISPATCH(f, lv_cache_list_t * , _lv_cache_lists)                                                \
+    LV_DISPATCH_COND(f, _lv_draw_mask_circle_cache_t , _lv_circle_cache, LV_DRAW_COMPLEX, 1)           \
+    LV_DISPATCH_COND(f, lv_cache_list_t , _lv_shadow_cache, LV_DRAW_COMPLEX, 1)                        \
     LV_DISPATCH_COND(f, _lv_draw_mask_saved_arr_t , _lv_draw_mask_list, LV_DRAW_COMPLEX, 1)            \
     LV_DISPATCH(f, void * , _lv_theme_default_styles)                                                  \
     LV_DISPATCH(f, void * , _lv_theme_basic_styles)                                                  \
     LV_DISPATCH_COND(f, uint8_t *, _lv_font_decompr_buf, LV_USE_FONT_COMPRESSED, 1)                    \
+    LV_DISPATCH_COND(f, _lv_font_bitmap_cache_t , _lv_font_bitmap_cache, LV_USE_FONT_COMPRESSED, 1)    \
     LV_DISPATCH(f, uint8_t * , _lv_grad_cache_mem)                                                     \
     LV_DISPATCH(f, uint8_t * , _lv_style_custom_prop_flag_lookup_table)
 
@@ -136,6 +136,15 @@ void * lv_mem_alloc(size_t size)
     void * alloc = LV_MEM_CUSTOM_ALLOC(size);
 #endif
 
+    /*The caches give back their memory*/
+    if(alloc == NULL && _lv_cache_list_reclaim()) {
+#if LV_MEM_CUSTOM == 0
+        alloc = lv_tlsf_malloc(tlsf, size);
+#else
+        alloc = LV_MEM_CUSTOM_ALLOC(size);
+#endif
+    }
+
     if(alloc == NULL) {
         LV_LOG_INFO("couldn't allocate memory (%lu bytes)", (unsigned long)size);
 #if LV_LOG_LEVEL <= LV_LOG_LEVEL_INFO
@@ -207,6 +216,14 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
 #else
     void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
 #endif
+
+    if(new_p == NULL && _lv_cache_list_reclaim()) {
+#if LV_MEM_CUSTOM == 0
+        new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+#else
+        new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
+#endif
+    }
     if(new_p == NULL) {
         LV_LOG_ERROR("couldn't allocate memory");
         return NULL;
@@ -3,6 +3,7 @@ CSRCS += lv_anim_timeline.c
 CSRCS += lv_area.c
 CSRCS += lv_async.c
 CSRCS += lv_bidi.c
+CSRCS += lv_cache_list.c
 CSRCS += lv_color.c
 CSRCS += lv_fs.c
 CSRCS += lv_gc.c
@@ -3,6 +3,7 @@
 import argparse
 import errno
 import glob
+import json
 import shutil
 import subprocess
 import sys
@@ -22,16 +23,50 @@ build_only_options = {
 test_options = {
     'OPTIONS_TEST_SYSHEAP': 'Test config, system heap, 32 bit color depth',
     'OPTIONS_TEST_DEFHEAP': 'Test config, LVGL heap, 32 bit color depth',
+    'OPTIONS_TEST_SIMD': 'SIMD blend test, system heap, 16 bit color depth',
 }
 
+bench_options = {
+    'OPTIONS_BENCH': 'Replay benchmark, system heap, 16 bit color depth',
+}
+
+# Scene, resolution and extra arguments of each benchmark run. The last one
+# is the PT6891 configuration: flush cost of 4 SPI transactions, culling on.
+bench_cases = [
+    ('benchmark', '800x480', []),
+    ('benchmark', '320x240', []),
+    ('benchmark', '95x28', []),
+    ('benchmark', '95x28', ['--flush-cost', '64', '--cull']),
+    ('benchmark:2', '800x480', []),     # Rectangle rounded
+    ('benchmark:10', '800x480', []),    # Circle border
+    ('benchmark:74', '800x480', []),    # Text large compressed
+    ('widgets', '800x480', []),
+    ('widgets', '320x240', []),
+    ('widgets', '95x28', []),
+    ('stress', '800x480', []),
+    ('stress', '320x240', []),
+    ('stress', '95x28', []),
+]
+
+# Counters which fail the benchmark when they grow by more than this ratio
+# over the reference. They do not depend on the machine.
+bench_budget_counters = ['flushes', 'flushed_px', 'blended_px', 'draw_calls',
+                         'mallocs', 'reallocs', 'circle_misses',
+                         'shadow_misses', 'glyph_misses']
+bench_tolerance = 0.01
+bench_ref_file = 'ref_bench.json'
+
 
 def is_valid_option_name(option_name):
-    return option_name in build_only_options or option_name in test_options
+    return option_name in build_only_options or option_name in test_options \
+        or option_name in bench_options
 
 
 def get_option_description(option_name):
     if option_name in build_only_options:
         return build_only_options[option_name]
+    if option_name in bench_options:
+        return bench_options[option_name]
     return test_options[option_name]
 
 
@@ -126,6 +161,93 @@ def run_tests(options_name):
         ['ctest', '--timeout', '30', '--parallel', str(os.cpu_count()), '--output-on-failure'])
 
 
+def bench_case_name(result):
+    '''Return the key of a benchmark result, e.g. "benchmark 95x28 cull".'''
+    name = '%s %dx%d' % (result['scene'], result['hor_res'], result['ver_res'])
+    if result['flush_cost']:
+        name += ' flush_cost=%d' % result['flush_cost']
+    if result['cull']:
+        name += ' cull'
+    if result['band']:
+        name += ' band'
+    return name
+
+
+def compare_bench(results, ref_results):
+    '''Compare benchmark results with the reference ones.
+
+    Return the number of regressions: a budget counter grown past the
+    tolerance, or different pixels.'''
+    refs = {bench_case_name(r): r for r in ref_results}
+    regressions = 0
+    for result in results:
+        name = bench_case_name(result)
+        ref = refs.get(name)
+        if ref is None:
+            print('%-36s no reference' % name)
+            continue
+
+        notes = []
+        for counter in bench_budget_counters:
+            # A counter added after the reference was written has no budget yet
+            if counter not in ref or result[counter] == ref[counter]:
+                continue
+            change = (result[counter] - ref[counter]) / max(ref[counter], 1)
+            notes.append('%s %+.2f%%' % (counter, change * 100))
+            if change > bench_tolerance:
+                regressions += 1
+        if result['pixel_hash'] != ref['pixel_hash']:
+            notes.append('pixels differ')
+            regressions += 1
+        print('%-36s %s' % (name, ', '.join(notes) if notes else 'same'))
+
+    return regressions
+
+
+def run_bench(options_name, update_ref):
+    '''Run the benchmark cases, write the results to report/bench.json and
+    compare them with the reference.'''
+    global lvgl_test_dir
+
+    print()
+    print()
+    label = 'Running benchmark for %s' % options_abbrev(options_name)
+    print('=' * len(label))
+    print(label)
+    print('=' * len(label), flush=True)
+
+    bench_exe = os.path.join(get_build_dir(options_name), 'lv_bench')
+    results = []
+    for scene, res, args in bench_cases:
+        out = subprocess.check_output([bench_exe, '--scene', scene, '--res', res] + args)
+        results.append(json.loads(out))
+
+    os.chdir(lvgl_test_dir)
+    os.makedirs('report', exist_ok=True)
+    with open('report/bench.json', 'w') as f:
+        json.dump(results, f, indent=1)
+    print('Results: report/bench.json')
+
+    if update_ref:
+        # The perf counters depend on the machine, they are only reported
+        for result in results:
+            del result['instructions']
+            del result['cycles']
+        with open(bench_ref_file, 'w') as f:
+            json.dump(results, f, indent=1)
+            f.write('\n')
+        print('Updated %s' % bench_ref_file)
+        return
+
+    with open(bench_ref_file) as f:
+        ref_results = json.load(f)
+    regressions = compare_bench(results, ref_results)
+    if regressions:
+        print('%d regressions against %s, run with --update-bench-ref if they are expected'
+              % (regressions, bench_ref_file), file=sys.stderr)
+        sys.exit(1)
+
+
 def generate_code_coverage_report():
     '''Produce code coverage test reports for the test execution.'''
     global lvgl_test_dir
@@ -171,8 +293,11 @@ if __name__ == "__main__":
                         help='clean existing build artifacts before operation.')
     parser.add_argument('--report', action='store_true',
                         help='generate code coverage report for tests.')
-    parser.add_argument('actions', nargs='*', choices=['build', 'test'],
-                        help='build: compile build tests, test: compile/run executable tests.')
+    parser.add_argument('--update-bench-ref', action='store_true',
+                        help='write the benchmark results as the new reference.')
+    parser.add_argument('actions', nargs='*', choices=['build', 'test', 'bench'],
+                        help='build: compile build tests, test: compile/run executable tests, '
+                        'bench: compile/run the replay benchmark and compare it with the reference.')
 
     args = parser.parse_args()
 
@@ -184,8 +309,12 @@ if __name__ == "__main__":
                 options_to_build = {**build_only_options, **test_options}
             else:
                 options_to_build = build_only_options
-        else:
+        elif 'test' in args.actions or not args.actions:
             options_to_build = test_options
+        else:
+            options_to_build = {}
+        if 'bench' in args.actions:
+            options_to_build = {**options_to_build, **bench_options}
 
     for opt in options_to_build:
         if not is_valid_option_name(opt):
@@ -196,8 +325,11 @@ if __name__ == "__main__":
 
     for options_name in options_to_build:
         is_test = options_name in test_options
-        build_type = 'Debug'
+        is_bench = options_name in bench_options
+        build_type = 'RelWithDebInfo' if is_bench else 'Debug'
         build_tests(options_name, build_type, args.clean)
+        if is_bench:
+            run_bench(options_name, args.update_bench_ref)
         if is_test:
             try:
                 run_tests(options_name)
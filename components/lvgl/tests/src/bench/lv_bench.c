@@ -0,0 +1,431 @@
+/**
+ * @file lv_bench.c
+ *
+ * Headless replay benchmark: runs a demo on a virtual display with a virtual tick
+ * and prints counters of the render pipeline as one JSON object.
+ * The counters only depend on the code, not on the machine, except `instructions` and `cycles`
+ * which are read from the perf counters of Linux when they are available.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../../lvgl.h"
+#include "../../../src/draw/sw/lv_draw_sw.h"
+#include "../../../demos/lv_demos.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_RES_MAX       (800 * 480)
+#define BENCH_DEF_MS        10000       /*Virtual run time of the demos without an end*/
+#define BENCH_TIMEOUT_MS    120000      /*The benchmark demo takes about 30 s*/
+#define BENCH_TAB_MS        2000        /*The widgets demo goes to the next tab this often*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    BENCH_DRAW_RECT,
+    BENCH_DRAW_BG,
+    BENCH_DRAW_ARC,
+    BENCH_DRAW_IMG,
+    BENCH_DRAW_LETTER,
+    BENCH_DRAW_LINE,
+    BENCH_DRAW_POLYGON,
+    _BENCH_DRAW_LAST
+} bench_draw_t;
+
+typedef struct {
+    uint32_t frames;
+    uint64_t flushes;
+    uint64_t flushed_px;
+    uint64_t blended_px;
+    uint64_t draw_calls[_BENCH_DRAW_LAST];
+    uint64_t mallocs;
+    uint64_t reallocs;
+    uint64_t frees;
+    uint64_t pixel_hash;
+} bench_counters_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void bench_draw_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx);
+static void bench_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void bench_refr_phase_cb(lv_disp_drv_t * drv, lv_disp_refr_phase_t phase, bool end, const lv_area_t * area);
+static void bench_finished_cb(void);
+static int perf_open(uint64_t config, int group_fd);
+static void print_json(const char * scene, uint32_t run_ms, int64_t instructions, int64_t cycles);
+
+void * __real_malloc(size_t size);
+void * __real_realloc(void * p, size_t size);
+void __real_free(void * p);
+void * __wrap_malloc(size_t size);
+void * __wrap_realloc(void * p, size_t size);
+void __wrap_free(void * p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char * draw_names[_BENCH_DRAW_LAST] = {
+    [BENCH_DRAW_RECT] = "rect",
+    [BENCH_DRAW_BG] = "bg",
+    [BENCH_DRAW_ARC] = "arc",
+    [BENCH_DRAW_IMG] = "img",
+    [BENCH_DRAW_LETTER] = "letter",
+    [BENCH_DRAW_LINE] = "line",
+    [BENCH_DRAW_POLYGON] = "polygon",
+};
+
+static lv_color_t draw_buf_1[BENCH_RES_MAX / 2];
+static lv_disp_drv_t disp_drv;
+static lv_draw_sw_ctx_t draw_ctx_ori;
+static bench_counters_t cnt;
+static bool counting;
+static bool demo_finished;
+
+/**********************
+ *      MACROS
+ **********************/
+#define COUNT_DRAW(type) if(counting) cnt.draw_calls[type]++
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char ** argv)
+{
+    const char * scene = "benchmark";
+    lv_coord_t hor_res = 800;
+    lv_coord_t ver_res = 480;
+    uint32_t run_ms = BENCH_DEF_MS;
+    uint32_t flush_cost = 0;
+    bool cull = false;
+    bool band = false;
+
+    int i;
+    for(i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            scene = argv[++i];
+        }
+        else if(strcmp(argv[i], "--res") == 0 && i + 1 < argc) {
+            int w = 0;
+            int h = 0;
+            if(sscanf(argv[++i], "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0 || w * h > BENCH_RES_MAX) {
+                fprintf(stderr, "resolution up to %d pixels expected, e.g. 95x28\n", BENCH_RES_MAX);
+                return 2;
+            }
+            hor_res = w;
+            ver_res = h;
+        }
+        else if(strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            run_ms = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--flush-cost") == 0 && i + 1 < argc) {
+            flush_cost = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--cull") == 0) {
+            cull = true;
+        }
+        else if(strcmp(argv[i], "--band") == 0) {
+            band = true;
+        }
+        else {
+            fprintf(stderr, "usage: %s [--scene benchmark|benchmark:N|widgets|stress] [--res WxH] [--ms N] "
+                    "[--flush-cost N] [--cull] [--band]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    lv_init();
+
+    /*Half screen stripes as on the PT6891*/
+    static lv_disp_draw_buf_t draw_buf;
+    lv_disp_draw_buf_init(&draw_buf, draw_buf_1, NULL, hor_res * ((ver_res + 1) / 2));
+
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = hor_res;
+    disp_drv.ver_res = ver_res;
+    disp_drv.draw_buf = &draw_buf;
+    disp_drv.flush_cb = bench_flush_cb;
+    disp_drv.refr_phase_cb = bench_refr_phase_cb;
+    disp_drv.draw_ctx_init = bench_draw_ctx_init;
+    disp_drv.draw_ctx_size = sizeof(lv_draw_sw_ctx_t);
+    disp_drv.flush_cost = flush_cost;
+    disp_drv.cull_occluded = cull;
+    disp_drv.band_refresh = band;
+    lv_disp_drv_register(&disp_drv);
+
+    /*The hardware counters are optional, e.g. not in most containers*/
+    int perf_instr = perf_open(PERF_COUNT_HW_INSTRUCTIONS, -1);
+    int perf_cycles = perf_instr >= 0 ? perf_open(PERF_COUNT_HW_CPU_CYCLES, perf_instr) : -1;
+    if(perf_instr >= 0) {
+        ioctl(perf_instr, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(perf_instr, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    /*Creating the demo is counted too: it is where most of the allocations are*/
+    cnt.pixel_hash = 0xcbf29ce484222325ULL;
+    counting = true;
+
+    bool endless = true;
+    if(strcmp(scene, "benchmark") == 0) {
+        lv_demo_benchmark_set_finished_cb(bench_finished_cb);
+        lv_demo_benchmark();
+        run_ms = BENCH_TIMEOUT_MS;
+        endless = false;
+    }
+    else if(strncmp(scene, "benchmark:", 10) == 0) {
+        /*One scene of the benchmark demo, numbered as in `lv_demo_benchmark_run_scene`. E.g. 2: rounded rectangles*/
+        lv_demo_benchmark_run_scene(atoi(scene + 10));
+    }
+    else if(strcmp(scene, "widgets") == 0) {
+        lv_demo_widgets();
+    }
+    else if(strcmp(scene, "stress") == 0) {
+        lv_demo_stress();
+    }
+    else {
+        fprintf(stderr, "unknown scene: %s\n", scene);
+        return 2;
+    }
+
+    lv_obj_t * tabview = lv_obj_get_child(lv_scr_act(), 0);
+    if(tabview && !lv_obj_check_type(tabview, &lv_tabview_class)) tabview = NULL;
+
+    uint32_t time_ms;
+    for(time_ms = 0; time_ms < run_ms && !demo_finished; time_ms++) {
+        if(tabview && time_ms % BENCH_TAB_MS == BENCH_TAB_MS - 1) {
+            lv_tabview_set_act(tabview, (lv_tabview_get_tab_act(tabview) + 1) % 3, LV_ANIM_ON);
+        }
+        lv_tick_inc(1);
+        lv_timer_handler();
+    }
+
+    counting = false;
+
+    int64_t instructions = -1;
+    int64_t cycles = -1;
+    if(perf_instr >= 0) {
+        ioctl(perf_instr, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t v;
+        if(read(perf_instr, &v, sizeof(v)) == sizeof(v)) instructions = v;
+        if(perf_cycles >= 0 && read(perf_cycles, &v, sizeof(v)) == sizeof(v)) cycles = v;
+    }
+
+    if(endless == false && demo_finished == false) {
+        fprintf(stderr, "the benchmark demo did not finish in %d ms\n", BENCH_TIMEOUT_MS);
+        return 1;
+    }
+
+    print_json(scene, time_ms, instructions, cycles);
+
+    return 0;
+}
+
+void lv_test_assert_fail(void)
+{
+    fprintf(stderr, "LVGL assert\n");
+    abort();
+}
+
+/*Linked with --wrap=malloc,--wrap=realloc,--wrap=free. LVGL uses the system heap (LV_MEM_CUSTOM).*/
+void * __wrap_malloc(size_t size)
+{
+    if(counting) cnt.mallocs++;
+    return __real_malloc(size);
+}
+
+void * __wrap_realloc(void * p, size_t size)
+{
+    if(counting) cnt.reallocs++;
+    return __real_realloc(p, size);
+}
+
+void __wrap_free(void * p)
+{
+    if(counting && p) cnt.frees++;
+    __real_free(p);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void count_draw_rect(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
+{
+    COUNT_DRAW(BENCH_DRAW_RECT);
+    draw_ctx_ori.base_draw.draw_rect(draw_ctx, dsc, coords);
+}
+
+static void count_draw_bg(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
+{
+    COUNT_DRAW(BENCH_DRAW_BG);
+    draw_ctx_ori.base_draw.draw_bg(draw_ctx, dsc, coords);
+}
+
+static void count_draw_arc(lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc, const lv_point_t * center,
+                           uint16_t radius, uint16_t start_angle, uint16_t end_angle)
+{
+    COUNT_DRAW(BENCH_DRAW_ARC);
+    draw_ctx_ori.base_draw.draw_arc(draw_ctx, dsc, center, radius, start_angle, end_angle);
+}
+
+static void count_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const lv_area_t * coords,
+                           const uint8_t * src_buf, lv_img_cf_t cf)
+{
+    COUNT_DRAW(BENCH_DRAW_IMG);
+    draw_ctx_ori.base_draw.draw_img_decoded(draw_ctx, dsc, coords, src_buf, cf);
+}
+
+static void count_draw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos_p,
+                              uint32_t letter)
+{
+    COUNT_DRAW(BENCH_DRAW_LETTER);
+    draw_ctx_ori.base_draw.draw_letter(draw_ctx, dsc, pos_p, letter);
+}
+
+static void count_draw_line(lv_draw_ctx_t * draw_ctx, const lv_draw_line_dsc_t * dsc, const lv_point_t * point1,
+                            const lv_point_t * point2)
+{
+    COUNT_DRAW(BENCH_DRAW_LINE);
+    draw_ctx_ori.base_draw.draw_line(draw_ctx, dsc, point1, point2);
+}
+
+static void count_draw_polygon(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_point_t * points,
+                               uint16_t point_cnt)
+{
+    COUNT_DRAW(BENCH_DRAW_POLYGON);
+    draw_ctx_ori.base_draw.draw_polygon(draw_ctx, dsc, points, point_cnt);
+}
+
+/*The software renderer with a counter in front of each draw call*/
+static void bench_draw_ctx_init(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+    draw_ctx_ori = *(lv_draw_sw_ctx_t *)draw_ctx;
+
+    draw_ctx->draw_rect = count_draw_rect;
+    draw_ctx->draw_bg = count_draw_bg;
+    draw_ctx->draw_arc = count_draw_arc;
+    draw_ctx->draw_img_decoded = count_draw_img;
+    draw_ctx->draw_letter = count_draw_letter;
+    draw_ctx->draw_line = count_draw_line;
+    draw_ctx->draw_polygon = count_draw_polygon;
+}
+
+static void bench_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    if(counting) {
+        uint32_t px = lv_area_get_size(area);
+        cnt.flushes++;
+        cnt.flushed_px += px;
+
+        /*FNV-1a of everything flushed, changes if a single pixel renders differently*/
+        const uint8_t * bytes = (const uint8_t *)color_p;
+        uint32_t i;
+        for(i = 0; i < px * sizeof(lv_color_t); i++) {
+            cnt.pixel_hash = (cnt.pixel_hash ^ bytes[i]) * 0x100000001b3ULL;
+        }
+    }
+
+    lv_disp_flush_ready(drv);
+}
+
+/*A frame is a refresh that flushed something. The demos take the `monitor_cb`.*/
+static void bench_refr_phase_cb(lv_disp_drv_t * drv, lv_disp_refr_phase_t phase, bool end, const lv_area_t * area)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(area);
+
+    if(phase != LV_DISP_REFR_PHASE_REFR || !end) return;
+
+    uint32_t drawn;
+    uint32_t flushed;
+    lv_refr_get_overdraw(&drawn, &flushed);
+    lv_refr_reset_overdraw_counter();
+    if(counting && flushed) {
+        cnt.frames++;
+        cnt.blended_px += drawn;
+    }
+}
+
+static void bench_finished_cb(void)
+{
+    demo_finished = true;
+}
+
+static int perf_open(uint64_t config, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group_fd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static void print_json(const char * scene, uint32_t run_ms, int64_t instructions, int64_t cycles)
+{
+    uint64_t draw_total = 0;
+    uint32_t i;
+    for(i = 0; i < _BENCH_DRAW_LAST; i++) draw_total += cnt.draw_calls[i];
+
+    printf("{\"scene\": \"%s\", \"hor_res\": %d, \"ver_res\": %d, \"color_depth\": %d, ", scene,
+           (int)disp_drv.hor_res, (int)disp_drv.ver_res, LV_COLOR_DEPTH);
+    printf("\"flush_cost\": %u, \"cull\": %s, \"band\": %s, \"run_ms\": %u, ", (unsigned)disp_drv.flush_cost,
+           disp_drv.cull_occluded ? "true" : "false", disp_drv.band_refresh ? "true" : "false", (unsigned)run_ms);
+    printf("\"frames\": %u, \"flushes\": %llu, \"flushed_px\": %llu, \"blended_px\": %llu, ", (unsigned)cnt.frames,
+           (unsigned long long)cnt.flushes, (unsigned long long)cnt.flushed_px, (unsigned long long)cnt.blended_px);
+    printf("\"draw_calls\": %llu, ", (unsigned long long)draw_total);
+    for(i = 0; i < _BENCH_DRAW_LAST; i++) {
+        printf("\"draw_%s\": %llu, ", draw_names[i], (unsigned long long)cnt.draw_calls[i]);
+    }
+    printf("\"mallocs\": %llu, \"reallocs\": %llu, \"frees\": %llu, ", (unsigned long long)cnt.mallocs,
+           (unsigned long long)cnt.reallocs, (unsigned long long)cnt.frees);
+    /*Radius masks and shadows which found or calculated their corners, letters which found or decompressed
+     *their bitmaps*/
+    uint32_t circle_hits = 0;
+    uint32_t circle_misses = 0;
+    uint32_t shadow_hits = 0;
+    uint32_t shadow_misses = 0;
+#if LV_DRAW_COMPLEX
+    lv_cache_list_stats_t circle_stats;
+    lv_draw_mask_get_circle_cache_stats(&circle_stats);
+    circle_hits = circle_stats.hits;
+    circle_misses = circle_stats.misses;
+    lv_cache_list_stats_t shadow_stats;
+    lv_draw_sw_shadow_get_cache_stats(&shadow_stats);
+    shadow_hits = shadow_stats.hits;
+    shadow_misses = shadow_stats.misses;
+#endif
+    uint32_t glyph_hits = 0;
+    uint32_t glyph_misses = 0;
+#if LV_USE_FONT_COMPRESSED
+    lv_cache_list_stats_t glyph_stats;
+    lv_font_fmt_txt_get_bitmap_cache_stats(&glyph_stats);
+    glyph_hits = glyph_stats.hits;
+    glyph_misses = glyph_stats.misses;
+#endif
+    printf("\"circle_hits\": %u, \"circle_misses\": %u, ", (unsigned)circle_hits, (unsigned)circle_misses);
+    printf("\"shadow_hits\": %u, \"shadow_misses\": %u, ", (unsigned)shadow_hits, (unsigned)shadow_misses);
+    printf("\"glyph_hits\": %u, \"glyph_misses\": %u, ", (unsigned)glyph_hits, (unsigned)glyph_misses);
+    printf("\"pixel_hash\": \"%016llx\", ", (unsigned long long)cnt.pixel_hash);
+    if(instructions >= 0) printf("\"instructions\": %lld, ", (long long)instructions);
+    else printf("\"instructions\": null, ");
+    if(cycles >= 0) printf("\"cycles\": %lld}\n", (long long)cycles);
+    else printf("\"cycles\": null}\n");
+}
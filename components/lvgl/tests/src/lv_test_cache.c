@@ -0,0 +1,44 @@
+#if LV_BUILD_TEST
+#include "lv_test_cache.h"
+#include "../unity/unity.h"
+
+static const lv_test_cache_t * act_cache;
+static lv_cache_list_stats_t start;
+
+void lv_test_cache_setup(const lv_test_cache_t * cache)
+{
+    act_cache = cache;
+    act_cache->free_cache();
+    act_cache->set_size(act_cache->def_size);
+    lv_test_cache_restart();
+}
+
+void lv_test_cache_teardown(void)
+{
+    act_cache->free_cache();
+    act_cache->set_size(act_cache->def_size);
+}
+
+void lv_test_cache_restart(void)
+{
+    act_cache->get_stats(&start);
+}
+
+void lv_test_cache_assert_stats(uint32_t hits, uint32_t misses, uint32_t evictions, uint32_t entries)
+{
+    lv_cache_list_stats_t stats;
+    act_cache->get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(hits, stats.hits - start.hits);
+    TEST_ASSERT_EQUAL_UINT32(misses, stats.misses - start.misses);
+    TEST_ASSERT_EQUAL_UINT32(evictions, stats.evictions - start.evictions);
+    TEST_ASSERT_EQUAL_UINT32(entries, stats.entries);
+}
+
+uint32_t lv_test_cache_get_size(void)
+{
+    lv_cache_list_stats_t stats;
+    act_cache->get_stats(&stats);
+    return stats.size;
+}
+
+#endif
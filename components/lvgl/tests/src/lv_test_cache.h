@@ -0,0 +1,35 @@
+
+#ifndef LV_TEST_CACHE_H
+#define LV_TEST_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../lvgl.h"
+
+/* The functions of a cache built on lv_cache_list */
+typedef struct {
+    void (*free_cache)(void);
+    void (*set_size)(uint32_t size);
+    void (*get_stats)(lv_cache_list_stats_t * stats);
+    uint32_t def_size;
+} lv_test_cache_t;
+
+/* Empty the cache, set its default size and restart counting, for setUp */
+void lv_test_cache_setup(const lv_test_cache_t * cache);
+/* Empty the cache and set its default size, for tearDown */
+void lv_test_cache_teardown(void);
+/* Restart counting the hits, misses and evictions */
+void lv_test_cache_restart(void);
+
+/* Check the counters since the last restart and the entries in the cache now */
+void lv_test_cache_assert_stats(uint32_t hits, uint32_t misses, uint32_t evictions, uint32_t entries);
+/* Bytes used by the entries in the cache now */
+uint32_t lv_test_cache_get_size(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_TEST_CACHE_H*/
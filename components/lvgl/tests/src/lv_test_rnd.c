@@ -0,0 +1,24 @@
+#if LV_BUILD_TEST
+#include "lv_test_rnd.h"
+
+static uint32_t state = 1;
+
+void lv_test_rnd_seed(uint32_t seed)
+{
+    state = seed;
+}
+
+uint32_t lv_test_rnd(void)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+int32_t lv_test_rnd_range(int32_t min, int32_t max)
+{
+    return min + (int32_t)(lv_test_rnd() % (uint32_t)(max - min + 1));
+}
+
+#endif
@@ -0,0 +1,22 @@
+
+#ifndef LV_TEST_RND_H
+#define LV_TEST_RND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Restart the pseudo random sequence, the same seed gives the same sequence. The seed must not be 0. */
+void lv_test_rnd_seed(uint32_t seed);
+/* The next value of the sequence (xorshift32) */
+uint32_t lv_test_rnd(void);
+/* A value in the [min, max] range */
+int32_t lv_test_rnd_range(int32_t min, int32_t max);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_TEST_RND_H*/
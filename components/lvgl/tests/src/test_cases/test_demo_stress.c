@@ -1,6 +1,7 @@
 #if LV_BUILD_TEST
 #include "../lvgl.h"
 #include "../demos/lv_demos.h"
+#include "../src/draw/sw/lv_draw_sw.h"
 
 #include "unity/unity.h"
 
@@ -15,6 +16,11 @@ static void loop_through_stress_test(void)
 }
 void test_demo_stress(void)
 {
+    /* The entries kept by the caches change how the heap is split between the loops */
+#if LV_DRAW_COMPLEX
+    lv_draw_mask_set_circle_cache_size(0);
+    lv_draw_sw_shadow_set_cache_size(0);
+#endif
 #if LV_USE_DEMO_STRESS
     lv_demo_stress();
 #endif
@@ -26,6 +32,10 @@ void test_demo_stress(void)
         loop_through_stress_test();
     }
     TEST_ASSERT_EQUAL(mem_before, lv_test_get_free_mem());
+#if LV_DRAW_COMPLEX
+    lv_draw_mask_set_circle_cache_size(LV_CIRCLE_CACHE_DEF_SIZE);
+    lv_draw_sw_shadow_set_cache_size(LV_SHADOW_CACHE_DEF_SIZE);
+#endif
 }
 
 #endif
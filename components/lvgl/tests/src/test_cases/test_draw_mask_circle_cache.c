@@ -0,0 +1,182 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_cache.h"
+
+#define LINE_W      64
+#define LINE_CNT    64
+#define RADIUS_MAX  14      /*The rectangles of the masks fit into LINE_W x LINE_CNT*/
+
+#if LV_DRAW_COMPLEX
+
+static void circle_cache_free(void)
+{
+    _lv_draw_mask_cleanup();
+}
+
+static const lv_test_cache_t circle_cache = {
+    .free_cache = circle_cache_free,
+    .set_size = lv_draw_mask_set_circle_cache_size,
+    .get_stats = lv_draw_mask_get_circle_cache_stats,
+    .def_size = LV_CIRCLE_CACHE_DEF_SIZE,
+};
+
+static void radius_init(lv_draw_mask_radius_param_t * param, lv_coord_t radius, bool inv)
+{
+    lv_area_t rect = {10, 10, 10 + 4 * radius, 10 + 4 * radius};
+    lv_draw_mask_radius_init(param, &rect, radius, inv);
+}
+
+/*Bytes of the cache used for the circle of a radius*/
+static uint32_t entry_size(lv_coord_t radius)
+{
+    uint32_t before = lv_test_cache_get_size();
+    lv_draw_mask_radius_param_t param;
+    radius_init(&param, radius, false);
+    lv_draw_mask_free_param(&param);
+    return lv_test_cache_get_size() - before;
+}
+
+static void mask_lines(lv_coord_t radius, bool inv, lv_opa_t * buf)
+{
+    lv_draw_mask_radius_param_t param;
+    radius_init(&param, radius, inv);
+    lv_memset_ff(buf, LINE_W * LINE_CNT);
+
+    lv_coord_t y;
+    for(y = 0; y < LINE_CNT; y++) {
+        param.dsc.cb(&buf[y * LINE_W], 0, y, LINE_W, &param);
+    }
+    lv_draw_mask_free_param(&param);
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_test_cache_setup(&circle_cache);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_test_cache_teardown();
+#endif
+}
+
+void test_draw_mask_circle_cache_hit(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_draw_mask_radius_param_t p1;
+    lv_draw_mask_radius_param_t p2;
+    lv_draw_mask_radius_param_t p3;
+    radius_init(&p1, 10, false);
+    radius_init(&p2, 10, true);     /*The inverted mask uses the same circle*/
+    radius_init(&p3, 12, false);
+    lv_test_cache_assert_stats(1, 2, 0, 2);
+    TEST_ASSERT_EQUAL_PTR(p1.circle, p2.circle);
+
+    lv_draw_mask_free_param(&p1);
+    lv_draw_mask_free_param(&p2);
+    lv_draw_mask_free_param(&p3);
+
+    /*Kept for the next refresh*/
+    radius_init(&p1, 12, false);
+    lv_draw_mask_free_param(&p1);
+    lv_test_cache_assert_stats(2, 2, 0, 2);
+#endif
+}
+
+void test_draw_mask_circle_cache_evicts_least_recently_used(void)
+{
+#if LV_DRAW_COMPLEX
+    uint32_t size_10 = entry_size(10);
+    uint32_t size = size_10 + entry_size(11) + entry_size(12);
+    _lv_draw_mask_cleanup();
+    lv_test_cache_restart();
+    lv_draw_mask_set_circle_cache_size(size - 1);
+
+    lv_draw_mask_radius_param_t param;
+    radius_init(&param, 10, false);
+    lv_draw_mask_free_param(&param);
+    radius_init(&param, 11, false);
+    lv_draw_mask_free_param(&param);
+    radius_init(&param, 10, false);
+    lv_draw_mask_free_param(&param);
+    lv_test_cache_assert_stats(1, 2, 0, 2);
+
+    /*11 was used before 10, it makes room for 12*/
+    radius_init(&param, 12, false);
+    lv_draw_mask_free_param(&param);
+    lv_test_cache_assert_stats(1, 3, 1, 2);
+
+    radius_init(&param, 10, false);
+    lv_draw_mask_free_param(&param);
+    lv_test_cache_assert_stats(2, 3, 1, 2);
+
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(size - 1, lv_test_cache_get_size());
+
+    /*A smaller cache keeps only the most recently used circle*/
+    lv_draw_mask_set_circle_cache_size(size_10);
+    lv_test_cache_assert_stats(2, 3, 2, 1);
+    radius_init(&param, 10, false);
+    lv_draw_mask_free_param(&param);
+    lv_test_cache_assert_stats(3, 3, 2, 1);
+#endif
+}
+
+void test_draw_mask_circle_cache_keeps_used_circles(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_draw_mask_set_circle_cache_size(entry_size(10));
+    _lv_draw_mask_cleanup();
+    lv_test_cache_restart();
+
+    lv_draw_mask_radius_param_t used;
+    radius_init(&used, 10, false);
+
+    /*The cache is full with a used circle, 8 is calculated only for its mask*/
+    lv_draw_mask_radius_param_t param;
+    radius_init(&param, 8, false);
+    lv_test_cache_assert_stats(0, 2, 0, 1);
+    lv_draw_mask_free_param(&param);
+
+    radius_init(&param, 10, false);
+    TEST_ASSERT_EQUAL_PTR(used.circle, param.circle);
+    lv_draw_mask_free_param(&param);
+    lv_draw_mask_free_param(&used);
+    lv_test_cache_assert_stats(1, 2, 0, 1);
+#endif
+}
+
+void test_draw_mask_circle_cache_same_mask(void)
+{
+#if LV_DRAW_COMPLEX
+    static lv_opa_t calculated[RADIUS_MAX][2][LINE_W * LINE_CNT];
+    static lv_opa_t cached[LINE_W * LINE_CNT];
+
+    lv_draw_mask_set_circle_cache_size(RADIUS_MAX * 1024);
+    lv_coord_t radius;
+    for(radius = 1; radius < RADIUS_MAX; radius++) {
+        _lv_draw_mask_cleanup();
+        mask_lines(radius, false, calculated[radius][0]);
+        mask_lines(radius, true, calculated[radius][1]);
+    }
+
+    /*The corners of the circles found in the cache are the same as the calculated ones*/
+    for(radius = 1; radius < RADIUS_MAX; radius++) mask_lines(radius, false, cached);
+    lv_test_cache_restart();
+    for(radius = RADIUS_MAX - 1; radius > 0; radius--) {
+        mask_lines(radius, false, cached);
+        TEST_ASSERT_EQUAL_MEMORY(calculated[radius][0], cached, sizeof(cached));
+        mask_lines(radius, true, cached);
+        TEST_ASSERT_EQUAL_MEMORY(calculated[radius][1], cached, sizeof(cached));
+    }
+    lv_test_cache_assert_stats(2 * (RADIUS_MAX - 1), 0, 0, RADIUS_MAX - 1);
+#endif
+}
+
+#endif
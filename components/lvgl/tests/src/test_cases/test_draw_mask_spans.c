@@ -0,0 +1,182 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+#include "lv_test_rnd.h"
+
+#define BUF_W       120
+#define MASK_W      (BUF_W + 32)    /*The mask line might be longer than the buffer*/
+#define FUZZ_CASES  20000
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#if LV_DRAW_COMPLEX
+
+static lv_color_t dest_mask[BUF_W];
+static lv_color_t dest_spans[BUF_W];
+static lv_color_t src[MASK_W];
+static lv_opa_t mask[MASK_W];
+
+/*Long transparent and covering runs with a few anti-aliased pixels as a rounded corner has*/
+static void rnd_mask(lv_opa_t * buf, int32_t len)
+{
+    int32_t i = 0;
+    while(i < len) {
+        int32_t run = lv_test_rnd() & 1 ? lv_test_rnd_range(1, 4) : lv_test_rnd_range(1, 40);
+        uint32_t kind = lv_test_rnd() % 3;
+        for(; run > 0 && i < len; run--, i++) {
+            if(kind == 0) buf[i] = LV_OPA_TRANSP;
+            else if(kind == 1) buf[i] = LV_OPA_COVER;
+            else buf[i] = (lv_opa_t)lv_test_rnd_range(1, 254);
+        }
+    }
+}
+
+static void set_run(lv_opa_t * buf, int32_t * i, int32_t len, lv_opa_t v)
+{
+    lv_memset(&buf[*i], v, len);
+    *i += len;
+}
+
+#endif
+
+void test_draw_mask_spans_encode(void)
+{
+#if LV_DRAW_COMPLEX
+    int32_t i = 0;
+    set_run(mask, &i, 20, LV_OPA_TRANSP);
+    set_run(mask, &i, 3, LV_OPA_50);
+    set_run(mask, &i, 30, LV_OPA_COVER);
+    set_run(mask, &i, 2, LV_OPA_70);
+    set_run(mask, &i, 4, LV_OPA_COVER);     /*Too short, part of the partial span*/
+    set_run(mask, &i, 1, LV_OPA_10);
+    set_run(mask, &i, 20, LV_OPA_TRANSP);
+
+    lv_draw_mask_spans_t spans;
+    TEST_ASSERT_EQUAL_UINT8(5, lv_draw_mask_get_spans(mask, i, &spans));
+    TEST_ASSERT_EQUAL_UINT8(5, spans.cnt);
+
+    static const lv_draw_mask_span_type_t types[] = {LV_DRAW_MASK_SPAN_TRANSP, LV_DRAW_MASK_SPAN_PARTIAL,
+                                                     LV_DRAW_MASK_SPAN_COVER, LV_DRAW_MASK_SPAN_PARTIAL,
+                                                     LV_DRAW_MASK_SPAN_TRANSP
+                                                    };
+    static const lv_coord_t lens[] = {20, 3, 30, 7, 20};
+    uint32_t s;
+    for(s = 0; s < spans.cnt; s++) {
+        TEST_ASSERT_EQUAL_UINT8(types[s], spans.span[s].type);
+        TEST_ASSERT_EQUAL_INT(lens[s], spans.span[s].len);
+    }
+
+    /*Starting at an unaligned address gives the same spans*/
+    int32_t j;
+    for(j = i; j > 0; j--) mask[j] = mask[j - 1];
+    TEST_ASSERT_EQUAL_UINT8(5, lv_draw_mask_get_spans(mask + 1, i, &spans));
+    TEST_ASSERT_EQUAL_INT(20, spans.span[0].len);
+    TEST_ASSERT_EQUAL_INT(30, spans.span[2].len);
+#endif
+}
+
+void test_draw_mask_spans_too_fragmented(void)
+{
+#if LV_DRAW_COMPLEX
+    /*Alternating runs of 8 need a span for each, more than LV_DRAW_MASK_SPAN_MAX*/
+    int32_t i;
+    for(i = 0; i < MASK_W; i++) mask[i] = (i / 8) & 1 ? LV_OPA_COVER : LV_OPA_TRANSP;
+
+    lv_draw_mask_spans_t spans;
+    TEST_ASSERT_EQUAL_UINT8(0, lv_draw_mask_get_spans(mask, MASK_W, &spans));
+    TEST_ASSERT_EQUAL_UINT8(0, spans.cnt);
+
+    TEST_ASSERT_EQUAL_UINT8(LV_DRAW_MASK_SPAN_MAX, lv_draw_mask_get_spans(mask, LV_DRAW_MASK_SPAN_MAX * 8, &spans));
+#endif
+}
+
+void test_draw_mask_spans_describe_the_mask(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_test_rnd_seed(0x9e3779b9);
+
+    uint32_t c;
+    for(c = 0; c < FUZZ_CASES; c++) {
+        int32_t len = lv_test_rnd_range(1, MASK_W);
+        rnd_mask(mask, len);
+
+        lv_draw_mask_spans_t spans;
+        if(lv_draw_mask_get_spans(mask, len, &spans) == 0) continue;
+
+        int32_t x = 0;
+        uint32_t s;
+        for(s = 0; s < spans.cnt; s++) {
+            if(spans.span[s].type != LV_DRAW_MASK_SPAN_PARTIAL) {
+                lv_opa_t v = spans.span[s].type == LV_DRAW_MASK_SPAN_COVER ? LV_OPA_COVER : LV_OPA_TRANSP;
+                TEST_ASSERT_GREATER_OR_EQUAL_INT(8, spans.span[s].len);
+                int32_t i;
+                for(i = x; i < x + spans.span[s].len; i++) TEST_ASSERT_EQUAL_UINT8(v, mask[i]);
+            }
+            x += spans.span[s].len;
+        }
+        TEST_ASSERT_EQUAL_INT(len, x);
+    }
+#endif
+}
+
+void test_draw_mask_spans_blend_as_the_mask(void)
+{
+#if LV_DRAW_COMPLEX
+    _lv_refr_set_disp_refreshing(lv_disp_get_default());
+    lv_test_rnd_seed(0x12345678);
+
+    uint32_t c;
+    for(c = 0; c < FUZZ_CASES; c++) {
+        uint32_t i;
+        for(i = 0; i < BUF_W; i++) dest_mask[i] = lv_color_hex(lv_test_rnd());
+        for(i = 0; i < MASK_W; i++) src[i] = lv_color_hex(lv_test_rnd());
+        lv_memcpy(dest_spans, dest_mask, sizeof(dest_mask));
+
+        /*The mask line might be clipped on both sides*/
+        lv_area_t buf_area = {0, 5, BUF_W - 1, 5};
+        lv_area_t mask_area = {lv_test_rnd_range(-10, BUF_W / 2), 5, 0, 5};
+        mask_area.x2 = lv_test_rnd_range(mask_area.x1, BUF_W + 10);
+        lv_area_t clip_area = {lv_test_rnd_range(0, 10), 5, lv_test_rnd_range(BUF_W - 10, BUF_W - 1), 5};
+        rnd_mask(mask, lv_area_get_width(&mask_area));
+
+        lv_draw_mask_spans_t spans;
+        lv_draw_mask_get_spans(mask, lv_area_get_width(&mask_area), &spans);
+
+        lv_draw_sw_blend_dsc_t dsc;
+        lv_memset_00(&dsc, sizeof(dsc));
+        dsc.blend_area = &mask_area;
+        dsc.mask_area = &mask_area;
+        dsc.mask_buf = mask;
+        dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+        dsc.src_buf = lv_test_rnd() & 1 ? src : NULL;
+        dsc.color = lv_color_hex(lv_test_rnd());
+        dsc.opa = lv_test_rnd() & 1 ? LV_OPA_COVER - (lv_test_rnd() & 3) : (lv_opa_t)lv_test_rnd();
+        dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+
+        lv_draw_sw_ctx_t ctx;
+        lv_memset_00(&ctx, sizeof(ctx));
+        ctx.base_draw.buf_area = &buf_area;
+        ctx.base_draw.clip_area = &clip_area;
+
+        ctx.base_draw.buf = dest_mask;
+        lv_draw_sw_blend_basic(&ctx.base_draw, &dsc);
+        ctx.base_draw.buf = dest_spans;
+        dsc.mask_spans = &spans;
+        lv_draw_sw_blend_basic(&ctx.base_draw, &dsc);
+
+        TEST_ASSERT_EQUAL_MEMORY(dest_mask, dest_spans, sizeof(dest_mask));
+    }
+
+    _lv_refr_set_disp_refreshing(NULL);
+#endif
+}
+
+#endif
@@ -0,0 +1,203 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../demos/lv_demos.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+#include "../src/draw/sw/lv_draw_sw_blend_simd.h"
+
+#include "unity/unity.h"
+#include "lv_test_rnd.h"
+
+#define BUF_W       96
+#define BUF_H       12
+#define FUZZ_CASES  50000
+#define SCR_PX      (800 * 480)
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+#if LV_DRAW_SW_SIMD
+
+extern lv_color_t test_fb[];
+
+static lv_color_t dest_c[BUF_W * BUF_H];
+static lv_color_t dest_simd[BUF_W * BUF_H];
+static lv_color_t src[BUF_W * BUF_H];
+static lv_opa_t mask[BUF_W * BUF_H];
+static lv_color_t frame_c[SCR_PX];
+
+/*Mostly the values where the rounding of the C code changes*/
+static lv_opa_t rnd_opa(void)
+{
+    static const lv_opa_t edges[] = {0, 1, 3, 4, 5, 11, 12, 127, 128, 243, 244, 247, 248, 251, 252, 253, 254, 255};
+    if(lv_test_rnd() & 1) return edges[lv_test_rnd() % (sizeof(edges) / sizeof(edges[0]))];
+    return (lv_opa_t)lv_test_rnd();
+}
+
+static lv_color_t rnd_color(void)
+{
+    switch(lv_test_rnd() % 4) {
+        case 0:
+            return lv_color_black();
+        case 1:
+            return lv_color_white();
+        default: {
+                lv_color_t c;
+                c.full = (uint16_t)lv_test_rnd();
+                return c;
+            }
+    }
+}
+
+/*Runs of transparent, covering and anti-aliased mask values*/
+static void rnd_mask(void)
+{
+    uint32_t i = 0;
+    while(i < sizeof(mask)) {
+        uint32_t run = lv_test_rnd_range(1, 20);
+        uint32_t kind = lv_test_rnd() % 4;
+        for(; run > 0 && i < sizeof(mask); run--, i++) {
+            if(kind == 0) mask[i] = LV_OPA_TRANSP;
+            else if(kind == 1) mask[i] = LV_OPA_COVER;
+            else mask[i] = rnd_opa();
+        }
+    }
+}
+
+static void rnd_area(lv_area_t * area, lv_coord_t x_ofs, lv_coord_t y_ofs)
+{
+    area->x1 = x_ofs + lv_test_rnd_range(-4, BUF_W - 1);
+    area->y1 = y_ofs + lv_test_rnd_range(-2, BUF_H - 1);
+    area->x2 = area->x1 + lv_test_rnd_range(0, BUF_W);
+    area->y2 = area->y1 + lv_test_rnd_range(0, BUF_H / 2);
+}
+
+/*Blend with the C code and with the SIMD code and compare the whole buffers*/
+static void blend_both(const lv_draw_sw_blend_dsc_t * dsc, const lv_area_t * buf_area, const lv_area_t * clip_area)
+{
+    lv_draw_sw_ctx_t ctx;
+    lv_memset_00(&ctx, sizeof(ctx));
+    ctx.base_draw.buf_area = buf_area;
+    ctx.base_draw.clip_area = clip_area;
+
+    ctx.base_draw.buf = dest_c;
+    lv_draw_sw_blend_basic_c(&ctx.base_draw, dsc);
+    ctx.base_draw.buf = dest_simd;
+    lv_draw_sw_blend_basic(&ctx.base_draw, dsc);
+
+    TEST_ASSERT_EQUAL_MEMORY(dest_c, dest_simd, sizeof(dest_c));
+}
+
+#endif
+
+void test_draw_sw_blend_simd_fuzz(void)
+{
+#if LV_DRAW_SW_SIMD
+    _lv_refr_set_disp_refreshing(lv_disp_get_default());
+    lv_test_rnd_seed(0x12345678);
+
+    uint32_t i;
+    for(i = 0; i < FUZZ_CASES; i++) {
+        uint32_t j;
+        for(j = 0; j < BUF_W * BUF_H; j++) {
+            dest_c[j] = rnd_color();
+            src[j] = rnd_color();
+        }
+        lv_memcpy(dest_simd, dest_c, sizeof(dest_c));
+        rnd_mask();
+
+        /*The buffer is somewhere on the screen, the blended area may be clipped on any side*/
+        lv_coord_t x_ofs = lv_test_rnd_range(0, 20);
+        lv_coord_t y_ofs = lv_test_rnd_range(0, 20);
+        lv_area_t buf_area = {x_ofs, y_ofs, x_ofs + BUF_W - 1, y_ofs + BUF_H - 1};
+        lv_area_t clip_area = buf_area;
+        if(lv_test_rnd() & 1) {
+            lv_area_t area;
+            rnd_area(&area, x_ofs, y_ofs);
+            if(!_lv_area_intersect(&clip_area, &area, &buf_area)) continue;
+        }
+
+        lv_area_t blend_area;
+        rnd_area(&blend_area, x_ofs, y_ofs);
+        lv_area_t mask_area = blend_area;
+
+        lv_draw_sw_blend_dsc_t dsc;
+        lv_memset_00(&dsc, sizeof(dsc));
+        dsc.blend_area = &blend_area;
+        dsc.src_buf = lv_test_rnd() & 1 ? src : NULL;
+        dsc.color = rnd_color();
+        dsc.opa = rnd_opa();
+        dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+        if(lv_test_rnd() % 3) {
+            dsc.mask_buf = mask;
+            dsc.mask_area = &mask_area;
+            dsc.mask_res = lv_test_rnd() % 4 ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+        }
+
+        blend_both(&dsc, &buf_area, &clip_area);
+    }
+
+    _lv_refr_set_disp_refreshing(NULL);
+#else
+    TEST_IGNORE_MESSAGE("LV_USE_DRAW_SW_SIMD has no SIMD code for this target or color format");
+#endif
+}
+
+void test_draw_sw_blend_simd_fill_opa_leading_black(void)
+{
+#if LV_DRAW_SW_SIMD
+    _lv_refr_set_disp_refreshing(lv_disp_get_default());
+
+    /*The C code mixes the black pixels before the first other color with `lv_color_mix`, the later ones with
+     *the premultiplied color. Here the black run goes on into the second row.*/
+    lv_area_t buf_area = {0, 0, BUF_W - 1, 1};
+    lv_area_t blend_area = buf_area;
+    lv_draw_sw_blend_dsc_t dsc;
+    lv_memset_00(&dsc, sizeof(dsc));
+    dsc.blend_area = &blend_area;
+    dsc.color = lv_palette_main(LV_PALETTE_BLUE);
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+
+    for(dsc.opa = 0; dsc.opa < LV_OPA_MAX; dsc.opa++) {
+        lv_memset_00(dest_c, sizeof(dest_c));
+        dest_c[BUF_W + 3] = lv_color_white();
+        lv_memcpy(dest_simd, dest_c, sizeof(dest_c));
+        blend_both(&dsc, &buf_area, &buf_area);
+    }
+
+    _lv_refr_set_disp_refreshing(NULL);
+#else
+    TEST_IGNORE_MESSAGE("LV_USE_DRAW_SW_SIMD has no SIMD code for this target or color format");
+#endif
+}
+
+void test_draw_sw_blend_simd_demo_widgets(void)
+{
+#if LV_DRAW_SW_SIMD && LV_USE_DEMO_WIDGETS
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_draw_sw_ctx_t * draw_ctx = (lv_draw_sw_ctx_t *)disp->driver->draw_ctx;
+    TEST_ASSERT_EQUAL_INT(SCR_PX, lv_disp_get_hor_res(disp) * lv_disp_get_ver_res(disp));
+
+    lv_demo_widgets();
+
+    draw_ctx->blend = lv_draw_sw_blend_basic_c;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(disp);
+    lv_memcpy(frame_c, test_fb, sizeof(frame_c));
+
+    draw_ctx->blend = lv_draw_sw_blend_basic;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_MEMORY(frame_c, test_fb, sizeof(frame_c));
+#else
+    TEST_IGNORE_MESSAGE("LV_USE_DRAW_SW_SIMD has no SIMD code for this target or color format");
+#endif
+}
+
+#endif
@@ -0,0 +1,190 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+#include "lv_test_cache.h"
+#include "lv_test_rnd.h"
+
+#define SCR_PX      (800 * 480)
+#define OBJ_CNT     40
+#define ROUNDS      15
+
+#if LV_DRAW_COMPLEX
+
+extern lv_color_t test_fb[];
+
+static lv_color_t frame_not_cached[SCR_PX];
+
+#if LV_MEM_CUSTOM == 0
+static void * heap_blocks[LV_MEM_SIZE / 1024];
+#endif
+
+static const lv_test_cache_t shadow_cache = {
+    .free_cache = lv_draw_sw_shadow_free_cache,
+    .set_size = lv_draw_sw_shadow_set_cache_size,
+    .get_stats = lv_draw_sw_shadow_get_cache_stats,
+    .def_size = LV_SHADOW_CACHE_DEF_SIZE,
+};
+
+static lv_obj_t * shadow_create(lv_coord_t w, lv_coord_t h, lv_coord_t radius, lv_coord_t shadow_width)
+{
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_set_style_radius(obj, radius, 0);
+    lv_obj_set_style_shadow_width(obj, shadow_width, 0);
+    lv_obj_set_style_shadow_opa(obj, LV_OPA_COVER, 0);
+    return obj;
+}
+
+static void refresh(void)
+{
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_test_cache_setup(&shadow_cache);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_obj_clean(lv_scr_act());
+    lv_test_cache_teardown();
+#endif
+}
+
+void test_draw_sw_shadow_cache_hit(void)
+{
+#if LV_DRAW_COMPLEX
+    /*On large enough rectangles the corner depends only on the shadow width and the radius*/
+    lv_obj_t * obj = shadow_create(100, 60, 10, 30);
+    lv_obj_set_pos(obj, 50, 50);
+    obj = shadow_create(200, 150, 10, 30);
+    lv_obj_set_pos(obj, 300, 50);
+    obj = shadow_create(100, 60, 10, 20);
+    lv_obj_set_pos(obj, 50, 300);
+    refresh();
+    lv_test_cache_assert_stats(1, 2, 0, 2);
+
+    /*Kept for the next refresh*/
+    refresh();
+    lv_test_cache_assert_stats(4, 2, 0, 2);
+#endif
+}
+
+void test_draw_sw_shadow_cache_evicts_least_recently_used(void)
+{
+#if LV_DRAW_COMPLEX
+    /*Room for the corners of 40 + 10 and 20 + 10 with their descriptors but not for 30 + 10 too*/
+    lv_draw_sw_shadow_set_cache_size(50 * 50 + 30 * 30 + 128);
+
+    lv_obj_t * obj1 = shadow_create(100, 100, 10, 40);
+    lv_obj_set_pos(obj1, 100, 100);
+    refresh();
+    lv_test_cache_assert_stats(0, 1, 0, 1);
+
+    lv_obj_t * obj2 = shadow_create(100, 100, 10, 20);
+    lv_obj_set_pos(obj2, 400, 100);
+    refresh();
+    lv_test_cache_assert_stats(1, 2, 0, 2);
+
+    /*30 + 10 evicts the least recently used 20 + 10 and then 40 + 10*/
+    lv_obj_set_style_shadow_width(obj2, 30, 0);
+    refresh();
+    lv_test_cache_assert_stats(2, 3, 2, 1);
+
+    /*A corner larger than the cache is not cached*/
+    lv_obj_del(obj1);
+    lv_obj_set_style_shadow_width(obj2, 80, 0);
+    refresh();
+    refresh();
+    lv_test_cache_assert_stats(2, 5, 2, 1);
+
+    lv_draw_sw_shadow_set_cache_size(0);
+    lv_test_cache_assert_stats(2, 5, 3, 0);
+#endif
+}
+
+void test_draw_sw_shadow_cache_gives_back_memory(void)
+{
+#if LV_DRAW_COMPLEX && LV_MEM_CUSTOM == 0
+    lv_obj_t * obj = shadow_create(100, 100, 10, 40);
+    lv_obj_set_pos(obj, 100, 100);
+    obj = shadow_create(100, 100, 10, 20);
+    lv_obj_set_pos(obj, 300, 100);
+    obj = shadow_create(100, 100, 10, 30);
+    lv_obj_set_pos(obj, 500, 100);
+    refresh();
+    lv_test_cache_assert_stats(0, 3, 0, 3);
+
+    /*When the heap is full the entries but the most recently used one are freed and the allocation is retried*/
+    uint32_t cnt;
+    for(cnt = 0; cnt < sizeof(heap_blocks) / sizeof(heap_blocks[0]); cnt++) {
+        heap_blocks[cnt] = lv_mem_alloc(1024);
+        if(heap_blocks[cnt] == NULL) break;
+    }
+    TEST_ASSERT_LESS_THAN_UINT32(sizeof(heap_blocks) / sizeof(heap_blocks[0]), cnt);
+    lv_test_cache_assert_stats(0, 3, 2, 1);
+
+    while(cnt > 0) {
+        cnt--;
+        lv_mem_free(heap_blocks[cnt]);
+    }
+#endif
+}
+
+void test_draw_sw_shadow_cache_same_pixels(void)
+{
+#if LV_DRAW_COMPLEX
+    lv_test_rnd_seed(0x2545f491);
+
+    uint32_t r;
+    for(r = 0; r < ROUNDS; r++) {
+        /*A few shadow widths and radii on many sizes. On the small rectangles the other corners
+         *of the blurred rectangle get into the corner buffer.*/
+        lv_coord_t shadow_widths[2] = {lv_test_rnd_range(1, 60), lv_test_rnd_range(1, 60)};
+        lv_coord_t radii[2] = {lv_test_rnd_range(0, 40), lv_test_rnd() % 4 ? lv_test_rnd_range(0, 40) : LV_RADIUS_CIRCLE};
+        uint32_t i;
+        for(i = 0; i < OBJ_CNT; i++) {
+            lv_obj_t * obj = shadow_create(lv_test_rnd_range(1, 120), lv_test_rnd_range(1, 120), radii[lv_test_rnd() & 1],
+                                           shadow_widths[lv_test_rnd() & 1]);
+            lv_obj_set_pos(obj, lv_test_rnd_range(0, 700), lv_test_rnd_range(0, 380));
+            lv_obj_set_style_shadow_spread(obj, lv_test_rnd_range(-5, 10), 0);
+            lv_obj_set_style_shadow_ofs_x(obj, lv_test_rnd_range(-10, 10), 0);
+            lv_obj_set_style_shadow_ofs_y(obj, lv_test_rnd_range(-10, 10), 0);
+            lv_obj_set_style_shadow_color(obj, lv_color_hex(lv_test_rnd()), 0);
+            lv_obj_set_style_bg_opa(obj, lv_test_rnd() & 1 ? LV_OPA_COVER : LV_OPA_TRANSP, 0);
+        }
+
+        lv_draw_sw_shadow_set_cache_size(0);
+        refresh();
+        lv_memcpy(frame_not_cached, test_fb, sizeof(frame_not_cached));
+
+        /*Blur the corners into the cache and draw them from there*/
+        lv_draw_sw_shadow_set_cache_size(1024 * 1024);
+        refresh();
+        TEST_ASSERT_EQUAL_MEMORY(frame_not_cached, test_fb, sizeof(frame_not_cached));
+
+        lv_cache_list_stats_t before;
+        lv_cache_list_stats_t after;
+        lv_draw_sw_shadow_get_cache_stats(&before);
+        refresh();
+        TEST_ASSERT_EQUAL_MEMORY(frame_not_cached, test_fb, sizeof(frame_not_cached));
+        lv_draw_sw_shadow_get_cache_stats(&after);
+        TEST_ASSERT_EQUAL_UINT32(before.misses, after.misses);
+        TEST_ASSERT_GREATER_THAN_UINT32(before.hits, after.hits);
+
+        lv_obj_clean(lv_scr_act());
+    }
+#endif
+}
+
+#endif
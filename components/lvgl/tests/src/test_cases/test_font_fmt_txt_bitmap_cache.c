@@ -0,0 +1,158 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_cache.h"
+
+#define LETTER_FIRST    0x20
+#define LETTER_LAST     0x7e
+#define BITMAP_MAX      (64 * 64)
+
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+
+static const lv_font_t * font = &lv_font_montserrat_28_compressed;
+
+static void bitmap_cache_free(void)
+{
+    lv_font_fmt_txt_free_bitmap_cache(NULL);
+}
+
+static const lv_test_cache_t bitmap_cache = {
+    .free_cache = bitmap_cache_free,
+    .set_size = lv_font_fmt_txt_set_bitmap_cache_size,
+    .get_stats = lv_font_fmt_txt_get_bitmap_cache_stats,
+    .def_size = LV_FONT_BITMAP_CACHE_DEF_SIZE,
+};
+
+/*Bytes of the cache used for the bitmap of a letter*/
+static uint32_t entry_size(uint32_t letter)
+{
+    uint32_t before = lv_test_cache_get_size();
+    lv_font_get_glyph_bitmap(font, letter);
+    return lv_test_cache_get_size() - before;
+}
+
+static uint32_t bitmap_size(uint32_t letter)
+{
+    lv_font_glyph_dsc_t g;
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(font, &g, letter, '\0'));
+    return ((uint32_t)g.box_w * g.box_h * (g.bpp == 3 ? 4 : g.bpp) + 7) / 8;
+}
+
+#endif
+
+void setUp(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    lv_test_cache_setup(&bitmap_cache);
+#endif
+}
+
+void tearDown(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    lv_test_cache_teardown();
+#endif
+}
+
+void test_font_fmt_txt_bitmap_cache_hit(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    const uint8_t * a = lv_font_get_glyph_bitmap(font, 'A');
+    lv_font_get_glyph_bitmap(font, 'B');
+    TEST_ASSERT_EQUAL_PTR(a, lv_font_get_glyph_bitmap(font, 'A'));
+    lv_test_cache_assert_stats(1, 2, 0, 2);
+
+    /*Kept for the next refresh*/
+    lv_refr_now(NULL);
+    lv_font_get_glyph_bitmap(font, 'B');
+    lv_test_cache_assert_stats(2, 2, 0, 2);
+
+    /*Letters without bitmap and not compressed fonts don't use the cache*/
+    TEST_ASSERT_NULL(lv_font_get_glyph_bitmap(font, ' '));
+    lv_font_get_glyph_bitmap(&lv_font_montserrat_14, 'A');
+    lv_test_cache_assert_stats(2, 2, 0, 2);
+#endif
+}
+
+void test_font_fmt_txt_bitmap_cache_evicts_least_recently_used(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    uint32_t size_a = entry_size('A');
+    uint32_t size = size_a + entry_size('B');
+    lv_font_fmt_txt_free_bitmap_cache(NULL);
+    lv_test_cache_restart();
+    lv_font_fmt_txt_set_bitmap_cache_size(size);
+
+    lv_font_get_glyph_bitmap(font, 'A');
+    lv_font_get_glyph_bitmap(font, 'B');
+    lv_font_get_glyph_bitmap(font, 'A');
+    lv_test_cache_assert_stats(1, 2, 0, 2);
+
+    /*B was used before A, it makes room for the narrower i*/
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(bitmap_size('B'), bitmap_size('i'));
+    lv_font_get_glyph_bitmap(font, 'i');
+    lv_test_cache_assert_stats(1, 3, 1, 2);
+    lv_font_get_glyph_bitmap(font, 'A');
+    lv_test_cache_assert_stats(2, 3, 1, 2);
+
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(size, lv_test_cache_get_size());
+
+    /*A bitmap larger than the cache is decompressed for every letter*/
+    lv_font_fmt_txt_set_bitmap_cache_size(size_a - 1);
+    lv_test_cache_assert_stats(2, 3, 3, 0);
+    lv_font_get_glyph_bitmap(font, 'A');
+    lv_font_get_glyph_bitmap(font, 'A');
+    lv_test_cache_assert_stats(2, 5, 3, 0);
+#endif
+}
+
+void test_font_fmt_txt_bitmap_cache_free_font(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    lv_font_get_glyph_bitmap(font, 'A');
+    lv_font_get_glyph_bitmap(font, 'B');
+
+    lv_font_fmt_txt_free_bitmap_cache(&lv_font_montserrat_14);
+    lv_test_cache_assert_stats(0, 2, 0, 2);
+    lv_font_fmt_txt_free_bitmap_cache(font);
+    lv_test_cache_assert_stats(0, 2, 0, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_test_cache_get_size());
+#endif
+}
+
+void test_font_fmt_txt_bitmap_cache_same_bitmap(void)
+{
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28_COMPRESSED
+    static uint8_t decompressed[LETTER_LAST - LETTER_FIRST + 1][BITMAP_MAX];
+
+    lv_font_fmt_txt_set_bitmap_cache_size(0);
+    uint32_t letter;
+    for(letter = LETTER_FIRST; letter <= LETTER_LAST; letter++) {
+        const uint8_t * bitmap = lv_font_get_glyph_bitmap(font, letter);
+        if(bitmap == NULL) continue;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(BITMAP_MAX, bitmap_size(letter));
+        lv_memcpy(decompressed[letter - LETTER_FIRST], bitmap, bitmap_size(letter));
+    }
+
+    /*Decompressed into the cache and found there*/
+    lv_font_fmt_txt_set_bitmap_cache_size(64 * 1024);
+    lv_test_cache_restart();
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        for(letter = LETTER_FIRST; letter <= LETTER_LAST; letter++) {
+            const uint8_t * bitmap = lv_font_get_glyph_bitmap(font, letter);
+            if(bitmap == NULL) continue;
+            TEST_ASSERT_EQUAL_MEMORY(decompressed[letter - LETTER_FIRST], bitmap, bitmap_size(letter));
+        }
+    }
+
+    /*Every bitmap is decompressed once and found once*/
+    lv_cache_list_stats_t stats;
+    lv_font_fmt_txt_get_bitmap_cache_stats(&stats);
+    lv_test_cache_assert_stats(stats.entries, stats.entries, 0, stats.entries);
+#endif
+}
+
+#endif
@@ -0,0 +1,256 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define TRACE_FLUSH_COST    64      /*Cost of one flush on a PT6891: 4 SPI transactions against RGB565 pixels*/
+#define TRACE_BENCH_ROUNDS  2000
+
+typedef struct {
+    const char * name;
+    const lv_area_t * areas;
+    uint32_t num;
+} inv_trace_t;
+
+/*Invalidations of single refreshes of lv_demo_benchmark on a 95x28 display (bench_flush of driver_pt6891)*/
+static const lv_area_t trace_text[] = {
+    {4, 20, 25, 27}, {4, 20, 26, 27}, {63, 23, 85, 27}, {63, 20, 85, 27}, {64, 27, 86, 27}, {46, 25, 69, 27},
+    {46, 21, 68, 27}, {6, 22, 28, 27}, {6, 21, 28, 27}, {6, 19, 28, 27}, {22, 25, 44, 27}, {69, 17, 81, 27},
+    {65, 17, 84, 27}, {65, 17, 85, 27}, {46, 21, 69, 27}, {46, 17, 68, 27},
+};
+
+static const lv_area_t trace_shadow[] = {
+    {2, 14, 28, 27}, {64, 15, 87, 27}, {70, 15, 92, 27}, {63, 18, 85, 27}, {61, 20, 85, 27}, {60, 19, 82, 27},
+    {46, 15, 76, 27}, {56, 16, 78, 27}, {13, 20, 30, 27}, {8, 18, 30, 27}, {9, 18, 31, 27}, {20, 16, 62, 27},
+    {65, 14, 85, 27}, {44, 20, 83, 27}, {20, 15, 62, 27},
+};
+
+static const lv_area_t trace_rect[] = {
+    {2, 20, 28, 27}, {63, 23, 77, 27}, {66, 23, 78, 27}, {42, 26, 58, 27}, {47, 26, 59, 27}, {56, 20, 81, 27},
+    {55, 20, 67, 27}, {4, 20, 34, 27}, {20, 20, 62, 27}, {65, 20, 85, 27}, {44, 15, 83, 27}, {44, 14, 83, 27},
+    {65, 19, 85, 27}, {4, 19, 34, 27},
+};
+
+/*More areas than LV_INV_BUF_SIZE: a 6x8 grid of 10x10 cells, e.g. blinking cursors or a keypad*/
+static lv_area_t trace_grid[48];
+
+static const inv_trace_t traces[] = {
+    {"text", trace_text, sizeof(trace_text) / sizeof(trace_text[0])},
+    {"shadow", trace_shadow, sizeof(trace_shadow) / sizeof(trace_shadow[0])},
+    {"rect", trace_rect, sizeof(trace_rect) / sizeof(trace_rect[0])},
+    {"grid", trace_grid, sizeof(trace_grid) / sizeof(trace_grid[0])},
+};
+
+static lv_disp_t * disp;
+static void (*flush_cb_ori)(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+static uint32_t flush_cnt;
+static uint32_t flush_px;
+
+static void count_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(color_p);
+
+    flush_cnt++;
+    flush_px += lv_area_get_size(area);
+    lv_disp_flush_ready(disp_drv);
+}
+
+void setUp(void)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(trace_grid) / sizeof(trace_grid[0]); i++) {
+        lv_area_set(&trace_grid[i], (i % 8) * 40, (i / 8) * 40, (i % 8) * 40 + 9, (i / 8) * 40 + 9);
+    }
+
+    disp = lv_disp_get_default();
+    lv_refr_now(disp);
+
+    flush_cb_ori = disp->driver->flush_cb;
+    disp->driver->flush_cb = count_flush_cb;
+    flush_cnt = 0;
+    flush_px = 0;
+}
+
+void tearDown(void)
+{
+    disp->driver->flush_cb = flush_cb_ori;
+    disp->driver->flush_cost = 0;
+    disp->driver->band_refresh = 0;
+    lv_obj_clean(lv_scr_act());
+}
+
+static void refr_trace(const inv_trace_t * trace, uint32_t flush_cost)
+{
+    uint32_t i;
+    disp->driver->flush_cost = flush_cost;
+    for(i = 0; i < trace->num; i++) {
+        _lv_inv_area(disp, &trace->areas[i]);
+    }
+
+    flush_cnt = 0;
+    flush_px = 0;
+    lv_refr_now(disp);
+}
+
+void test_inv_area_join_overlapping(void)
+{
+    lv_area_t a1 = {10, 10, 29, 29};
+    lv_area_t a2 = {15, 10, 34, 29};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(1, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(25 * 20, flush_px);
+}
+
+void test_inv_area_no_flush_cost_keeps_apart(void)
+{
+    lv_area_t a1 = {10, 10, 19, 19};
+    lv_area_t a2 = {25, 10, 34, 19};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2 * 10 * 10, flush_px);
+}
+
+void test_inv_area_flush_cost_joins_row_band(void)
+{
+    /*The 5 columns between the areas cost 50 pixels, less than a flush*/
+    lv_area_t a1 = {10, 10, 19, 19};
+    lv_area_t a2 = {25, 10, 34, 19};
+    disp->driver->flush_cost = TRACE_FLUSH_COST;
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(1, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(25 * 10, flush_px);
+
+    /*Far areas are still flushed one by one*/
+    lv_area_t a3 = {100, 10, 109, 19};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a3);
+    flush_cnt = 0;
+    flush_px = 0;
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2 * 10 * 10, flush_px);
+}
+
+void test_inv_area_full_buffer_coalesces(void)
+{
+    /*Stock LVGL redraws the whole 800x480 screen once LV_INV_BUF_SIZE is exceeded*/
+    refr_trace(&traces[3], 0);
+
+    TEST_ASSERT_EQUAL_UINT32(LV_INV_BUF_SIZE, flush_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(lv_disp_get_hor_res(disp) * lv_disp_get_ver_res(disp) / 10, flush_px);
+
+    /*Every cell is redrawn*/
+    uint32_t i;
+    for(i = 0; i < traces[3].num; i++) {
+        _lv_inv_area(disp, &trace_grid[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(LV_INV_BUF_SIZE, disp->inv_p);
+    for(i = 0; i < traces[3].num; i++) {
+        uint32_t j;
+        bool found = false;
+        for(j = 0; j < disp->inv_p; j++) {
+            if(_lv_area_is_in(&trace_grid[i], &disp->inv_areas[j], 0)) found = true;
+        }
+        TEST_ASSERT_TRUE(found);
+    }
+    _lv_inv_area(disp, NULL);
+}
+
+void test_inv_area_band_renders_overlap_once(void)
+{
+    /*Not joined: the union is larger than the two areas*/
+    lv_area_t a1 = {0, 0, 99, 9};
+    lv_area_t a2 = {50, 5, 149, 14};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2 * 100 * 10, flush_px);
+
+    /*Rows 0..14 in one band, the overlap is rendered once*/
+    disp->driver->band_refresh = 1;
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    flush_cnt = 0;
+    flush_px = 0;
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(1, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(150 * 15, flush_px);
+}
+
+void test_inv_area_band_split_by_flush_cost(void)
+{
+    /*Row 5 would add 250 pixels to rows 0..4, rows 10..14 only 50 each to rows 5..9*/
+    lv_area_t a1 = {0, 0, 99, 9};
+    lv_area_t a2 = {50, 5, 149, 14};
+    disp->driver->band_refresh = 1;
+    disp->driver->flush_cost = TRACE_FLUSH_COST;
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(100 * 5 + 150 * 10, flush_px);
+}
+
+void test_inv_area_band_ends_at_clean_row(void)
+{
+    lv_area_t a1 = {0, 0, 9, 9};
+    lv_area_t a2 = {0, 20, 9, 29};
+    disp->driver->band_refresh = 1;
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2 * 10 * 10, flush_px);
+}
+
+void test_inv_area_traces(void)
+{
+    uint32_t t;
+    for(t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        /*Flush cost 0 joins as stock LVGL, apart from the coalescing of a full buffer*/
+        refr_trace(&traces[t], 0);
+        uint32_t base_cnt = flush_cnt;
+        uint32_t base_cost = flush_px + flush_cnt * TRACE_FLUSH_COST;
+
+        refr_trace(&traces[t], TRACE_FLUSH_COST);
+        uint32_t cost = flush_px + flush_cnt * TRACE_FLUSH_COST;
+
+        /*Invalidation only, the join runs in the refresh*/
+        clock_t start = clock();
+        uint32_t r;
+        for(r = 0; r < TRACE_BENCH_ROUNDS; r++) {
+            uint32_t i;
+            for(i = 0; i < traces[t].num; i++) {
+                _lv_inv_area(disp, &traces[t].areas[i]);
+            }
+            _lv_inv_area(disp, NULL);
+        }
+        double us = (double)(clock() - start) * 1000000 / CLOCKS_PER_SEC / TRACE_BENCH_ROUNDS;
+
+        printf("%-8s %2u areas: %2u -> %2u flushes, cost %6u -> %6u pixels, %.2f us to invalidate\n",
+               traces[t].name, (unsigned)traces[t].num, (unsigned)base_cnt, (unsigned)flush_cnt,
+               (unsigned)base_cost, (unsigned)cost, us);
+
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(base_cost, cost);
+    }
+}
+
+#endif
@@ -0,0 +1,261 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../demos/lv_demos.h"
+
+#include "unity/unity.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define OBJ_MAX             2048
+#define LABEL_MAX           64
+#define LABEL_BENCH_ROUNDS  200
+
+static lv_area_t coords[OBJ_MAX];
+static uint32_t obj_cnt;
+static uint32_t layout_changed_cnt;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+static void save_coords(lv_obj_t * obj)
+{
+    TEST_ASSERT_LESS_THAN_UINT32(OBJ_MAX, obj_cnt);
+    coords[obj_cnt++] = obj->coords;
+
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        save_coords(lv_obj_get_child(obj, i));
+    }
+}
+
+static void compare_coords(lv_obj_t * obj)
+{
+    TEST_ASSERT_LESS_THAN_UINT32(OBJ_MAX, obj_cnt);
+    lv_area_t * a = &coords[obj_cnt++];
+    if(a->x1 != obj->coords.x1 || a->y1 != obj->coords.y1 || a->x2 != obj->coords.x2 || a->y2 != obj->coords.y2) {
+        TEST_FAIL_MESSAGE("the incremental layout differs from the full one");
+    }
+
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        compare_coords(lv_obj_get_child(obj, i));
+    }
+}
+
+static void mark_all(lv_obj_t * obj)
+{
+    lv_obj_mark_layout_as_dirty(obj);
+
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        mark_all(lv_obj_get_child(obj, i));
+    }
+}
+
+/*Update the layout from the last changes, then check that laying out everything again moves nothing*/
+static void assert_same_as_full_layout(void)
+{
+    lv_obj_t * scr = lv_scr_act();
+    lv_obj_update_layout(scr);
+    obj_cnt = 0;
+    save_coords(scr);
+
+    mark_all(scr);
+    lv_obj_update_layout(scr);
+    obj_cnt = 0;
+    compare_coords(scr);
+}
+
+static lv_obj_t * box_create(lv_obj_t * parent, lv_coord_t w, lv_coord_t h)
+{
+    lv_obj_t * obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_size(obj, w, h);
+    return obj;
+}
+
+static void layout_changed_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+    layout_changed_cnt++;
+}
+
+void test_layout_incremental_flex_wrap(void)
+{
+    lv_obj_t * cont = box_create(lv_scr_act(), 300, 400);
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_style_pad_row(cont, 5, 0);
+    lv_obj_set_style_pad_column(cont, 3, 0);
+
+    /*Labels change their size without a style change, which would lay out the whole container*/
+    lv_obj_t * items[30];
+    uint32_t i;
+    for(i = 0; i < 30; i++) {
+        items[i] = lv_label_create(cont);
+        lv_label_set_text_fmt(items[i], "%u", (unsigned)(i * 1111));
+    }
+    lv_obj_set_flex_grow(items[4], 1);
+    lv_obj_update_layout(cont);
+
+    /*Taller in its track, wider to wrap earlier, narrower to wrap later*/
+    lv_label_set_text(items[12], "two\nlines");
+    assert_same_as_full_layout();
+    lv_label_set_text(items[17], "a label wider than the others");
+    assert_same_as_full_layout();
+    lv_label_set_text(items[17], "1");
+    lv_label_set_text(items[25], "wider");
+    assert_same_as_full_layout();
+
+    /*A new item at the end and a hidden one in the middle*/
+    box_create(cont, 50, 50);
+    assert_same_as_full_layout();
+    lv_obj_add_flag(items[8], LV_OBJ_FLAG_HIDDEN);
+    assert_same_as_full_layout();
+}
+
+void test_layout_incremental_flex_column_content(void)
+{
+    /*Content sized, centered tracks, changes on the first and on the last item*/
+    lv_obj_t * cont = box_create(lv_scr_act(), LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(cont, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+
+    lv_obj_t * items[10];
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        items[i] = lv_label_create(cont);
+        lv_label_set_text_fmt(items[i], "item %u", (unsigned)i);
+    }
+    lv_obj_update_layout(cont);
+
+    lv_label_set_text(items[0], "the first item");
+    assert_same_as_full_layout();
+    lv_label_set_text(items[9], "the last item, long");
+    assert_same_as_full_layout();
+}
+
+void test_layout_incremental_grid(void)
+{
+    static const lv_coord_t col_dsc[] = {60, LV_GRID_FR(1), 80, LV_GRID_TEMPLATE_LAST};
+    static const lv_coord_t row_dsc[] = {30, 40, LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
+    static const lv_coord_t content_col_dsc[] = {LV_GRID_CONTENT, LV_GRID_FR(1), LV_GRID_TEMPLATE_LAST};
+
+    lv_obj_t * cont = box_create(lv_scr_act(), 400, 300);
+    lv_obj_set_grid_dsc_array(cont, col_dsc, row_dsc);
+
+    lv_obj_t * items[9];
+    uint32_t i;
+    for(i = 0; i < 9; i++) {
+        items[i] = lv_label_create(cont);
+        lv_label_set_text_fmt(items[i], "%u", (unsigned)i);
+        lv_obj_set_grid_cell(items[i], LV_GRID_ALIGN_CENTER, i % 3, 1, LV_GRID_ALIGN_END, i / 3, 1);
+    }
+    lv_obj_update_layout(cont);
+
+    lv_label_set_text(items[4], "the middle cell");
+    assert_same_as_full_layout();
+    lv_label_set_text(items[0], "first");
+    lv_label_set_text(items[7], "and one below");
+    assert_same_as_full_layout();
+
+    /*A content sized column moves the other cells*/
+    lv_obj_set_grid_dsc_array(cont, content_col_dsc, row_dsc);
+    for(i = 0; i < 9; i++) {
+        lv_obj_set_grid_cell(items[i], LV_GRID_ALIGN_START, i % 2, 1, LV_GRID_ALIGN_START, i / 3, 1);
+    }
+    lv_obj_update_layout(cont);
+    lv_label_set_text(items[6], "a longer text in the content column");
+    assert_same_as_full_layout();
+}
+
+void test_layout_incremental_skips_clean_subtrees(void)
+{
+    lv_obj_t * conts[3];
+    lv_obj_t * labels[3];
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        conts[i] = box_create(lv_scr_act(), 200, 100);
+        lv_obj_set_flex_flow(conts[i], LV_FLEX_FLOW_ROW);
+        lv_obj_add_event_cb(conts[i], layout_changed_cb, LV_EVENT_LAYOUT_CHANGED, NULL);
+        labels[i] = lv_label_create(conts[i]);
+        lv_label_create(conts[i]);
+    }
+    lv_obj_update_layout(lv_scr_act());
+
+    /*Only the container of the label is laid out again*/
+    layout_changed_cnt = 0;
+    lv_label_set_text(labels[1], "a new text");
+    lv_obj_update_layout(lv_scr_act());
+    TEST_ASSERT_EQUAL_UINT32(1, layout_changed_cnt);
+
+    TEST_ASSERT_FALSE(lv_scr_act()->tree_layout_inv);
+    TEST_ASSERT_FALSE(conts[1]->layout_children_inv);
+    TEST_ASSERT_EQUAL_UINT32(0, conts[1]->spec_attr->layout_inv_child_id);
+
+    layout_changed_cnt = 0;
+    lv_obj_update_layout(lv_scr_act());
+    TEST_ASSERT_EQUAL_UINT32(0, layout_changed_cnt);
+}
+
+#if LV_USE_DEMO_WIDGETS
+
+static void collect_labels(lv_obj_t * obj, lv_obj_t ** labels, uint32_t * label_cnt)
+{
+    if(*label_cnt < LABEL_MAX && lv_obj_check_type(obj, &lv_label_class) &&
+       lv_obj_get_style_layout(lv_obj_get_parent(obj), LV_PART_MAIN)) {
+        labels[(*label_cnt)++] = obj;
+    }
+
+    uint32_t i;
+    for(i = 0; i < lv_obj_get_child_cnt(obj); i++) {
+        collect_labels(lv_obj_get_child(obj, i), labels, label_cnt);
+    }
+}
+
+#endif
+
+void test_layout_incremental_demo_widgets(void)
+{
+#if LV_USE_DEMO_WIDGETS
+    lv_demo_widgets();
+    lv_obj_update_layout(lv_scr_act());
+
+    lv_obj_t * labels[LABEL_MAX];
+    uint32_t label_cnt = 0;
+    collect_labels(lv_scr_act(), labels, &label_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(10, label_cnt);
+
+    uint32_t i;
+    for(i = 0; i < label_cnt; i++) {
+        lv_label_set_text_fmt(labels[i], "%u", (unsigned)(i * 12345));
+        assert_same_as_full_layout();
+    }
+
+    /*Layout time of a frame where one label changed, as a value shown in the demo would.
+     *The best round of all the labels, the others are preempted more or less.*/
+    clock_t best_time = 0;
+    uint32_t r;
+    for(r = 0; r < LABEL_BENCH_ROUNDS; r++) {
+        clock_t round_time = 0;
+        for(i = 0; i < label_cnt; i++) {
+            lv_label_set_text(labels[i], r & 1 ? "12" : "1234");
+            clock_t start = clock();
+            lv_obj_update_layout(lv_scr_act());
+            round_time += clock() - start;
+        }
+        if(r == 0 || round_time < best_time) best_time = round_time;
+    }
+    double us = (double)best_time * 1000000 / CLOCKS_PER_SEC / label_cnt;
+
+    printf("demo_widgets %u labels: %.2f us layout per single label update\n", (unsigned)label_cnt, us);
+#endif
+}
+
+#endif
@@ -0,0 +1,166 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define AREA_W  200
+#define AREA_H  100
+
+extern lv_color_t test_fb[];
+
+static lv_disp_t * disp;
+static lv_color_t fb_plain[AREA_W * AREA_H];
+static lv_color_t fb_culled[AREA_W * AREA_H];
+
+void setUp(void)
+{
+    disp = lv_disp_get_default();
+    lv_obj_set_style_bg_opa(lv_scr_act(), LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_white(), 0);
+    lv_refr_now(disp);
+}
+
+void tearDown(void)
+{
+    disp->driver->cull_occluded = 0;
+    lv_obj_clean(lv_scr_act());
+}
+
+static lv_obj_t * rect_create(lv_obj_t * parent, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h,
+                              lv_color_t color)
+{
+    lv_obj_t * obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(obj, color, 0);
+    return obj;
+}
+
+/*Redraw the top left AREA_W x AREA_H pixels and return the pixels written*/
+static uint32_t render(bool cull, lv_color_t * fb)
+{
+    lv_area_t area = {0, 0, AREA_W - 1, AREA_H - 1};
+    disp->driver->cull_occluded = cull;
+    lv_refr_now(disp);
+    _lv_inv_area(disp, &area);
+    lv_refr_reset_overdraw_counter();
+    lv_refr_now(disp);
+
+    uint32_t drawn;
+    uint32_t flushed;
+    lv_refr_get_overdraw(&drawn, &flushed);
+    TEST_ASSERT_EQUAL_UINT32(AREA_W * AREA_H, flushed);
+
+    lv_memcpy(fb, test_fb, sizeof(fb_plain));
+    return drawn;
+}
+
+static void assert_same_pixels(void)
+{
+    uint32_t i;
+    for(i = 0; i < AREA_W * AREA_H; i++) {
+        if(fb_plain[i].full != fb_culled[i].full) {
+            TEST_FAIL_MESSAGE("the culled frame differs");
+        }
+    }
+}
+
+void test_occlusion_cuts_band_under_younger_sibling(void)
+{
+    /*The top half of `back` is under `front`*/
+    rect_create(lv_scr_act(), 0, 0, AREA_W, AREA_H, lv_palette_main(LV_PALETTE_RED));
+    rect_create(lv_scr_act(), 0, 0, AREA_W, AREA_H / 2, lv_palette_main(LV_PALETTE_BLUE));
+
+    uint32_t drawn_plain = render(false, fb_plain);
+    uint32_t drawn_culled = render(true, fb_culled);
+
+    TEST_ASSERT_EQUAL_UINT32(AREA_W * AREA_H * 3 / 2, drawn_plain);
+    TEST_ASSERT_EQUAL_UINT32(AREA_W * AREA_H, drawn_culled);
+    assert_same_pixels();
+}
+
+void test_occlusion_skips_hidden_subtree(void)
+{
+    /*`back` and its child are under `front`, the screen only shows on the right half*/
+    lv_obj_t * back = rect_create(lv_scr_act(), 0, 0, AREA_W / 2, AREA_H, lv_palette_main(LV_PALETTE_RED));
+    rect_create(back, 10, 10, 20, 20, lv_palette_main(LV_PALETTE_GREEN));
+    rect_create(lv_scr_act(), 0, 0, AREA_W / 2, AREA_H, lv_palette_main(LV_PALETTE_BLUE));
+
+    uint32_t drawn_plain = render(false, fb_plain);
+    uint32_t drawn_culled = render(true, fb_culled);
+
+    TEST_ASSERT_EQUAL_UINT32(AREA_W * AREA_H * 2 + 20 * 20, drawn_plain);
+    TEST_ASSERT_EQUAL_UINT32(AREA_W * AREA_H, drawn_culled);
+    assert_same_pixels();
+}
+
+void test_occlusion_parent_under_children(void)
+{
+    /*Two children cover the left and right of their parent, which is only drawn in the middle*/
+    lv_obj_t * parent = rect_create(lv_scr_act(), 0, 0, AREA_W, AREA_H, lv_palette_main(LV_PALETTE_RED));
+    rect_create(parent, 0, 0, 80, AREA_H, lv_palette_main(LV_PALETTE_GREEN));
+    rect_create(parent, AREA_W - 80, 0, 80, AREA_H, lv_palette_main(LV_PALETTE_BLUE));
+
+    uint32_t drawn_culled = render(true, fb_culled);
+    render(false, fb_plain);
+
+    TEST_ASSERT_EQUAL_UINT32(AREA_W * AREA_H, drawn_culled);
+    assert_same_pixels();
+}
+
+void test_occlusion_keeps_masked_and_transparent(void)
+{
+    /*Children clipped by a rounded corner, a translucent cover and a layer hide nothing*/
+    lv_obj_t * rounded = rect_create(lv_scr_act(), 0, 0, AREA_W / 2, AREA_H, lv_palette_main(LV_PALETTE_RED));
+    lv_obj_set_style_radius(rounded, 20, 0);
+    lv_obj_set_style_clip_corner(rounded, true, 0);
+    rect_create(rounded, 0, 0, AREA_W / 2, AREA_H, lv_palette_main(LV_PALETTE_GREEN));
+
+    lv_obj_t * translucent = rect_create(lv_scr_act(), AREA_W / 2, 0, AREA_W / 4, AREA_H,
+                                         lv_palette_main(LV_PALETTE_BLUE));
+    lv_obj_set_style_bg_opa(translucent, LV_OPA_50, 0);
+
+    lv_obj_t * layered = rect_create(lv_scr_act(), AREA_W * 3 / 4, 0, AREA_W / 4, AREA_H,
+                                     lv_palette_main(LV_PALETTE_ORANGE));
+    lv_obj_set_style_opa(layered, LV_OPA_70, 0);
+
+    render(false, fb_plain);
+    render(true, fb_culled);
+
+    assert_same_pixels();
+}
+
+void test_occlusion_younger_siblings_of_parents(void)
+{
+    /*`front` is drawn after the whole tree of `back`, which is cut where it is under it*/
+    lv_obj_t * back = rect_create(lv_scr_act(), 0, 0, AREA_W, AREA_H, lv_palette_main(LV_PALETTE_RED));
+    lv_obj_t * child = rect_create(back, 0, 0, AREA_W, AREA_H, lv_palette_main(LV_PALETTE_GREEN));
+    rect_create(child, 10, 10, 30, 30, lv_palette_main(LV_PALETTE_YELLOW));
+    rect_create(lv_scr_act(), 0, 0, AREA_W, AREA_H / 2, lv_palette_main(LV_PALETTE_BLUE));
+
+    uint32_t drawn_culled = render(true, fb_culled);
+    render(false, fb_plain);
+
+    /*`child` is the top object, only its bottom half is drawn, the yellow rectangle is under `front`*/
+    TEST_ASSERT_EQUAL_UINT32(AREA_W * AREA_H, drawn_culled);
+    assert_same_pixels();
+}
+
+void test_occlusion_keeps_transformed_area(void)
+{
+    /*The zoomed object draws out of its coordinates, the opaque sibling makes the culled path clip it*/
+    lv_obj_t * zoomed = rect_create(lv_scr_act(), 40, 30, 40, 20, lv_palette_main(LV_PALETTE_RED));
+    lv_obj_set_style_transform_pivot_x(zoomed, 20, 0);
+    lv_obj_set_style_transform_pivot_y(zoomed, 10, 0);
+    lv_obj_set_style_transform_zoom(zoomed, 512, 0);
+    rect_create(lv_scr_act(), AREA_W - 30, 0, 30, 30, lv_palette_main(LV_PALETTE_BLUE));
+
+    render(false, fb_plain);
+    render(true, fb_culled);
+
+    assert_same_pixels();
+}
+
+#endif
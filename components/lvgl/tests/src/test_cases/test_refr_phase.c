@@ -0,0 +1,114 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define EVENT_MAX   64
+
+typedef struct {
+    lv_disp_refr_phase_t phase;
+    bool end;
+    bool has_area;
+} phase_event_t;
+
+static lv_disp_t * disp;
+static phase_event_t events[EVENT_MAX];
+static uint32_t event_cnt;
+static uint32_t flush_cnt;
+static void (*flush_cb_ori)(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+
+static void phase_cb(lv_disp_drv_t * disp_drv, lv_disp_refr_phase_t phase, bool end, const lv_area_t * area)
+{
+    LV_UNUSED(disp_drv);
+
+    TEST_ASSERT_LESS_THAN_UINT32(EVENT_MAX, event_cnt);
+    events[event_cnt].phase = phase;
+    events[event_cnt].end = end;
+    events[event_cnt].has_area = area != NULL;
+    event_cnt++;
+}
+
+static void count_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(color_p);
+
+    flush_cnt++;
+    lv_disp_flush_ready(disp_drv);
+}
+
+void setUp(void)
+{
+    disp = lv_disp_get_default();
+    lv_refr_now(disp);
+
+    flush_cb_ori = disp->driver->flush_cb;
+    disp->driver->flush_cb = count_flush_cb;
+    disp->driver->refr_phase_cb = phase_cb;
+    event_cnt = 0;
+    flush_cnt = 0;
+}
+
+void tearDown(void)
+{
+    disp->driver->flush_cb = flush_cb_ori;
+    disp->driver->refr_phase_cb = NULL;
+    lv_obj_clean(lv_scr_act());
+}
+
+static uint32_t count_phase(lv_disp_refr_phase_t phase)
+{
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < event_cnt; i++) {
+        if(events[i].phase == phase && !events[i].end) cnt++;
+    }
+    return cnt;
+}
+
+void test_refr_phase_nested_in_refresh(void)
+{
+    lv_area_t a1 = {10, 10, 29, 29};
+    lv_area_t a2 = {200, 100, 219, 119};
+    _lv_inv_area(disp, &a1);
+    _lv_inv_area(disp, &a2);
+    lv_refr_now(disp);
+
+    /*Every phase ends before another one starts, inside the refresh*/
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2, event_cnt);
+    TEST_ASSERT_EQUAL(LV_DISP_REFR_PHASE_REFR, events[0].phase);
+    TEST_ASSERT_FALSE(events[0].end);
+    TEST_ASSERT_EQUAL(LV_DISP_REFR_PHASE_REFR, events[event_cnt - 1].phase);
+    TEST_ASSERT_TRUE(events[event_cnt - 1].end);
+
+    uint32_t i;
+    for(i = 1; i < event_cnt - 1; i += 2) {
+        TEST_ASSERT_NOT_EQUAL(LV_DISP_REFR_PHASE_REFR, events[i].phase);
+        TEST_ASSERT_FALSE(events[i].end);
+        TEST_ASSERT_EQUAL(events[i].phase, events[i + 1].phase);
+        TEST_ASSERT_TRUE(events[i + 1].end);
+
+        bool area_phase = events[i].phase == LV_DISP_REFR_PHASE_RENDER || events[i].phase == LV_DISP_REFR_PHASE_FLUSH;
+        TEST_ASSERT_EQUAL(area_phase, events[i].has_area);
+        TEST_ASSERT_EQUAL(area_phase, events[i + 1].has_area);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1, count_phase(LV_DISP_REFR_PHASE_LAYOUT));
+    TEST_ASSERT_EQUAL_UINT32(1, count_phase(LV_DISP_REFR_PHASE_JOIN));
+    TEST_ASSERT_EQUAL_UINT32(2, count_phase(LV_DISP_REFR_PHASE_RENDER));
+    TEST_ASSERT_EQUAL_UINT32(2, count_phase(LV_DISP_REFR_PHASE_FLUSH));
+    TEST_ASSERT_EQUAL_UINT32(2, flush_cnt);
+}
+
+void test_refr_phase_nothing_to_render(void)
+{
+    lv_refr_now(disp);
+
+    TEST_ASSERT_EQUAL_UINT32(1, count_phase(LV_DISP_REFR_PHASE_REFR));
+    TEST_ASSERT_EQUAL_UINT32(1, count_phase(LV_DISP_REFR_PHASE_LAYOUT));
+    TEST_ASSERT_EQUAL_UINT32(0, count_phase(LV_DISP_REFR_PHASE_RENDER));
+    TEST_ASSERT_EQUAL_UINT32(0, count_phase(LV_DISP_REFR_PHASE_FLUSH));
+    TEST_ASSERT_EQUAL_UINT32(0, flush_cnt);
+}
+
+#endif
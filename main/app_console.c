@@ -0,0 +1,137 @@
+#include "app_console.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_console.h"
+#include "esp_log.h"
+
+#include "service_display.h"
+
+#define CONSOLE_PROMPT              "oled>"
+#define CONSOLE_STREAM_PERIOD_MS    200     // New frames are printed this often while streaming
+#define CONSOLE_STREAM_BATCH        8       // Frames read under the LVGL lock at once
+#define CONSOLE_STREAM_STACK_SIZE   (3 * 1024)
+#define CONSOLE_STREAM_PRIORITY     1       // Below the LVGL task, printing never delays a frame
+#define CONSOLE_NOTIFY_INDEX        1       // Task notification stopping the stream and acknowledging it, index 0 is left to ESP-IDF
+
+static const char* TAG = "app_console";
+
+static TaskHandle_t stream_task = NULL;
+static TaskHandle_t stream_stopper = NULL;  // Task waiting for the stream to stop
+static uint32_t stream_seq = 0;             // Next frame to print, frames not read in time are counted as dropped
+
+static void perf_print_header(void) {
+    printf("seq,start_us,frame_us");
+    for (int phase = 0; phase < FRAME_PHASE_NUM; phase++) {
+        printf(",%s_us", frame_telemetry_phase_name(phase));
+    }
+    printf(",render_max_us,areas,rendered_px,drawn_px,heap_free,heap_min_free,lvgl_mem_used\n");
+}
+
+static void perf_print_record(const frame_record_t* record) {
+    printf("%"PRIu32",%"PRId64",%"PRIu32, record->seq, record->start_us, record->frame_us);
+    for (int phase = 0; phase < FRAME_PHASE_NUM; phase++) {
+        printf(",%"PRIu32, record->phase_us[phase]);
+    }
+    printf(",%"PRIu32",%u,%"PRIu32",%"PRIu32",%"PRIu32",%"PRIu32",%"PRIu32"\n",
+           record->render_max_us, record->areas, record->rendered_px, record->drawn_px,
+           record->heap_free, record->heap_min_free, record->gui_mem_used);
+}
+
+// Print the frames from *seq on, return the frames skipped because they were overwritten
+static uint32_t perf_print_from(uint32_t* seq) {
+    frame_record_t records[CONSOLE_STREAM_BATCH];
+    uint32_t dropped = 0;
+    size_t count;
+    do {
+        uint32_t first = *seq;
+        count = service_display_telemetry_read(seq, records, CONSOLE_STREAM_BATCH);
+        if (count) {
+            dropped += records[0].seq - first;
+        }
+        for (size_t i = 0; i < count; i++) {
+            perf_print_record(&records[i]);
+        }
+    } while (count == CONSOLE_STREAM_BATCH);
+
+    return dropped;
+}
+
+static void stream_task_main(void* arg) {
+    do {
+        uint32_t dropped = perf_print_from(&stream_seq);
+        if (dropped) {
+            ESP_LOGW(TAG, "perf: %"PRIu32" frames dropped, the console is too slow", dropped);
+        }
+    } while (ulTaskNotifyTakeIndexed(CONSOLE_NOTIFY_INDEX, pdTRUE, pdMS_TO_TICKS(CONSOLE_STREAM_PERIOD_MS)) == 0);
+
+    // Stopped between batches, the LVGL and stdout locks are not held
+    xTaskNotifyGiveIndexed(stream_stopper, CONSOLE_NOTIFY_INDEX);
+    vTaskDelete(NULL);
+}
+
+static int cmd_perf(int argc, char** argv) {
+    if (argc == 1) {
+        // Every frame still kept, the stream position is left alone
+        uint32_t seq = 0;
+        perf_print_header();
+        perf_print_from(&seq);
+        return 0;
+    }
+
+    if (argc == 3 && strcmp(argv[1], "stream") == 0) {
+        if (strcmp(argv[2], "on") == 0) {
+            if (stream_task) {
+                return 0;
+            }
+            // Only the frames from now on
+            frame_record_t records[CONSOLE_STREAM_BATCH];
+            stream_seq = 0;
+            while (service_display_telemetry_read(&stream_seq, records, CONSOLE_STREAM_BATCH) == CONSOLE_STREAM_BATCH) {
+            }
+            perf_print_header();
+            if (xTaskCreate(stream_task_main, "console_stream", CONSOLE_STREAM_STACK_SIZE, NULL, CONSOLE_STREAM_PRIORITY, &stream_task) != pdPASS) {
+                stream_task = NULL;
+                printf("perf: no memory for the stream task\n");
+                return 1;
+            }
+            return 0;
+        }
+        if (strcmp(argv[2], "off") == 0) {
+            if (stream_task) {
+                // The task ends itself, deleting it here could leave a lock taken
+                stream_stopper = xTaskGetCurrentTaskHandle();
+                xTaskNotifyGiveIndexed(stream_task, CONSOLE_NOTIFY_INDEX);
+                ulTaskNotifyTakeIndexed(CONSOLE_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+                stream_task = NULL;
+            }
+            return 0;
+        }
+    }
+
+    printf("usage: perf [stream on|off]\n");
+    return 1;
+}
+
+void app_console_main(void) {
+    esp_console_repl_t* repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    repl_config.prompt = CONSOLE_PROMPT;
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_console_new_repl_uart(&uart_config, &repl_config, &repl));
+
+    ESP_ERROR_CHECK(esp_console_register_help_command());
+    const esp_console_cmd_t perf_cmd = {
+        .command = "perf",
+        .help = "Print the frames recorded by the display service as CSV, or stream the new ones",
+        .hint = "[stream on|off]",
+        .func = cmd_perf,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&perf_cmd));
+
+    ESP_ERROR_CHECK(esp_console_start_repl(repl));
+}
@@ -5,7 +5,13 @@
 extern "C" {
 #endif
 
-
+/**
+ * @brief Start the console REPL on the default console UART
+ * 
+ * `perf` prints the frames recorded by service_display, `perf stream on` prints each new one as it comes.
+ * 
+ */
+void app_console_main(void);
 
 #ifdef __cplusplus
 }
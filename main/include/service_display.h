@@ -5,8 +5,58 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lvgl.h"
+#include "frame_telemetry.h"
+
 void service_display_main();
 
+bool lvgl_lock(int timeout_ms);
+void lvgl_unlock(void);
+
+/**
+ * @brief Scroll a label with the controller's graphic acceleration instead of LVGL animation
+ * 
+ * The whole panel rows covered by the label rotate, keep them static while scrolling.
+ * Falls back to LV_LABEL_LONG_SCROLL_CIRCULAR when the hardware can not do it.
+ * Call with the LVGL lock held.
+ * 
+ * @param label Label to scroll
+ * @param frame_interval Frames between two scroll steps
+ */
+void service_display_marquee_start(lv_obj_t* label, uint8_t frame_interval);
+
+/**
+ * @brief Stop the hardware marquee and redraw the label, call with the LVGL lock held
+ * 
+ */
+void service_display_marquee_stop(void);
+
+/**
+ * @brief Fade the panel brightness with an LVGL animation, call with the LVGL lock held
+ * 
+ * Only the segment current changes, nothing is rendered nor flushed while fading.
+ * 
+ * @param brightness Target brightness, 0 (off) to 255
+ * @param time_ms Duration of the fade, 0 to set it at once
+ */
+void service_display_fade(uint8_t brightness, uint32_t time_ms);
+
+/**
+ * @brief Copy the frames recorded by the LVGL task from a sequence number on, oldest first
+ * 
+ * Each frame holds the time LVGL spent in each phase of the refresh, the areas and pixels rendered, and the memory
+ * left once it is flushed. Frames are only recorded while LVGL_TELEMETRY is set.
+ * 
+ * @param seq In: first frame wanted, 0 for the oldest kept, out: the frame after the last one copied
+ * @param records Copies of the frames
+ * @param max_records Size of records
+ * @return size_t Frames copied
+ */
+size_t service_display_telemetry_read(uint32_t* seq, frame_record_t* records, size_t max_records);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -1,5 +1,7 @@
 #include "service_display.h"
+#include "app_console.h"
 
 void app_main(void){
     service_display_main();
+    app_console_main();
 }
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include "service_display.h"
 
+#include <inttypes.h>
+#include <string.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_timer.h"
+#include "esp_system.h"
 #include "driver/spi_master.h"
 #include "esp_lcd_panel_dev.h"
 #include "esp_lcd_panel_io.h"
@@ -13,6 +17,8 @@
 #include "lv_demos.h"
 
 #include "driver_pt6891.h"
+#include "flush_queue.h"
+#include "frame_telemetry.h"
 
 #define OLED_SPI_HOST SPI2_HOST
 
@@ -23,18 +29,40 @@
 #define OLED_PIN_MOSI 13
 #define OLED_PIN_DC 11
 #define OLED_PIN_RST 10
+#define OLED_PIN_INT -1 // INT (frame sync), -1 if not wired. Enables vsync aligned flushing when set.
 
 #define OLED_WIDTH 95
 #define OLED_HEIGHT 28
 
+#define OLED_BITS_PER_PIXEL 16  // 16 (RGB565), 6 (Mono 64 Gray) or 1 (Mono 2 Gray), LVGL renders RGB565 and flush converts
+#define OLED_MONO_DITHER    1   // Ordered dithering when converting to gray
+#define OLED_DELTA_FLUSH    0   // Only send pixels that changed since the last flush, color modes only
+
 #define OLED_CMD_BITS 8
 #define OLED_PARAM_BITS 8
 
-#define LVGL_TICK_PERIOD_MS    2
-#define LVGL_TASK_MAX_DELAY_MS 500
-#define LVGL_TASK_MIN_DELAY_MS 1
+#define LVGL_STRIPE_ROWS       (OLED_HEIGHT / 2)   // Rows of each draw buffer, one stripe renders while the other is on the wire
+#define LVGL_FLUSH_COST        64      // Pixels worth one flush: 4 addressed SPI transactions, invalidated areas closer than this are joined
+#define LVGL_BAND_REFRESH      0       // 1 renders the dirty rows band by band, each row once, instead of area by area
+#define LVGL_CULL_OCCLUDED     1       // Don't draw what opaque objects drawn later cover, the overdraw is logged with the stats
+#define LVGL_NOTIFY_INDEX      1       // Task notification waking the LVGL task, index 0 is used by pt6891_wait_vsync
+#define LVGL_FLUSH_TIMEOUT_MS  100     // Longest wait for a flush done while LVGL needs the buffer back
+#define LVGL_PORT_STATS_MS     10000   // Wakeups and frame latency are logged at the first wakeup after this long
+#define LVGL_TELEMETRY         1       // Record the phases of each frame for service_display_telemetry_read, 0 leaves LVGL without phase callback
 #define LVGL_TASK_STACK_SIZE   (4 * 1024)
 #define LVGL_TASK_PRIORITY     2
+#define LVGL_SPLIT_CORES       1       // Render on LVGL_RENDER_CORE and flush from a task on LVGL_FLUSH_CORE, 0 does both in the LVGL task
+#define LVGL_RENDER_CORE       1
+#define LVGL_FLUSH_CORE        0       // With app_main, the SPI and INT interrupts are installed there
+#define LVGL_FLUSH_TASK_PRIORITY 3     // Above the LVGL task, a stripe goes on the wire as soon as it is queued
+#define LVGL_VSYNC_TIMEOUT_MS  50
+#define LVGL_VSYNC_WARMUP      3
+#define LVGL_DELTA_STATS_MS    5000
+#define LVGL_FADE_IN_MS        300
+#define LVGL_IDLE_CLK_DIV_MS   5000    // No flush for this long divides the panel clock by 2, 0 disables the idle governor
+#define LVGL_IDLE_STEP_MS      2000    // Then by 4 and 8, one step each
+#define LVGL_IDLE_STANDBY_MS   30000   // Then standby, the display goes dark until the next flush
+#define LVGL_IDLE_LEVELS       5       // Clock divided by 1, 2, 4, 8, standby
 
 static const char* TAG = "service_display";
 
@@ -43,81 +71,565 @@ static lv_disp_draw_buf_t disp_draw_buf;
 static lv_disp_drv_t disp_drv;
 
 static SemaphoreHandle_t lvgl_mux = NULL;
-
-
-static bool notify_flush_ready(esp_lcd_panel_io_handle_t panel_io_handle, esp_lcd_panel_io_event_data_t* panel_io_event_data, void* user_ctx) {
+static TaskHandle_t lvgl_task = NULL;       // Sleeps until the next LVGL timer or a notification at LVGL_NOTIFY_INDEX
+static TaskHandle_t flush_task = NULL;      // Sends the stripes of flush_queue to the panel, LVGL_SPLIT_CORES only
+static flush_queue_t flush_queue;
+static TaskHandle_t flush_drain_task = NULL;    // Waits in flush_drain for the flush task to empty the queue
+static int64_t lvgl_tick_us = 0;            // esp_timer time already passed to lv_tick_inc
+
+static volatile bool flush_waiting = false;         // The LVGL task waits for a flush done to reuse the buffer
+static volatile bool flush_last_pending = false;    // The last area of a refresh is on the wire
+static volatile int64_t frame_wake_us = 0;          // Wakeup of the LVGL task that rendered the refresh on the wire
+
+// Since port_stats_start_us, written by the LVGL task and the flush done ISR
+static int64_t port_stats_start_us = 0;
+static uint32_t port_wakeups = 0;
+static volatile uint32_t port_frames = 0;
+static volatile int64_t port_latency_sum_us = 0;
+static volatile int64_t port_latency_max_us = 0;
+static int64_t port_wake_us = 0;                    // Last wakeup of the LVGL task
+static int64_t port_flush_wait_us = 0;              // Time the LVGL task waited for a draw buffer to come back
+static uint32_t port_drawn_px_start = 0;            // Overdraw counters at the start of the stats period
+static uint32_t port_flushed_px_start = 0;
+
+static frame_telemetry_t telemetry;                 // Frames rendered by LVGL, under the LVGL lock
+static uint32_t telemetry_drawn_px = 0;             // Overdraw counter at the start of the frame in progress
+
+static const frame_phase_t telemetry_phases[_LV_DISP_REFR_PHASE_LAST] = {
+    [LV_DISP_REFR_PHASE_LAYOUT] = FRAME_PHASE_LAYOUT,
+    [LV_DISP_REFR_PHASE_JOIN] = FRAME_PHASE_JOIN,
+    [LV_DISP_REFR_PHASE_RENDER] = FRAME_PHASE_RENDER,
+    [LV_DISP_REFR_PHASE_FLUSH_WAIT] = FRAME_PHASE_FLUSH_WAIT,
+    [LV_DISP_REFR_PHASE_FLUSH] = FRAME_PHASE_FLUSH,
+};
+
+static bool flush_vsync = false;            // Align the first RAMWR of each refresh to INT
+static bool flush_frame_started = false;    // Some areas of the current refresh are already sent
+
+static int64_t boot_start_us = 0;           // Start of panel_init, cleared once the first frame is flushed
+
+static lv_obj_t* marquee_label = NULL;
+
+static int32_t disp_brightness = 255;   // Brightness last set by the fade animation
+
+static int64_t last_flush_us = 0;                   // Last flush, the display is idle from there
+static int idle_level = 0;                          // Level set by the idle governor, 0 is full clock
+static int64_t idle_level_us[LVGL_IDLE_LEVELS];     // Time spent in each level since the display went idle
+static int64_t idle_level_start_us = 0;             // Entry of the current level
+
+static uint8_t* mono_buf = NULL;    // Gray pixels of the area being flushed, the driver copies them before draw_bitmap returns
+
+// 4x4 Bayer matrix, thresholds are taken at screen coordinates so partial flushes line up
+static const uint8_t dither_bayer4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5},
+};
+
+
+static bool notify_flush_ready(esp_lcd_panel_handle_t panel, void* user_ctx) {
     lv_disp_drv_t* disp_driver = (lv_disp_drv_t*) user_ctx;
     lv_disp_flush_ready(disp_driver);
 
-    return false;
+    if (flush_last_pending) {
+        // Frame latency: from the wakeup that rendered it to its last byte on the wire
+        flush_last_pending = false;
+        int64_t latency_us = esp_timer_get_time() - frame_wake_us;
+        port_frames++;
+        port_latency_sum_us += latency_us;
+        if (latency_us > port_latency_max_us) {
+            port_latency_max_us = latency_us;
+        }
+    }
+
+    // Delta flushing may report done from draw_bitmap itself, in the task that flushes
+    BaseType_t need_yield = pdFALSE;
+    if (flush_waiting) {
+        if (xPortInIsrContext()) {
+            vTaskNotifyGiveIndexedFromISR(lvgl_task, LVGL_NOTIFY_INDEX, &need_yield);
+        } else {
+            xTaskNotifyGiveIndexed(lvgl_task, LVGL_NOTIFY_INDEX);
+        }
+    }
+
+    return need_yield == pdTRUE;
+}
+
+static void flush_drain(void) {
+    // Other panel calls must not interleave with a draw_bitmap of the flush task
+    if (!LVGL_SPLIT_CORES) {
+        return;
+    }
+    flush_drain_task = xTaskGetCurrentTaskHandle();
+    while (!flush_queue_empty(&flush_queue)) {
+        ulTaskNotifyTakeIndexed(LVGL_NOTIFY_INDEX, pdTRUE, 1);
+    }
+    flush_drain_task = NULL;
+}
+
+static void idle_set_level(int level) {
+    flush_drain();
+    int64_t now_us = esp_timer_get_time();
+    idle_level_us[idle_level] += now_us - idle_level_start_us;
+    idle_level_start_us = now_us;
+
+    if (level == LVGL_IDLE_LEVELS - 1) {
+        // Blocks for one frame, the controller takes no command until standby starts
+        esp_lcd_panel_disp_sleep(panel_handle, true);
+    } else {
+        if (idle_level == LVGL_IDLE_LEVELS - 1) {
+            esp_lcd_panel_disp_sleep(panel_handle, false);
+            // A fade may have gone on in standby
+            pt6891_set_brightness(panel_handle, disp_brightness);
+        }
+        pt6891_set_clock_div(panel_handle, 1 << level);
+    }
+    idle_level = level;
+}
+
+static void idle_wake(void) {
+    int64_t start_us = esp_timer_get_time();
+    idle_set_level(0);
+    int64_t wake_us = esp_timer_get_time() - start_us;
+
+    // PWM clock cycles relative to staying at full clock, standby counts as none: a proxy of the panel current
+    int64_t idle_us = 0;
+    int64_t full_clock_us = 0;
+    for (int i = 0; i < LVGL_IDLE_LEVELS; i++) {
+        idle_us += idle_level_us[i];
+        if (i < LVGL_IDLE_LEVELS - 1) {
+            full_clock_us += idle_level_us[i] >> i;
+        }
+    }
+    ESP_LOGI(TAG, "LVGL: Wake in %"PRId64" us after %"PRId64" ms idle (%"PRId64" ms in standby), PWM clock at %"PRId64"%%",
+             wake_us, idle_us / 1000, idle_level_us[LVGL_IDLE_LEVELS - 1] / 1000, idle_us ? full_clock_us * 100 / idle_us : 100);
+    memset(idle_level_us, 0, sizeof(idle_level_us));
+}
+
+static void disp_convert_mono(const lv_area_t* area, const lv_color_t* color_p) {
+    int w = lv_area_get_width(area);
+    int h = lv_area_get_height(area);
+    int row_bytes = (w + 7) / 8;
+
+    if (OLED_BITS_PER_PIXEL == 1) {
+        memset(mono_buf, 0, row_bytes * h);
+    }
+
+    for (int y = 0; y < h; y++) {
+        const uint8_t* bayer_row = dither_bayer4[(area->y1 + y) & 0x03];
+        for (int x = 0; x < w; x++) {
+            uint8_t luma = lv_color_brightness(*color_p++);
+            uint8_t bayer = OLED_MONO_DITHER ? bayer_row[(area->x1 + x) & 0x03] : 0;
+
+            if (OLED_BITS_PER_PIXEL == 1) {
+                bool on = OLED_MONO_DITHER ? (luma > bayer * 16 + 8) : (luma > 127);
+                if (on) {
+                    mono_buf[y * row_bytes + x / 8] |= 0x80 >> (x % 8);
+                }
+            } else {
+                // 8 to 6 bits, the dither spreads the dropped 2 bits over the 4x4 tile
+                mono_buf[y * w + x] = LV_MIN(luma + (bayer >> 2), 255) >> 2;
+            }
+        }
+    }
+}
+
+static void disp_rounder(lv_disp_drv_t* drv, lv_area_t* area) {
+    // 2 Gray RAM is addressed 8 pixels at a time
+    int x1 = area->x1;
+    int x2 = area->x2;
+    pt6891_align_columns(panel_handle, &x1, &x2);
+    area->x1 = x1;
+    area->x2 = x2;
+}
+
+static void disp_flush_stripe(const flush_stripe_t* stripe) {
+    if (flush_vsync && !flush_frame_started) {
+        // Start writing right after the scan starts, the whole refresh lands before the scan reaches it
+        pt6891_wait_vsync(panel_handle, LVGL_VSYNC_TIMEOUT_MS);
+        flush_frame_started = true;
+    }
+    if (stripe->last) {
+        flush_frame_started = false;
+    }
+    if (OLED_BITS_PER_PIXEL < 16) {
+        lv_area_t area = {stripe->x_start, stripe->y_start, stripe->x_end, stripe->y_end};
+        disp_convert_mono(&area, stripe->data);
+        esp_lcd_panel_draw_bitmap(panel_handle, stripe->x_start, stripe->y_start, stripe->x_end, stripe->y_end, mono_buf);
+    } else {
+        esp_lcd_panel_draw_bitmap(panel_handle, stripe->x_start, stripe->y_start, stripe->x_end, stripe->y_end, stripe->data);
+    }
+}
+
+static void flush_task_main(void* arg) {
+    ESP_LOGI(TAG, "Starting flush task");
+    while (1) {
+        ulTaskNotifyTakeIndexed(LVGL_NOTIFY_INDEX, pdTRUE, portMAX_DELAY);
+
+        const flush_stripe_t* stripe;
+        while ((stripe = flush_queue_front(&flush_queue)) != NULL) {
+            disp_flush_stripe(stripe);
+            flush_queue_pop(&flush_queue);
+        }
+        TaskHandle_t drain_task = flush_drain_task;
+        if (drain_task) {
+            xTaskNotifyGiveIndexed(drain_task, LVGL_NOTIFY_INDEX);
+        }
+    }
 }
 
 static void disp_flush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color_p) {
     // ESP_LOGI(TAG, "flush %d %d %d %d", area->x1, area->y1, area->x2, area->y2);
-    esp_lcd_panel_draw_bitmap(panel_handle, area->x1, area->y1, area->x2, area->y2, color_p);
+    if (idle_level) {
+        idle_wake();
+    }
+    last_flush_us = esp_timer_get_time();
+    flush_stripe_t stripe = {area->x1, area->y1, area->x2, area->y2, color_p, lv_disp_flush_is_last(drv)};
+    if (stripe.last) {
+        frame_wake_us = port_wake_us;
+        flush_last_pending = true;
+        if (boot_start_us) {
+            ESP_LOGI(TAG, "LVGL: First frame %"PRId64" us after panel init start", esp_timer_get_time() - boot_start_us);
+            boot_start_us = 0;
+        }
+    }
+
+    if (!LVGL_SPLIT_CORES) {
+        disp_flush_stripe(&stripe);
+        return;
+    }
+    // Rendering goes on while the flush task sends the stripe, LVGL does not touch it until flush done
+    if (!flush_queue_push(&flush_queue, &stripe)) {
+        flush_drain();
+        flush_queue_push(&flush_queue, &stripe);
+    }
+    xTaskNotifyGiveIndexed(flush_task, LVGL_NOTIFY_INDEX);
+}
+
+static void delta_stats_timer_cb(lv_timer_t* timer) {
+    pt6891_delta_stats_t delta_stats;
+    if (pt6891_get_delta_stats(panel_handle, &delta_stats) == ESP_OK && delta_stats.bytes_in) {
+        ESP_LOGI(TAG, "LVGL: Delta flush sent %"PRIu64" of %"PRIu64" bytes (%"PRIu64"%%)", delta_stats.bytes_sent, delta_stats.bytes_in, delta_stats.bytes_sent * 100 / delta_stats.bytes_in);
+    }
 }
 
 static void lvgl_port_update_callback(lv_disp_drv_t *drv){
     esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t) drv->user_data;
+    flush_drain();
+
+    // Mirror (0, 1) is the natural orientation of this panel, swap is transposed by the driver
+    switch (drv->rotated) {
+    case LV_DISP_ROT_NONE:
+        esp_lcd_panel_swap_xy(panel_handle, false);
+        esp_lcd_panel_mirror(panel_handle, false, true);
+        break;
+    case LV_DISP_ROT_90:
+        esp_lcd_panel_swap_xy(panel_handle, true);
+        esp_lcd_panel_mirror(panel_handle, false, false);
+        break;
+    case LV_DISP_ROT_180:
+        esp_lcd_panel_swap_xy(panel_handle, false);
+        esp_lcd_panel_mirror(panel_handle, true, false);
+        break;
+    case LV_DISP_ROT_270:
+        esp_lcd_panel_swap_xy(panel_handle, true);
+        esp_lcd_panel_mirror(panel_handle, true, true);
+        break;
+    }
+}
 
-    // switch (drv->rotated) {
-    // case LV_DISP_ROT_NONE:
-    //     // Rotate LCD display
-    //     esp_lcd_panel_swap_xy(panel_handle, false);
-    //     esp_lcd_panel_mirror(panel_handle, true, false);
-    //     break;
-    // case LV_DISP_ROT_90:
-    //     // Rotate LCD display
-    //     esp_lcd_panel_swap_xy(panel_handle, true);
-    //     esp_lcd_panel_mirror(panel_handle, true, true);
-    //     break;
-    // case LV_DISP_ROT_180:
-    //     // Rotate LCD display
-    //     esp_lcd_panel_swap_xy(panel_handle, false);
-    //     esp_lcd_panel_mirror(panel_handle, false, true);
-    //     break;
-    // case LV_DISP_ROT_270:
-    //     // Rotate LCD display
-    //     esp_lcd_panel_swap_xy(panel_handle, true);
-    //     esp_lcd_panel_mirror(panel_handle, false, false);
-    //     break;
-    // }
+
+static void lvgl_tick_update(void) {
+    // No periodic tick interrupt, LVGL time catches up with esp_timer whenever it is used
+    int64_t elapsed_ms = (esp_timer_get_time() - lvgl_tick_us) / 1000;
+    if (elapsed_ms > 0) {
+        lv_tick_inc(elapsed_ms);
+        lvgl_tick_us += elapsed_ms * 1000;
+    }
 }
 
+static TickType_t lvgl_ms_to_ticks(uint32_t ms) {
+    // Round up, waking before the deadline would only run lv_timer_handler for nothing
+    return (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+}
 
-static void increase_lvgl_tick(void* arg) {
-    // ESP_LOGI(TAG, "Increase LVGL tick");
-    lv_tick_inc(2);
+static void lvgl_wait_flush(lv_disp_drv_t* drv) {
+    // Sleep until the flush done callback instead of spinning on the buffer
+    int64_t start_us = esp_timer_get_time();
+    flush_waiting = true;
+    if (drv->draw_buf->flushing) {
+        ulTaskNotifyTakeIndexed(LVGL_NOTIFY_INDEX, pdTRUE, lvgl_ms_to_ticks(LVGL_FLUSH_TIMEOUT_MS));
+    }
+    flush_waiting = false;
+    port_flush_wait_us += esp_timer_get_time() - start_us;
+    lvgl_tick_update();
 }
 
 bool lvgl_lock(int timeout_ms){
     // Convert timeout in milliseconds to FreeRTOS ticks
     // If `timeout_ms` is set to -1, the program will block until the condition is met
     const TickType_t timeout_ticks = (timeout_ms == -1) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
-    return xSemaphoreTakeRecursive(lvgl_mux, timeout_ticks) == pdTRUE;
+    if (xSemaphoreTakeRecursive(lvgl_mux, timeout_ticks) != pdTRUE) {
+        return false;
+    }
+    lvgl_tick_update();
+
+    return true;
 }
 
 void lvgl_unlock(void){
     xSemaphoreGiveRecursive(lvgl_mux);
+    // Another task may have changed the UI while the LVGL task sleeps
+    if (xTaskGetCurrentTaskHandle() != lvgl_task) {
+        xTaskNotifyGiveIndexed(lvgl_task, LVGL_NOTIFY_INDEX);
+    }
+}
+
+static void lvgl_refr_phase(lv_disp_drv_t* drv, lv_disp_refr_phase_t phase, bool end, const lv_area_t* area) {
+    int64_t now_us = esp_timer_get_time();
+    if (phase != LV_DISP_REFR_PHASE_REFR) {
+        if (end) {
+            frame_telemetry_phase_end(&telemetry, telemetry_phases[phase], now_us, area ? lv_area_get_size(area) : 0);
+        } else {
+            frame_telemetry_phase_begin(&telemetry, telemetry_phases[phase], now_us);
+        }
+        return;
+    }
+
+    uint32_t drawn_px;
+    lv_refr_get_overdraw(&drawn_px, NULL);
+    if (!end) {
+        frame_telemetry_begin(&telemetry, now_us);
+        telemetry_drawn_px = drawn_px;
+        return;
+    }
+
+    // Nothing rendered, the frame is dropped without walking the LVGL heap
+    frame_record_t* frame = frame_telemetry_current(&telemetry);
+    if (frame->areas) {
+        lv_mem_monitor_t mem_mon;
+        lv_mem_monitor(&mem_mon);
+        frame->drawn_px = drawn_px - telemetry_drawn_px;
+        frame->heap_free = esp_get_free_heap_size();
+        frame->heap_min_free = esp_get_minimum_free_heap_size();
+        frame->gui_mem_used = mem_mon.total_size - mem_mon.free_size;
+    }
+    frame_telemetry_end(&telemetry, now_us);
+}
+
+size_t service_display_telemetry_read(uint32_t* seq, frame_record_t* records, size_t max_records) {
+    // The UI does not change, lvgl_unlock would wake the LVGL task for nothing
+    size_t count = 0;
+    if (xSemaphoreTakeRecursive(lvgl_mux, portMAX_DELAY) == pdTRUE) {
+        count = frame_telemetry_read(&telemetry, seq, records, max_records);
+        xSemaphoreGiveRecursive(lvgl_mux);
+    }
+
+    return count;
+}
+
+static void lvgl_port_stats(void) {
+    int64_t now_us = esp_timer_get_time();
+    int64_t period_us = now_us - port_stats_start_us;
+    if (period_us < LVGL_PORT_STATS_MS * 1000LL) {
+        return;
+    }
+
+    uint32_t frames = port_frames;
+    uint32_t drawn_px;
+    uint32_t flushed_px;
+    lv_refr_get_overdraw(&drawn_px, &flushed_px);
+    uint32_t drawn = drawn_px - port_drawn_px_start;
+    uint32_t flushed = flushed_px - port_flushed_px_start;
+    ESP_LOGI(TAG, "LVGL: %"PRIu32".%02"PRIu32" wakeups/s, %"PRIu32" frames, latency avg %"PRId64" us max %"PRId64" us, flush wait %"PRId64" us/frame, overdraw %"PRIu32"%%",
+             (uint32_t) (port_wakeups * 1000000LL / period_us), (uint32_t) (port_wakeups * 100000000LL / period_us % 100),
+             frames, frames ? port_latency_sum_us / frames : 0, port_latency_max_us, frames ? port_flush_wait_us / frames : 0,
+             flushed ? (uint32_t) ((uint64_t) drawn * 100 / flushed) : 0);
+
+    port_stats_start_us = now_us;
+    port_wakeups = 0;
+    port_frames = 0;
+    port_latency_sum_us = 0;
+    port_latency_max_us = 0;
+    port_flush_wait_us = 0;
+    port_drawn_px_start = drawn_px;
+    port_flushed_px_start = flushed_px;
+}
+
+/**
+ * @brief Step the panel down while nothing is flushed
+ * 
+ * @param task_delay_ms Time until the next LVGL timer
+ * @return uint32_t Time until the next LVGL timer or governor step, LV_NO_TIMER_READY if none
+ */
+static uint32_t idle_governor(uint32_t task_delay_ms) {
+    if (!LVGL_IDLE_CLK_DIV_MS) {
+        return task_delay_ms;
+    }
+
+    // The hardware marquee keeps the panel busy without flushing
+    uint32_t idle_ms = 0;
+    if (marquee_label == NULL) {
+        idle_ms = LV_MIN((esp_timer_get_time() - last_flush_us) / 1000, lv_disp_get_inactive_time(NULL));
+    }
+
+    const uint32_t level_ms[LVGL_IDLE_LEVELS] = {
+        0,
+        LVGL_IDLE_CLK_DIV_MS,
+        LVGL_IDLE_CLK_DIV_MS + LVGL_IDLE_STEP_MS,
+        LVGL_IDLE_CLK_DIV_MS + LVGL_IDLE_STEP_MS * 2,
+        LVGL_IDLE_STANDBY_MS,
+    };
+    int level = idle_level;
+    while (level < LVGL_IDLE_LEVELS - 1 && idle_ms >= level_ms[level + 1]) {
+        level++;
+    }
+    if (level > idle_level) {
+        if (idle_level == 0) {
+            // Idle since the last flush, at full clock until now
+            idle_level_start_us = last_flush_us;
+        }
+        idle_set_level(level);
+    }
+
+    if (level < LVGL_IDLE_LEVELS - 1) {
+        task_delay_ms = LV_MIN(task_delay_ms, level_ms[level + 1] - idle_ms);
+    }
+
+    return task_delay_ms;
 }
 
 static void lvgl_port_task(void* arg){
     ESP_LOGI(TAG, "Starting LVGL task");
-    uint32_t task_delay_ms = 1;
+    uint32_t task_delay_ms = 0;
+    port_stats_start_us = esp_timer_get_time();
     while (1) {
+        port_wake_us = esp_timer_get_time();
+        port_wakeups++;
         // Lock the mutex due to the LVGL APIs are not thread-safe
         if (lvgl_lock(-1)) {
             task_delay_ms = lv_timer_handler();
+            task_delay_ms = idle_governor(task_delay_ms);
             // Release the mutex
             lvgl_unlock();
         }
-        if (task_delay_ms > LVGL_TASK_MAX_DELAY_MS) {
-            task_delay_ms = LVGL_TASK_MAX_DELAY_MS;
-        } else if (task_delay_ms < LVGL_TASK_MIN_DELAY_MS) {
-            task_delay_ms = LVGL_TASK_MIN_DELAY_MS;
+        lvgl_port_stats();
+
+        // Sleep until the next LVGL timer, or for good when none is running, other tasks and flush done notify
+        TickType_t wait_ticks = (task_delay_ms == LV_NO_TIMER_READY) ? portMAX_DELAY : lvgl_ms_to_ticks(task_delay_ms);
+        ulTaskNotifyTakeIndexed(LVGL_NOTIFY_INDEX, pdTRUE, wait_ticks);
+    }
+}
+
+static void marquee_stop(bool redraw) {
+    if (marquee_label == NULL) {
+        return;
+    }
+
+    flush_drain();
+    pt6891_scroll_stop(panel_handle);
+    if (redraw) {
+        // Frame buffer keeps the rotated rows, let LVGL draw the label in place again
+        lv_obj_invalidate(marquee_label);
+    }
+    marquee_label = NULL;
+}
+
+static void marquee_label_delete_cb(lv_event_t* e) {
+    marquee_stop(false);
+}
+
+void service_display_marquee_start(lv_obj_t* label, uint8_t frame_interval) {
+    service_display_marquee_stop();
+
+    lv_disp_t* disp = lv_obj_get_disp(label);
+    lv_disp_rot_t rotation = lv_disp_get_rotation(disp);
+
+    // Stop LVGL's own scroll animation, the label is drawn once and the controller rotates it
+    lv_label_set_long_mode(label, LV_LABEL_LONG_CLIP);
+    lv_obj_update_layout(label);
+    lv_refr_now(disp);
+
+    lv_area_t coords;
+    lv_obj_get_coords(label, &coords);
+
+    pt6891_scroll_config_t scroll_config = {
+        .mode = PT6891_SCROLL_HORIZONTAL,
+        .left_to_right = false,
+        .row_start = LV_MAX(coords.y1, 0),
+        .row_end = LV_MIN(coords.y2, OLED_HEIGHT - 1),
+        .frame_interval = frame_interval,
+    };
+
+    // Scroll window is in panel rows, fall back to LVGL when rotated or not possible
+    flush_drain();
+    if (rotation == LV_DISP_ROT_90 || rotation == LV_DISP_ROT_270 || pt6891_scroll_start(panel_handle, &scroll_config) != ESP_OK) {
+        ESP_LOGW(TAG, "Hardware marquee unavailable, use LVGL scroll");
+        lv_label_set_long_mode(label, LV_LABEL_LONG_SCROLL_CIRCULAR);
+        return;
+    }
+
+    marquee_label = label;
+    lv_obj_add_event_cb(label, marquee_label_delete_cb, LV_EVENT_DELETE, NULL);
+}
+
+void service_display_marquee_stop(void) {
+    if (marquee_label) {
+        lv_obj_remove_event_cb(marquee_label, marquee_label_delete_cb);
+    }
+    marquee_stop(true);
+}
+
+static void fade_anim_cb(void* var, int32_t value) {
+    // Animation steps that round to the same level are not sent by the driver
+    disp_brightness = value;
+    // Fades don't flush, the governor may put the panel into standby meanwhile. Waking up applies the level.
+    if (idle_level == LVGL_IDLE_LEVELS - 1) {
+        return;
+    }
+    flush_drain();
+    pt6891_set_brightness(panel_handle, value);
+}
+
+void service_display_fade(uint8_t brightness, uint32_t time_ms) {
+    lv_anim_del(&disp_brightness, fade_anim_cb);
+
+    if (time_ms == 0) {
+        fade_anim_cb(&disp_brightness, brightness);
+        return;
+    }
+
+    lv_anim_t anim;
+    lv_anim_init(&anim);
+    lv_anim_set_var(&anim, &disp_brightness);
+    lv_anim_set_exec_cb(&anim, fade_anim_cb);
+    lv_anim_set_values(&anim, disp_brightness, brightness);
+    lv_anim_set_time(&anim, time_ms);
+    lv_anim_set_path_cb(&anim, lv_anim_path_ease_in_out);
+    lv_anim_start(&anim);
+}
+
+static void lvgl_vsync_init(lv_disp_t* disp) {
+    // Let a few frames pass so the driver has measured the frame period
+    for (int i = 0; i < LVGL_VSYNC_WARMUP; i++) {
+        if (pt6891_wait_vsync(panel_handle, LVGL_VSYNC_TIMEOUT_MS) != ESP_OK) {
+            ESP_LOGW(TAG, "LVGL: No frame sync, keep timer driven refresh");
+            return;
         }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms));
     }
+
+    uint32_t period_us = 0;
+    if (pt6891_get_frame_period(panel_handle, &period_us) != ESP_OK) {
+        return;
+    }
+
+    // Round down, the refresh timer fires a little early and disp_flush waits for the frame start
+    uint32_t period_ms = LV_MAX(period_us / 1000, 1);
+    lv_timer_set_period(_lv_disp_get_refr_timer(disp), period_ms);
+    flush_vsync = true;
+
+    ESP_LOGI(TAG, "LVGL: Refresh locked to frame sync, %"PRIu32" us", period_us);
 }
 
 void panel_init() {
@@ -140,22 +652,29 @@ void panel_init() {
         .spi_mode = 0,
         .pclk_hz = OLED_CLOCK_HZ,
         .trans_queue_depth = 10,
-        .on_color_trans_done = notify_flush_ready,
-        // .on_color_trans_done = NULL,
-        .user_ctx = &disp_drv,
+        // Flush done is reported by the panel driver, once per draw_bitmap
+        .on_color_trans_done = NULL,
         .lcd_cmd_bits = OLED_CMD_BITS,
         .lcd_param_bits = OLED_PARAM_BITS,
     };
     ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)OLED_SPI_HOST, &panel_io_spi_config, &panel_io_handle));
 
     ESP_LOGI(TAG, "Panel: Install Panel Driver");
+    pt6891_oled_vendor_init_t vendor_config = {
+        .init_cmds = NULL,
+        .int_gpio_num = OLED_PIN_INT,
+        .flags.delta_flush = OLED_DELTA_FLUSH,
+        .flags.use_int = OLED_PIN_INT > -1,
+    };
     esp_lcd_panel_dev_config_t panel_dev_config = {
         .reset_gpio_num = OLED_PIN_RST,
         .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_BGR,
-        .bits_per_pixel = 16,
+        .bits_per_pixel = OLED_BITS_PER_PIXEL,
+        .vendor_config = &vendor_config,
     };
 
     ESP_ERROR_CHECK(esp_lcd_new_panel_pt6891(panel_io_handle, &panel_dev_config, &panel_handle));
+    ESP_ERROR_CHECK(pt6891_register_flush_done_cb(panel_handle, notify_flush_ready, &disp_drv));
 
     ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
     ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
@@ -166,13 +685,20 @@ void lvgl_init() {
     ESP_LOGI(TAG, "LVGL: Init");
     lv_init();
 
-    lv_color_t* buf1 = heap_caps_malloc(OLED_WIDTH * OLED_HEIGHT * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    lv_color_t* buf2 = heap_caps_malloc(OLED_WIDTH * OLED_HEIGHT * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    // Smaller than the screen: LVGL renders into one buffer while the other is on the wire.
+    // Full sized buffers would make LVGL wait for every flush before rendering the next area.
+    lv_color_t* buf1 = heap_caps_malloc(OLED_WIDTH * LVGL_STRIPE_ROWS * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    lv_color_t* buf2 = heap_caps_malloc(OLED_WIDTH * LVGL_STRIPE_ROWS * sizeof(lv_color_t), MALLOC_CAP_DMA);
 
     assert(buf1 != NULL);
     assert(buf2 != NULL);
 
-    lv_disp_draw_buf_init(&disp_draw_buf, buf1, buf2, OLED_WIDTH * OLED_HEIGHT);
+    lv_disp_draw_buf_init(&disp_draw_buf, buf1, buf2, OLED_WIDTH * LVGL_STRIPE_ROWS);
+
+    if (OLED_BITS_PER_PIXEL < 16) {
+        mono_buf = heap_caps_malloc(OLED_WIDTH * LVGL_STRIPE_ROWS, MALLOC_CAP_DEFAULT);
+        assert(mono_buf != NULL);
+    }
 
     lv_disp_drv_init(&disp_drv);
     disp_drv.hor_res = OLED_WIDTH;
@@ -180,32 +706,56 @@ void lvgl_init() {
     disp_drv.draw_buf = &disp_draw_buf;
     disp_drv.drv_update_cb = lvgl_port_update_callback;
     disp_drv.flush_cb = disp_flush;
+    disp_drv.wait_cb = lvgl_wait_flush;
+    disp_drv.flush_cost = LVGL_FLUSH_COST;
+    disp_drv.band_refresh = LVGL_BAND_REFRESH;
+    disp_drv.cull_occluded = LVGL_CULL_OCCLUDED;
+    if (LVGL_TELEMETRY) {
+        frame_telemetry_init(&telemetry);
+        disp_drv.refr_phase_cb = lvgl_refr_phase;
+    }
+    if (OLED_BITS_PER_PIXEL == 1) {
+        disp_drv.rounder_cb = disp_rounder;
+    }
     disp_drv.user_data = panel_handle;
     lv_disp_t* disp = lv_disp_drv_register(&disp_drv);
-    
-    const esp_timer_create_args_t lvgl_tick_timer_args = {
-        .callback = &increase_lvgl_tick,
-        .name = "lvgl_tick"
-    };
 
-    esp_timer_handle_t lvgl_tick_timer = NULL;
-    ESP_ERROR_CHECK(esp_timer_create(&lvgl_tick_timer_args, &lvgl_tick_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(lvgl_tick_timer, 2 * 1000));
+    if (OLED_PIN_INT > -1) {
+        lvgl_vsync_init(disp);
+    }
+
+    if (OLED_DELTA_FLUSH) {
+        lv_timer_create(delta_stats_timer_cb, LVGL_DELTA_STATS_MS, NULL);
+    }
+
+    lvgl_tick_us = esp_timer_get_time();
 
     lvgl_mux = xSemaphoreCreateRecursiveMutex();
     assert(lvgl_mux != NULL);
 
-    xTaskCreate(lvgl_port_task, "lvgl_port_task", 4096, NULL, 2, NULL);
+    last_flush_us = esp_timer_get_time();
+    if (LVGL_SPLIT_CORES) {
+        // Rendering never waits on SPI, and the LVGL lock is only held while rendering
+        flush_queue_init(&flush_queue);
+        xTaskCreatePinnedToCore(flush_task_main, "lvgl_flush_task", LVGL_TASK_STACK_SIZE, NULL, LVGL_FLUSH_TASK_PRIORITY, &flush_task, LVGL_FLUSH_CORE);
+        xTaskCreatePinnedToCore(lvgl_port_task, "lvgl_port_task", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, &lvgl_task, LVGL_RENDER_CORE);
+    } else {
+        xTaskCreate(lvgl_port_task, "lvgl_port_task", 4096, NULL, 2, &lvgl_task);
+    }
 
     if (lvgl_lock(-1)) {
         // lv_disp_set_perf_monitor(disp, true);
         lv_demo_benchmark();
+        service_display_fade(0, 0);
+        service_display_fade(255, LVGL_FADE_IN_MS);
         lvgl_unlock();
     }
 }
 
 void service_display_main() {
+    boot_start_us = esp_timer_get_time();
     panel_init();
+    ESP_LOGI(TAG, "Panel: Ready in %"PRId64" us", esp_timer_get_time() - boot_start_us);
     ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_handle, 0, 1));
     esp_lcd_panel_invert_color(panel_handle, true);
     lvgl_init();